@@ -33,6 +33,7 @@ struct condmap {
 };
 
 enum statusfields {
+    BL_BATCH = -4,           /* Several fields at once (WC2_BATCH_STATUS) */
     BL_CHARACTERISTICS = -3, /* alias for BL_STR..BL_CH */
     BL_RESET = -2,           /* Force everything to redisplay */
     BL_FLUSH = -1,           /* Finished cycling through bot fields */
@@ -261,6 +262,24 @@ struct istat_s {
 #endif
 };
 
+/* one field of a status_update(BL_BATCH, ...) delivery */
+struct status_batch {
+    int fld;          /* BL_TITLE..BL_CONDITION */
+    genericptr_t ptr; /* and the rest as for a single status_update() */
+    int chg, percent, color;
+};
+
+/* Some fields are derived from sources which are expensive to examine
+ * (the whole inventory for gold) or which need string formatting (title,
+ * dungeon level), so bot() only recomputes them when whatever changed
+ * the source has said so.  Fields which are just copies of an integer
+ * are still picked up by comparison with their previous value.
+ */
+#define BL_DIRTY_FIELDS \
+    ((1UL << BL_TITLE) | (1UL << BL_GOLD) | (1UL << BL_LEVELDESC))
+#define status_dirty(fld) \
+    (g.bl_dirty |= (1UL << (fld)), g.context.botl = TRUE)
+
 extern const char *status_fieldnames[]; /* in botl.c */
 
 #endif /* BOTL_H */
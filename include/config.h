@@ -115,6 +115,12 @@
 #define HACKDIR "\\nethack"
 #endif
 
+#ifdef NULL_GRAPHICS
+#ifdef LIBNH
+#define DEFAULT_WINDOW_SYS "null" /* programs driving the game */
+#endif
+#endif
+
 #ifndef DEFAULT_WINDOW_SYS
 #define DEFAULT_WINDOW_SYS "tty"
 #endif
@@ -261,7 +267,17 @@
  *
  */
 
-#if defined(UNIX) && !defined(ZLIB_COMP) && !defined(COMPRESS)
+/*
+ *      Defining LZCOMP builds in streaming compression of save, level,
+ *      and bones files as they are written (see sfstruct.c), so that no
+ *      external program has to be run.  COMPRESS is still used to
+ *      uncompress files saved without it, if it is defined too, but
+ *      no longer to compress them.
+ */
+#define LZCOMP /* built-in compression of save, level, and bones files */
+
+#if defined(UNIX) && !defined(ZLIB_COMP) && !defined(COMPRESS) \
+    && !defined(LZCOMP)
 /* path and file name extension for compression program */
 #define COMPRESS "/usr/bin/compress" /* Lempel-Ziv compression */
 #define COMPRESS_EXTENSION ".Z"      /* compress's extension */
@@ -513,6 +529,13 @@ typedef unsigned char uchar;
 /* #define DEBUG_MIGRATING_MONS */  /* add a wizard-mode command to help debug
                                        migrating monsters */
 
+/* #define PERF_STATS */            /* time the phases of moveloop() and
+                                       add wizard-mode #perfstats */
+
+/* #define RECORD_INPUT */          /* record new games' input to the file
+                                       named by NH_RECORD, for replaying by
+                                       nhreplay (see sys/libnh) */
+
 /* SCORE_ON_BOTL is neither experimental nor inadequately tested,
    but doesn't seem to fit in any other section... */
 /* #define SCORE_ON_BOTL */         /* enable the 'showscore' option to
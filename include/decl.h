@@ -123,6 +123,8 @@ struct sinfo {
 #define NHF_LEVELFILE       1
 #define NHF_SAVEFILE        2 
 #define NHF_BONESFILE       3
+/* start of a game snapshot (snapshot_game(), restore_snapshot()) */
+#define SNAPSHOT_MAGIC "NHsnap1"
 /* modes */
 #define READING  0x0
 #define COUNTING 0x1
@@ -188,6 +190,8 @@ struct multishot {
 };
 
 E NEARDATA boolean has_strong_rngseed;
+E NEARDATA unsigned long fixed_rngseed;
+E NEARDATA time_t fixed_gametime;
 E const int shield_static[];
 
 #include "spell.h"
@@ -364,9 +368,14 @@ E struct restore_info restoreinfo;
 
 E NEARDATA struct savefile_info sfcap, sfrestinfo, sfsaveinfo;
 
+/* allocation pools; these outlast g so aren't part of it */
+E struct nhpool obj_pool, oextra_pool, monst_pool, mextra_pool;
+E struct nhpool egd_pool, epri_pool, eshk_pool, emin_pool, edog_pool;
+E struct nhpool *const nhpools[];
+
 struct selectionvar {
     int wid, hei;
-    char *map;
+    unsigned long *map; /* for each x, a bit for each y (see sp_lev.c) */
 };
 
 struct autopickup_exception {
@@ -559,6 +568,7 @@ typedef struct ls_t {
     short flags;
     short type;  /* type of light source */
     anything id; /* source's identifier */
+    unsigned long *litmap; /* cached lit area, one bitmask per row */
 } light_source;
 
 struct container {
@@ -667,6 +677,7 @@ struct instance_globals {
 #endif
     unsigned long cond_hilites[BL_ATTCLR_MAX];
     int now_or_before_idx;   /* 0..1 for array[2][] first index */
+    unsigned long bl_dirty;  /* status_dirty() fields to recompute */
 
     /* cmd.c */
     struct cmd Cmd; /* flag.h */
@@ -744,6 +755,7 @@ struct instance_globals {
     boolean unweapon;
     boolean mrg_to_wielded; /* weapon picked is merged with wielded one */
     struct plinemsg_type *plinemsg_types;
+    rxset_t plinemsg_rx; /* plinemsg_types' patterns, in the same order */
     char toplines[TBUFSZ];
     struct mkroom *upstairs_room;
     struct mkroom *dnstairs_room;
@@ -752,6 +764,7 @@ struct instance_globals {
     boolean in_steed_dismounting;
     coord doors[DOORMAX];
     struct menucoloring *menu_colorings;
+    rxset_t menucolor_rx; /* menu_colorings' patterns */
     schar lastseentyp[COLNO][ROWNO]; /* last seen/touched dungeon typ */
     struct spell spl_book[MAXSPELL + 1];
     struct linfo level_info[MAXLINFO];
@@ -835,6 +848,7 @@ struct instance_globals {
     struct monst *mydogs; /* monsters that went down/up together with @ */
     struct monst *migrating_mons; /* monsters moving to another level */
     struct autopickup_exception *apelist;
+    rxset_t ape_rx; /* apelist's patterns */
     struct mvitals mvitals[NUMMONS];
 
     /* dokick.c */
@@ -893,6 +907,9 @@ struct instance_globals {
     /* hack.c */
     anything tmp_anything;
     int wc; /* current weight_cap(); valid after call to inv_weight() */
+    struct travel_cache *travelcache; /* saved findtravelpath() searches */
+    unsigned long travel_gen; /* bumped when terrain, doors, boulders or
+                                 traps change, to invalidate travelcache */
 
     /* invent.c */
     int lastinvnr;  /* 0 ... 51 (never saved&restored) */
@@ -941,7 +958,6 @@ struct instance_globals {
     boolean made_branch; /* used only during level creation */
 
     /* mkmap.c */
-    char *new_locations;
     int min_rx; /* rectangle bounds for regions */
     int max_rx;
     int min_ry;
@@ -958,11 +974,15 @@ struct instance_globals {
     int xmin, ymin, xmax, ymax; /* level boundaries */
     boolean ransacked;
 
+    /* mkobj.c */
+    idmap_t oid_map; /* o_id -> obj, for find_oid() */
+
     /* mon.c */
     boolean vamp_rise_msg;
     boolean disintegested;
     short *animal_list; /* list of PM values for animal monsters */
     int animal_list_count;
+    idmap_t mid_map; /* m_id -> monst, for find_mid() */
 
     /* mthrowu.c */
     int mesg_given; /* for m_throw()/thitu() 'miss' message */
@@ -987,6 +1007,9 @@ struct instance_globals {
     int lusername_size;
 #endif
 
+    /* nhlua.c */
+    struct lua_State *luacore; /* persistent state for level scripts */
+
     /* o_init.c */
     short disco[NUM_OBJECTS];
 
@@ -1069,10 +1092,12 @@ struct instance_globals {
     NhRegion **regions;
     int n_regions;
     int max_regions;
+    unsigned short region_cells[COLNO][ROWNO]; /* # of regions at each spot */
+    long region_clock;  /* run_regions() calls so far; regions age by it */
+    long region_expiry; /* earliest region expiry; 0 means look again */
 
     /* restore.c */
-    int n_ids_mapped;
-    struct bucket *id_map;
+    idmap_t id_map; /* bones file ids -> ids in current game */
     boolean restoring;
     struct fruit *oldfruit;
     long omoves;
@@ -1132,8 +1157,11 @@ struct instance_globals {
     struct obj *telescroll; /* non-null when teleporting via this scroll */
 
     /* timeout.c */
-    /* ordered timer list */
-    struct fe *timer_base; /* "active" */
+    /* timer queue, a binary heap ordered by timeout ("active") */
+    struct fe **timer_heap;
+    int timer_count, timer_heapmax;
+    struct fe **timer_hash; /* chains keyed on func_index and arg */
+    unsigned long timer_seq;
     unsigned long timer_id;
 
     /* topten.c */
@@ -15,6 +15,10 @@
 #define DLBLIB /* use a set of external files */
 #endif
 
+#if defined(DLBLIB) && defined(UNIX) && !defined(NO_DLB_MMAP)
+#define DLB_MMAP /* map library files into memory rather than use stdio */
+#endif
+
 #ifdef DLBLIB
 /* directory structure in memory */
 typedef struct dlb_directory {
@@ -33,6 +37,10 @@ typedef struct dlb_library {
     long nentries; /* # of files in directory */
     long rev;      /* dlb file revision */
     long strsize;  /* dlb file string size */
+    int *dhash;    /* name hash of dir[] entries; index + 1, 0 if unused */
+    long hashsize; /* # of slots in dhash[], a power of 2 */
+    char *mapped;  /* whole library file when memory mapped, else null */
+    long mapsize;  /* size of the mapping */
 } library;
 
 /* library definitions */
@@ -85,6 +93,7 @@ int FDECL(dlb_fseek, (DLB_P, long, int));
 char *FDECL(dlb_fgets, (char *, int, DLB_P));
 int FDECL(dlb_fgetc, (DLB_P));
 long FDECL(dlb_ftell, (DLB_P));
+const char *FDECL(dlb_fmap, (DLB_P, long *));
 
 /* Resource DLB entry points */
 #ifdef DLBRSRC
@@ -113,6 +122,7 @@ long rsrc_dlb_ftell(dlb *dp);
 #define dlb_fgets fgets
 #define dlb_fgetc fgetc
 #define dlb_ftell ftell
+#define dlb_fmap(dp, sizep) ((const char *) 0)
 
 #endif /* DLB */
 
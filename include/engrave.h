@@ -23,7 +23,10 @@ struct engr {
 };
 
 #define newengr(lth) \
-    (struct engr *) alloc((unsigned)(lth) + sizeof(struct engr))
-#define dealloc_engr(engr) free((genericptr_t)(engr))
+    (struct engr *) arena_alloc(&g.level.arena, \
+                                (unsigned) (lth) + sizeof (struct engr))
+#define dealloc_engr(e) \
+    arena_free(&g.level.arena, (genericptr_t) (e), \
+               (unsigned) (e)->engr_lth + sizeof (struct engr))
 
 #endif /* ENGRAVE_H */
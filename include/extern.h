@@ -28,6 +28,15 @@ E void FDECL(welcome, (BOOLEAN_P));
 E time_t NDECL(get_realtime);
 E int FDECL(argcheck, (int, char **, enum earlyarg));
 E void NDECL(early_init);
+#ifdef PERF_STATS
+E unsigned long NDECL(perf_clock);
+E int FDECL(perf_phase, (int));
+E unsigned long NDECL(perf_busy);
+E void NDECL(perf_action);
+E void FDECL(perf_mon, (int, BOOLEAN_P, unsigned long));
+E void FDECL(perf_report, (winid));
+E void NDECL(perf_dump);
+#endif
 
 /* ### apply.c ### */
 
@@ -755,6 +764,7 @@ E void NDECL(sanitize_engravings);
 E void FDECL(save_engravings, (NHFILE *));
 E void FDECL(rest_engravings, (NHFILE *));
 E void FDECL(engr_stats, (const char *, char *, long *, long *));
+E void NDECL(engr_sanity_check);
 E void FDECL(del_engr, (struct engr *));
 E void FDECL(rloc_engr, (struct engr *));
 E void FDECL(make_grave, (int, int, const char *));
@@ -799,6 +809,10 @@ E void FDECL(set_levelfile_name, (char *, int));
 E NHFILE *FDECL(create_levelfile, (int, char *));
 E NHFILE *FDECL(open_levelfile, (int, char *));
 E void FDECL(delete_levelfile, (int));
+E NHFILE *NDECL(create_memfile);
+E NHFILE *FDECL(open_memfile, (genericptr_t, long));
+E genericptr_t FDECL(memfile_detach, (NHFILE *, long *));
+E void NDECL(flush_levelcache);
 E void NDECL(clearlocks);
 E NHFILE *FDECL(create_bonesfile, (d_level *, char **, char *));
 #ifdef MFLOPPY
@@ -885,6 +899,7 @@ E boolean FDECL(bad_rock, (struct permonst *, XCHAR_P, XCHAR_P));
 E int FDECL(cant_squeeze_thru, (struct monst *));
 E boolean FDECL(invocation_pos, (XCHAR_P, XCHAR_P));
 E boolean FDECL(test_move, (int, int, int, int, int));
+E void NDECL(free_travelcache);
 #ifdef DEBUG
 E int NDECL(wiz_debug_cmd_traveldisplay);
 #endif
@@ -983,6 +998,10 @@ E void FDECL(strbuf_reserve, (strbuf_t *, int));
 E void FDECL(strbuf_empty, (strbuf_t *));
 E void FDECL(strbuf_nl_to_crlf, (strbuf_t *));
 E char *FDECL(nonconst, (const char *, char *));
+E void FDECL(idmap_set, (idmap_t *, unsigned, anything *));
+E anything *FDECL(idmap_get, (idmap_t *, unsigned));
+E void FDECL(idmap_remove, (idmap_t *, unsigned));
+E void FDECL(idmap_free, (idmap_t *));
 
 /* ### insight.c ### */
 
@@ -1101,6 +1120,7 @@ E int NDECL(dosuspend);
 
 E void FDECL(new_light_source, (XCHAR_P, XCHAR_P, int, int, ANY_P *));
 E void FDECL(del_light_source, (int, ANY_P *));
+E void FDECL(clear_light_cache, (int, int));
 E void FDECL(do_light_sources, (char **));
 E void FDECL(show_transient_light, (struct obj *, int, int));
 E void NDECL(transient_light_cleanup);
@@ -1403,6 +1423,8 @@ E int FDECL(add_to_minv, (struct monst *, struct obj *));
 E struct obj *FDECL(add_to_container, (struct obj *, struct obj *));
 E void FDECL(add_to_migration, (struct obj *));
 E void FDECL(add_to_buried, (struct obj *));
+E void FDECL(register_oid, (struct obj *));
+E void FDECL(unregister_oid, (struct obj *));
 E void FDECL(dealloc_obj, (struct obj *));
 E void FDECL(obj_ice_effects, (int, int, BOOLEAN_P));
 E long FDECL(peek_at_iced_corpse_age, (struct obj *));
@@ -1456,6 +1478,8 @@ E void FDECL(elemental_clog, (struct monst *));
 E int FDECL(mcalcmove, (struct monst *, BOOLEAN_P));
 E void NDECL(mcalcdistress);
 E void FDECL(replmon, (struct monst *, struct monst *));
+E void FDECL(register_mid, (struct monst *));
+E void FDECL(unregister_mid, (struct monst *));
 E void FDECL(relmon, (struct monst *, struct monst **));
 E struct obj *FDECL(mlifesaver, (struct monst *));
 E boolean FDECL(corpse_chance, (struct monst *, struct monst *, BOOLEAN_P));
@@ -1707,6 +1731,7 @@ E int FDECL(l_obj_register, (lua_State *));
 E lua_State * NDECL(nhl_init);
 E boolean FDECL(nhl_loadlua, (lua_State *, const char *));
 E boolean FDECL(load_lua, (const char *));
+E void NDECL(nhl_done);
 E void FDECL(nhl_error, (lua_State *, const char *)) NORETURN;
 E void FDECL(lcheck_param_table, (lua_State *));
 E schar FDECL(get_table_mapchr, (lua_State *, const char *));
@@ -2190,6 +2215,8 @@ E boolean FDECL(in_out_region, (XCHAR_P, XCHAR_P));
 E boolean FDECL(m_in_out_region, (struct monst *, XCHAR_P, XCHAR_P));
 E void NDECL(update_player_regions);
 E void FDECL(update_monster_region, (struct monst *));
+E void FDECL(forget_region_mon, (struct monst *));
+E void NDECL(region_sanity_check);
 E NhRegion *FDECL(visible_region_at, (XCHAR_P, XCHAR_P));
 E void FDECL(show_region, (NhRegion *, XCHAR_P, XCHAR_P));
 E void FDECL(save_regions, (NHFILE *));
@@ -2203,6 +2230,7 @@ E void NDECL(region_safety);
 
 E void FDECL(inven_inuse, (BOOLEAN_P));
 E int FDECL(dorecover, (NHFILE *));
+E boolean FDECL(restore_snapshot, (genericptr_t, long));
 E void FDECL(restcemetery, (NHFILE *, struct cemetery **));
 E void FDECL(trickery, (char *));
 E void FDECL(getlev, (NHFILE *, int, XCHAR_P));
@@ -2234,6 +2262,9 @@ E int FDECL(rnd, (int));
 E int FDECL(d, (int, int));
 E int FDECL(rne, (int));
 E int FDECL(rnz, (int));
+E void FDECL(save_rngstate, (NHFILE *));
+E void FDECL(restore_rngstate, (NHFILE *));
+E unsigned long NDECL(rng_position);
 
 /* ### role.c ### */
 
@@ -2281,6 +2312,14 @@ E void FDECL(restore_oracles, (NHFILE *));
 E int FDECL(doconsult, (struct monst *));
 E void NDECL(rumor_check);
 
+/* ### rxset.c ### */
+
+E void FDECL(rxset_add, (rxset_t *, const char *, struct nhregex *,
+                         genericptr_t));
+E genericptr_t FDECL(rxset_match, (rxset_t *, const char *));
+E genericptr_t FDECL(rxset_next, (rxset_t *));
+E void FDECL(rxset_free, (rxset_t *));
+
 /* ### save.c ### */
 
 E int NDECL(dosave);
@@ -2289,6 +2328,9 @@ E boolean FDECL(tricked_fileremoved, (NHFILE *, char *));
 #ifdef INSURANCE
 E void NDECL(savestateinlock);
 #endif
+E genericptr_t FDECL(snapshot_game, (long *));
+E void NDECL(discard_game);
+E unsigned long NDECL(state_hash);
 #ifdef MFLOPPY
 E boolean FDECL(savelev, (NHFILE *, XCHAR_P));
 E boolean FDECL(swapin_file, (int));
@@ -2340,6 +2382,11 @@ E void FDECL(Binit,(const char *, int));
 E void FDECL(Bclose, (int, const char *, int));
 E void FDECL(Mread, (int, genericptr_t, unsigned int, const char *, int));
 E void FDECL(Minit, (const char *, int));
+E boolean FDECL(is_membuf, (int));
+E int FDECL(membuf_open, (genericptr_t, long));
+E genericptr_t FDECL(membuf_detach, (int, long *));
+E void FDECL(membuf_rewind, (int));
+E long FDECL(membuf_length, (int));
 #if defined(ZEROCOMP)
 E void FDECL(zerocomp_bclose, (int));
 #endif
@@ -2447,6 +2494,7 @@ E int NDECL(dotalk);
 #ifdef USER_SOUNDS
 E int FDECL(add_sound_mapping, (const char *));
 E void FDECL(play_sound_for_message, (const char *));
+E void NDECL(release_sound_mappings);
 #endif
 
 /* ### sys.c ### */
@@ -2467,6 +2515,7 @@ E void FDECL(fill_room, (struct mkroom *, BOOLEAN_P));
 E boolean FDECL(load_special, (const char *));
 E xchar FDECL(selection_getpoint, (int, int, struct selectionvar *));
 E struct selectionvar *NDECL(selection_new);
+E struct selectionvar *FDECL(selection_clone, (struct selectionvar *));
 E void FDECL(selection_free, (struct selectionvar *));
 #if !defined(IN_SP_LEV_C)
 E void FDECL(set_selection_floodfillchk, (int FDECL((*), (int,int))));
@@ -2475,6 +2524,8 @@ E void FDECL(selection_floodfill, (struct selectionvar *, int, int, BOOLEAN_P));
 E void FDECL(get_location_coord, (schar *, schar *, int, struct mkroom *, long));
 E void FDECL(selection_setpoint, (int, int, struct selectionvar *, XCHAR_P));
 E struct selectionvar * FDECL(selection_not, (struct selectionvar *));
+E void FDECL(selection_combine, (struct selectionvar *, struct selectionvar *, CHAR_P));
+E int FDECL(selection_count, (struct selectionvar *));
 E void FDECL(selection_filter_percent, (struct selectionvar *, int));
 E int FDECL(selection_rndcoord, (struct selectionvar *, schar *, schar *, BOOLEAN_P));
 E void FDECL(selection_do_grow, (struct selectionvar *, int));
@@ -2674,6 +2725,7 @@ E boolean NDECL(lava_effects);
 E void NDECL(sink_into_lava);
 E void NDECL(sokoban_guilt);
 E const char * FDECL(trapname, (int, BOOLEAN_P));
+E void NDECL(trap_sanity_check);
 
 /* ### u_init.c ### */
 
@@ -2991,6 +3043,8 @@ E void FDECL(genl_status_enablefield, (int, const char *, const char *,
                                        BOOLEAN_P));
 E void FDECL(genl_status_update, (int, genericptr_t, int, int, int,
                                   unsigned long *));
+E void FDECL(genl_print_glyph_run, (winid, XCHAR_P, XCHAR_P, int,
+                                    const int *, const int *));
 #ifdef DUMPLOG
 E char *FDECL(dump_fmtstr, (const char *, char *, BOOLEAN_P));
 #endif
@@ -2998,6 +3052,11 @@ E void FDECL(dump_open_log, (time_t));
 E void NDECL(dump_close_log);
 E void FDECL(dump_redirect, (BOOLEAN_P));
 E void FDECL(dump_forward_putstr, (winid, int, const char*, int));
+#ifdef RECORD_INPUT
+E void NDECL(record_init);
+E void NDECL(record_begin);
+E void NDECL(record_finish);
+#endif
 
 /* ### winnt.c ### */
 #ifdef WIN32
@@ -313,6 +313,10 @@ extern struct cross_target_s cross_target;
 extern long *FDECL(nhalloc, (unsigned int, const char *, int));
 extern void FDECL(nhfree, (genericptr_t, const char *, int));
 extern char *FDECL(nhdupstr, (const char *, const char *, int));
+extern void FDECL(heapmon_report, (void FDECL((*), (const char *,
+                                                     genericptr_t)),
+                                   genericptr_t, int));
+extern void NDECL(heapmon_dump);
 #ifndef __FILE__
 #define __FILE__ ""
 #endif
@@ -327,6 +331,46 @@ extern long *FDECL(alloc, (unsigned int));  /* alloc.c */
 extern char *FDECL(dupstr, (const char *)); /* ditto */
 #endif
 
+/* pool of same-sized items, for structures which are allocated and
+   released over and over; see alloc.c */
+struct nhpool {
+    const char *name;
+    unsigned size;       /* size of an item as requested */
+    unsigned itemsize;   /* size as carved out; set on first use */
+    unsigned perchunk;   /* items per chunk; likewise */
+    genericptr_t freelist;
+    genericptr_t chunks;
+    long inuse, nchunks;
+};
+#define NHPOOL_INIT(nam, typ) \
+    { nam, (unsigned) sizeof (typ), 0, 0, (genericptr_t) 0, \
+      (genericptr_t) 0, 0L, 0L }
+#ifdef MONITOR_HEAP
+/* bypass the pools so that the heap log accounts for every item */
+#define pool_alloc(p) \
+    ((genericptr_t) nhalloc((p)->size, __FILE__, (int) __LINE__))
+#define pool_free(p, a) nhfree(a, __FILE__, (int) __LINE__)
+#define pool_release(p) ((void) 0)
+#else
+extern genericptr_t FDECL(pool_alloc, (struct nhpool *)); /* alloc.c */
+extern void FDECL(pool_free, (struct nhpool *, genericptr_t));
+extern void FDECL(pool_release, (struct nhpool *));
+#endif
+
+/* arena for things which are discarded all together; see alloc.c */
+#define ARENA_FREELISTS 64 /* sizes with a free list, in grains */
+struct nharena {
+    genericptr_t blocks;
+    char *next, *end; /* unused part of the newest block */
+    genericptr_t freelist[ARENA_FREELISTS];
+    genericptr_t stale; /* EXTRA_SANITY_CHECKS: blocks from last reset */
+};
+extern genericptr_t FDECL(arena_alloc, (struct nharena *, unsigned));
+extern void FDECL(arena_free, (struct nharena *, genericptr_t, unsigned));
+extern void FDECL(arena_reset, (struct nharena *));
+extern void FDECL(arena_release, (struct nharena *));
+extern boolean FDECL(arena_owns, (struct nharena *, genericptr_t));
+
 /* Used for consistency checks of various data files; declare it here so
    that utility programs which include config.h but not hack.h can see it. */
 struct version_info {
@@ -346,10 +390,12 @@ struct savefile_info {
 #define SFI1_EXTERNALCOMP (1UL)
 #define SFI1_RLECOMP (1UL << 1)
 #define SFI1_ZEROCOMP (1UL << 2)
+#define SFI1_LZCOMP (1UL << 3)
 #else
 #define SFI1_EXTERNALCOMP (1L)
 #define SFI1_RLECOMP (1L << 1)
 #define SFI1_ZEROCOMP (1L << 2)
+#define SFI1_LZCOMP (1L << 3)
 #endif
 
 /*
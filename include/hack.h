@@ -212,6 +212,32 @@ typedef struct {
 #define SYM_OFF_X (SYM_OFF_W + WARNCOUNT)
 #define SYM_MAX (SYM_OFF_X + MAXOTHER)
 
+/* hash table keyed by object or monster id, see idmap_*() in hacklib.c */
+struct idmap_entry {
+    unsigned id; /* 0 marks an empty slot */
+    anything val;
+};
+
+typedef struct idmap {
+    struct idmap_entry *tab;
+    int size;  /* number of slots; 0 or a power of 2 */
+    int count; /* number of slots in use */
+} idmap_t;
+
+/* regular expressions matched together, see rxset.c */
+struct rxset_auto;
+
+typedef struct rxset {
+    int count, size;          /* patterns added, room for them */
+    genericptr_t *items;      /* caller's data for each pattern */
+    struct nhregex **regexes; /* each pattern compiled on its own */
+    boolean *solo;            /* left to its regex by the automaton */
+    unsigned long *hits;      /* automaton's matches for subject */
+    const char *subject;      /* string most recently matched */
+    int at;                   /* pattern rxset_next() has reached */
+    struct rxset_auto *rxa;   /* automaton for the rest */
+} rxset_t;
+
 #include "rect.h"
 #include "region.h"
 #include "decl.h"
@@ -496,6 +522,29 @@ enum bodypart_types {
 #define TELEDS_ALLOW_DRAG 1
 #define TELEDS_TELEPORT   2
 
+/* where moveloop()'s time goes, for PERF_STATS; see allmain.c */
+enum perf_phases {
+    PERF_OTHER = 0,
+    PERF_MOVEMON,
+    PERF_MCALCDISTRESS,
+    PERF_TIMEOUT,
+    PERF_REGIONS,
+    PERF_SOUNDS,
+    PERF_VISION,
+    PERF_SEEMONS,
+    PERF_BOT,
+    PERF_FLUSH,
+    PERF_COMMAND,
+    PERF_OCCUPATION,
+    PERF_GOTO,
+    PERF_INPUT, /* waiting for a keystroke; not counted */
+    NUM_PERF_PHASES
+};
+#ifndef PERF_STATS
+#define perf_phase(p) ((void) (p), PERF_OTHER)
+#define perf_action() ((void) 0)
+#endif
+
 /*
  * Option flags
  * Each higher number includes the characteristics of the numbers
@@ -171,7 +171,7 @@ struct monst {
     struct mextra *mextra; /* point to mextra struct */
 };
 
-#define newmonst() (struct monst *) alloc(sizeof (struct monst))
+#define newmonst() (struct monst *) pool_alloc(&monst_pool)
 
 /* these are in mspeed */
 #define MSLOW 1 /* slowed monster */
@@ -123,7 +123,7 @@ struct obj {
     struct oextra *oextra; /* pointer to oextra struct */
 };
 
-#define newobj() (struct obj *) alloc(sizeof(struct obj))
+#define newobj() (struct obj *) pool_alloc(&obj_pool)
 
 /***
  **	oextra referencing and testing macros
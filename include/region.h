@@ -26,7 +26,7 @@ typedef boolean FDECL((*callback_proc), (genericptr_t, genericptr_t));
  *       or add any/remove any fields, you must update the
  *       bwrite() calls in save_regions(), and the
  *       mread() calls in rest_regions() in src/region.c
- *       to reflect the changes.
+ *       to reflect the changes.  (mptrs is rebuilt rather than saved.)
  */
 
 typedef struct {
@@ -39,6 +39,7 @@ typedef struct {
     const char *enter_msg;      /* Message when entering */
     const char *leave_msg;      /* Message when leaving */
     long ttl;                   /* Time to live. -1 is forever */
+    long expires;               /* g.region_clock value when ttl runs out */
     short expire_f;            /* Function to call when region's ttl expire */
     short can_enter_f;         /* Function to call to check whether the player
                                   can, or can not, enter the region */
@@ -50,6 +51,8 @@ typedef struct {
                                   inside */
     unsigned int player_flags; /* (see above) */
     unsigned int *monsters;    /* Monsters currently inside this region */
+    struct monst **mptrs;      /* Those monsters, once looked up (not saved;
+                                  dealloc_monst() clears stale entries) */
     short n_monst;             /* Number of monsters inside this region */
     short max_monst;           /* Maximum number of monsters that can be
                                   listed without having to grow the array */
@@ -603,11 +603,17 @@ typedef struct {
 #ifndef MICROPORT_BUG
     struct obj *objects[COLNO][ROWNO];
     struct monst *monsters[COLNO][ROWNO];
+    struct trap *traps[COLNO][ROWNO];      /* location index of g.ftrap */
+    struct engr *engravings[COLNO][ROWNO]; /* same for engraving list */
 #else
     struct obj *objects[1][ROWNO];
     char *yuk1[COLNO - 1][ROWNO];
     struct monst *monsters[1][ROWNO];
     char *yuk2[COLNO - 1][ROWNO];
+    struct trap *traps[1][ROWNO];
+    char *yuk3[COLNO - 1][ROWNO];
+    struct engr *engravings[1][ROWNO];
+    char *yuk4[COLNO - 1][ROWNO];
 #endif
     struct obj *objlist;
     struct obj *buriedobjlist;
@@ -615,6 +621,7 @@ typedef struct {
     struct damage *damagelist;
     struct cemetery *bonesinfo;
     struct levelflags flags;
+    struct nharena arena; /* traps and engravings; reset by savelev() */
 } dlevel_t;
 
 /*
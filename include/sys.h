@@ -28,6 +28,7 @@ struct sysopt {
     int check_save_uid; /* restoring savefile checks UID? */
     int check_plname; /* use plname for checking wizards/explorers/shellers */
     int bones_pools;
+    int levelcache; /* how many levels to keep in memory rather than on disk */
 
     /* record file */
     int persmax;
@@ -39,13 +39,15 @@ enum timeout_types {
 
 /* used in timeout.c */
 typedef struct fe {
-    struct fe *next;          /* next item in chain */
+    struct fe *next;          /* next item in hash chain */
     long timeout;             /* when we time out */
     unsigned long tid;        /* timer ID */
     short kind;               /* kind of use */
     short func_index;         /* what to call when we time out */
     anything arg;             /* pointer to timeout argument */
     Bitfield(needs_fixup, 1); /* does arg need to be patched? */
+    int heapidx;              /* position in g.timer_heap[] */
+    unsigned long seq;        /* when queued; orders equal timeouts */
 } timer_element;
 
 #endif /* TIMEOUT_H */
@@ -37,8 +37,10 @@ struct trap {
 #define tnote vl.v_tnote
 };
 
-#define newtrap() (struct trap *) alloc(sizeof(struct trap))
-#define dealloc_trap(trap) free((genericptr_t)(trap))
+#define newtrap() \
+    (struct trap *) arena_alloc(&g.level.arena, sizeof (struct trap))
+#define dealloc_trap(trap) \
+    arena_free(&g.level.arena, (genericptr_t) (trap), sizeof (struct trap))
 
 /* reasons for statue animation */
 #define ANIMATE_NORMAL 0
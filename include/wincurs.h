@@ -91,6 +91,9 @@ extern void curses_wait_synch(void);
 extern void curses_cliparound(int x, int y);
 extern void curses_print_glyph(winid wid, XCHAR_P x, XCHAR_P y,
                                int glyph, int bkglyph);
+extern void curses_print_glyph_run(winid wid, XCHAR_P x, XCHAR_P y,
+                                   int count, const int *glyphs,
+                                   const int *bkglyphs);
 extern void curses_raw_print(const char *str);
 extern void curses_raw_print_bold(const char *str);
 extern int curses_nhgetch(void);
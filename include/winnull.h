@@ -0,0 +1,26 @@
+/* NetHack 3.7	winnull.h	$NHDT-Date$  $NHDT-Branch$:$NHDT-Revision$ */
+/* Copyright (c) NetHack Development Team 2020.                   */
+/* NetHack may be freely redistributed.  See license for details. */
+
+#ifndef WINNULL_H
+#define WINNULL_H
+
+#define E extern
+
+E struct window_procs null_procs;
+
+/* called when a keystroke is needed and none are queued; the driver
+   should queue some and return nonzero, or return 0 to hang up */
+E int NDECL((*null_input_wait));
+
+/* ### winnull.c ### */
+
+E void FDECL(null_pushkeys, (const char *, int));
+E int NDECL(null_pendingkeys);
+E long NDECL(null_msgcount);
+E const char *FDECL(null_getmsg, (long));
+E const char *NDECL(null_prompt);
+
+#undef E
+
+#endif /* WINNULL_H */
@@ -80,6 +80,9 @@ struct window_procs {
                (int, const char *, const char *, BOOLEAN_P));
     void FDECL((*win_status_update), (int, genericptr_t, int, int, int, unsigned long *));
     boolean NDECL((*win_can_suspend));
+    /* optional; only called when wincap2 has WC2_GLYPH_RUN */
+    void FDECL((*win_print_glyph_run), (winid, XCHAR_P, XCHAR_P, int,
+                                        const int *, const int *));
 };
 
 extern
@@ -123,6 +126,7 @@ extern
 #define update_positionbar (*windowprocs.win_update_positionbar)
 #endif
 #define print_glyph (*windowprocs.win_print_glyph)
+#define print_glyph_run (*windowprocs.win_print_glyph_run)
 #define raw_print (*windowprocs.win_raw_print)
 #define raw_print_bold (*windowprocs.win_raw_print_bold)
 #define nhgetch (*windowprocs.win_nhgetch)
@@ -228,7 +232,11 @@ extern
                                    *    via non-display attribute flag  */
 #define WC2_SUPPRESS_HIST 0x8000L /* 15 putstr(WIN_MESSAGE) supports history
                                    *    suppression via non-disp attr   */
-                                  /* 16 free bits */
+#define WC2_BATCH_STATUS 0x10000L /* 17 status_update(BL_BATCH) takes all
+                                   *    of a bot() round's changes at once */
+#define WC2_GLYPH_RUN    0x20000L /* 18 print_glyph_run() takes a span of
+                                   *    a map row in one call           */
+                                  /* 14 free bits */
 
 #define ALIGN_LEFT   1
 #define ALIGN_RIGHT  2
@@ -380,6 +388,8 @@ struct chain_procs {
                (CARGS, int, const char *, const char *, BOOLEAN_P));
     void FDECL((*win_status_update), (CARGS, int, genericptr_t, int, int, int, unsigned long *));
     boolean FDECL((*win_can_suspend), (CARGS));
+    void FDECL((*win_print_glyph_run), (CARGS, winid, XCHAR_P, XCHAR_P, int,
+                                        const int *, const int *));
 };
 #endif /* WINCHAIN */
 
@@ -450,6 +460,8 @@ extern void FDECL(safe_status_enablefield,
                     (int, const char *, const char *, BOOLEAN_P));
 extern void FDECL(safe_status_update, (int, genericptr_t, int, int, int, unsigned long *));
 extern boolean NDECL(safe_can_suspend);
+extern void FDECL(safe_print_glyph_run, (winid, XCHAR_P, XCHAR_P, int,
+                                         const int *, const int *));
 extern void FDECL(stdio_raw_print, (const char *));
 extern void FDECL(stdio_nonl_raw_print, (const char *));
 extern void FDECL(stdio_raw_print_bold, (const char *));
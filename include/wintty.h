@@ -123,6 +123,9 @@ E void FDECL(xputg, (int, int, unsigned));
 E void NDECL(cl_end);
 E void NDECL(clear_screen);
 E void NDECL(home);
+#ifndef NO_TERMS
+E int NDECL(cmov_len);
+#endif
 E void NDECL(standoutbeg);
 E void NDECL(standoutend);
 #if 0
@@ -171,6 +174,13 @@ E void NDECL(setclipped);
 E void FDECL(docorner, (int, int));
 E void NDECL(end_glyphout);
 E void FDECL(g_putch, (int));
+#ifndef NO_TERMS
+E void FDECL(tty_screen_erase, (int, int, BOOLEAN_P));
+E void FDECL(tty_screen_forget, (int, int));
+E boolean FDECL(tty_screen_advance, (int));
+#else
+#define tty_screen_forget(first, last) /*empty*/
+#endif
 E void FDECL(win_tty_init, (int));
 
 /* external declarations */
@@ -206,6 +216,8 @@ E void FDECL(tty_cliparound, (int, int));
 E void FDECL(tty_update_positionbar, (char *));
 #endif
 E void FDECL(tty_print_glyph, (winid, XCHAR_P, XCHAR_P, int, int));
+E void FDECL(tty_print_glyph_run, (winid, XCHAR_P, XCHAR_P, int,
+                                   const int *, const int *));
 E void FDECL(tty_raw_print, (const char *));
 E void FDECL(tty_raw_print_bold, (const char *));
 E int NDECL(tty_nhgetch);
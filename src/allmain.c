@@ -18,6 +18,26 @@ static void NDECL(do_positionbar);
 static void FDECL(regen_hp, (int));
 static void FDECL(interrupt_multi, (const char *));
 static void FDECL(debug_fields, (const char *));
+#ifdef PERF_STATS
+struct perf_phasestat;
+static int FDECL(perf_bucket, (unsigned long));
+static void FDECL(perf_record, (struct perf_phasestat *, unsigned long));
+static long NDECL(perf_inwindows);
+static void FDECL(perf_levname, (int, char *));
+static int FDECL(perf_moncmp, (const genericptr, const genericptr));
+static void NDECL(perf_wrapprocs);
+static int NDECL(perf_nhgetch);
+static int FDECL(perf_nh_poskey, (int *, int *, int *));
+static char FDECL(perf_yn_function, (const char *, const char *, CHAR_P));
+static void FDECL(perf_getlin, (const char *, char *));
+static int NDECL(perf_get_ext_cmd);
+static int FDECL(perf_select_menu, (winid, int, MENU_ITEM_P **));
+static char FDECL(perf_message_menu, (CHAR_P, int, const char *));
+static void FDECL(perf_display_nhwindow, (winid, BOOLEAN_P));
+static void FDECL(perf_display_file, (const char *, BOOLEAN_P));
+static void FDECL(perf_putstr, (winid, int, const char *));
+static int NDECL(perf_doprev_message);
+#endif
 
 void
 early_init()
@@ -29,6 +49,9 @@ early_init()
     runtime_info_init();
 #endif
     sys_early_init();
+#ifdef RECORD_INPUT
+    record_init();
+#endif
 }
 
 void
@@ -90,6 +113,7 @@ boolean resuming;
 
     g.program_state.in_moveloop = 1;
     for (;;) {
+        perf_action(); /* the previous pass is complete */
 #ifdef SAFERHANGUP
         if (g.program_state.done_hup)
             end_of_input();
@@ -107,11 +131,13 @@ boolean resuming;
                 wtcap = encumber_msg();
 
                 g.context.mon_moving = TRUE;
+                (void) perf_phase(PERF_MOVEMON);
                 do {
                     monscanmove = movemon();
                     if (g.youmonst.movement >= NORMAL_SPEED)
                         break; /* it's now your turn */
                 } while (monscanmove);
+                (void) perf_phase(PERF_OTHER);
                 g.context.mon_moving = FALSE;
 
                 if (!monscanmove && g.youmonst.movement < NORMAL_SPEED) {
@@ -119,7 +145,9 @@ boolean resuming;
                     struct monst *mtmp;
 
                     /* set up for a new turn */
+                    (void) perf_phase(PERF_MCALCDISTRESS);
                     mcalcdistress(); /* adjust monsters' trap, blind, etc */
+                    (void) perf_phase(PERF_OTHER);
 
                     /* reallocate movement rations to monsters; don't need
                        to skip dead monsters here because they will have
@@ -187,8 +215,11 @@ boolean resuming;
 
                     if (Glib)
                         glibr();
+                    (void) perf_phase(PERF_TIMEOUT);
                     nh_timeout();
+                    (void) perf_phase(PERF_REGIONS);
                     run_regions();
+                    (void) perf_phase(PERF_OTHER);
 
                     if (u.ublesscnt)
                         u.ublesscnt--;
@@ -285,7 +316,9 @@ boolean resuming;
                     if (Warning)
                         warnreveal();
                     mkot_trap_warn();
+                    (void) perf_phase(PERF_SOUNDS);
                     dosounds();
+                    (void) perf_phase(PERF_OTHER);
                     do_storms();
                     gethungry();
                     age_spells();
@@ -323,8 +356,11 @@ boolean resuming;
                         if (++g.multi == 0) { /* finished yet? */
                             unmul((char *) 0);
                             /* if unmul caused a level change, take it now */
-                            if (u.utotype)
+                            if (u.utotype) {
+                                (void) perf_phase(PERF_GOTO);
                                 deferred_goto();
+                                (void) perf_phase(PERF_OTHER);
+                            }
                         }
                     }
                 }
@@ -371,6 +407,7 @@ boolean resuming;
         find_ac();
         if (!g.context.mv || Blind) {
             /* redo monsters if hallu or wearing a helm of telepathy */
+            (void) perf_phase(PERF_SEEMONS);
             if (Hallucination) { /* update screen randomly */
                 see_monsters();
                 see_objects();
@@ -382,8 +419,10 @@ boolean resuming;
             } else if (Warning || Warn_of_mon)
                 see_monsters();
 
+            (void) perf_phase(PERF_VISION);
             if (g.vision_full_recalc)
                 vision_recalc(0); /* vision! */
+            (void) perf_phase(PERF_OTHER);
         }
         if (g.context.botl || g.context.botlx) {
             bot();
@@ -404,11 +443,14 @@ boolean resuming;
                 else
                     pushch(ch);
             }
+            (void) perf_phase(PERF_OCCUPATION);
             if (!abort_lev && (*g.occupation)() == 0)
 #else
+            (void) perf_phase(PERF_OCCUPATION);
             if ((*g.occupation)() == 0)
 #endif
                 g.occupation = 0;
+            (void) perf_phase(PERF_OTHER);
             if (
 #if defined(MICRO) || defined(WIN32)
                 abort_lev ||
@@ -434,6 +476,7 @@ boolean resuming;
 
         u.umoved = FALSE;
 
+        (void) perf_phase(PERF_COMMAND);
         if (g.multi > 0) {
             lookaround();
             if (!g.multi) {
@@ -441,6 +484,7 @@ boolean resuming;
                 g.context.move = 0;
                 if (flags.time)
                     g.context.botl = TRUE;
+                (void) perf_phase(PERF_OTHER);
                 continue;
             }
             if (g.context.mv) {
@@ -458,14 +502,18 @@ boolean resuming;
 #endif
             rhack((char *) 0);
         }
-        if (u.utotype)       /* change dungeon level */
+        if (u.utotype) {     /* change dungeon level */
+            (void) perf_phase(PERF_GOTO);
             deferred_goto(); /* after rhack() */
-        /* !g.context.move here: multiple movement command stopped */
-        else if (flags.time && (!g.context.move || !g.context.mv))
+        } else if (flags.time && (!g.context.move || !g.context.mv)) {
+            /* !g.context.move here: multiple movement command stopped */
             g.context.botl = TRUE;
+        }
 
+        (void) perf_phase(PERF_VISION);
         if (g.vision_full_recalc)
             vision_recalc(0); /* vision! */
+        (void) perf_phase(PERF_OTHER);
         /* when running in non-tport mode, this gets done through domove() */
         if ((!g.context.run || flags.runmode == RUN_TPORT)
             && (g.multi && (!g.context.travel ? !(g.multi % 7)
@@ -607,6 +655,15 @@ newgame()
 #ifdef MFLOPPY
     gameDiskPrompt();
 #endif
+    /* with a fixed seed, the game doesn't depend on how many random
+       numbers choosing the hero's role &c happened to use */
+    if (fixed_rngseed) {
+        init_random(rn2);
+        init_random(rn2_on_display_rng);
+    }
+#ifdef RECORD_INPUT
+    record_begin();
+#endif
 
     g.context.botlx = TRUE;
     g.context.ident = 1;
@@ -949,4 +1006,560 @@ const char *opts;
 #endif
     return;
 }
+
+#ifdef PERF_STATS
+/*
+ * Timing of moveloop()'s phases.  Each pass through the loop (one hero
+ * action, plus whatever the monsters and the turn do around it) is
+ * split among enum perf_phases:  perf_phase() charges the time since
+ * the last switch to the phase being left.  Anything called during a
+ * phase is charged to it unless it switches itself, as bot() and
+ * flush_screen() do.  The window port's routines which can wait for the
+ * player (including those that can put up --More--, such as putstr()
+ * to the message window) are wrapped to run as PERF_INPUT, which is
+ * kept out of the pass totals and out of the per-monster times; so
+ * drawing messages counts as input too.  perf_action() closes each pass.
+ *
+ * For each phase there are totals, the worst pass, and histograms of
+ * time per pass over the last PERF_WINDOW to 2*PERF_WINDOW passes.
+ * Each level gets totals and its worst pass, and each monster type the
+ * number of dochug() and m_move() calls and the time they took.
+ */
+#define PERF_BUCKETS 8 /* microseconds: <=16, <=64, <=256, ..., >64K */
+#define PERF_WINDOW 1000L
+
+struct perf_phasestat {
+    unsigned long cur; /* microseconds in the pass under way */
+    long passes;       /* passes which spent any time here */
+    double total;      /* microseconds */
+    unsigned long worst;
+    long hist[2][PERF_BUCKETS]; /* window being filled and the one before */
+};
+
+static struct perf_stats {
+    int phase;          /* phase being timed */
+    unsigned long mark; /* perf_clock() when it was entered */
+    boolean started;
+    unsigned long waited; /* total time spent in PERF_INPUT */
+    long passes, inwindow;
+    int window; /* which hist[] is being filled */
+    struct perf_phasestat phases[NUM_PERF_PHASES + 1]; /* +1: whole pass */
+    struct perf_levstat {
+        long passes;
+        double total;
+        unsigned long worst;
+    } levs[MAXLINFO];
+    struct perf_monstat {
+        long calls[2]; /* dochug(), m_move() */
+        double total[2];
+    } mons[NUMMONS];
+} perf;
+
+static const char *const perf_names[NUM_PERF_PHASES + 1] = {
+    "other", "movemon", "mcalcdistress", "nh_timeout", "run_regions",
+    "dosounds", "vision_recalc", "see_monsters", "bot", "flush_screen",
+    "rhack", "occupation", "goto_level", "input", "whole pass",
+};
+
+static const char *const perf_buckets[PERF_BUCKETS] = {
+    "<=16", "<=64", "<=256", "<=1K", "<=4K", "<=16K", "<=64K", ">64K",
+};
+
+static struct window_procs perf_real; /* what perf_wrapprocs() wrapped */
+
+/* monotonic clock, in microseconds; only differences are meaningful */
+unsigned long
+perf_clock()
+{
+#if defined(UNIX) && defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long) ts.tv_sec * 1000000UL
+           + (unsigned long) (ts.tv_nsec / 1000L);
+#else
+    return (unsigned long) ((double) clock() * (1000000.0 / CLOCKS_PER_SEC));
+#endif
+}
+
+/* start charging time to 'phase'; returns the phase which was running */
+int
+perf_phase(phase)
+int phase;
+{
+    unsigned long now = perf_clock();
+    int prev = perf.phase;
+
+    perf.phases[prev].cur += now - perf.mark;
+    if (prev == PERF_INPUT)
+        perf.waited += now - perf.mark;
+    perf.mark = now;
+    perf.phase = phase;
+    return prev;
+}
+
+/* perf_clock() less the time spent waiting for input, for timing calls
+   which might ask the player something */
+unsigned long
+perf_busy()
+{
+    /* while waiting, the clock stopped when the wait began */
+    if (perf.phase == PERF_INPUT)
+        return perf.mark - perf.waited;
+    return perf_clock() - perf.waited;
+}
+
+static int
+perf_bucket(usecs)
+unsigned long usecs;
+{
+    int b;
+
+    for (b = 0; b < PERF_BUCKETS - 1 && usecs > (16UL << (2 * b)); ++b)
+        continue;
+    return b;
+}
+
+static void
+perf_record(st, usecs)
+struct perf_phasestat *st;
+unsigned long usecs;
+{
+    st->passes++;
+    st->total += (double) usecs;
+    if (usecs > st->worst)
+        st->worst = usecs;
+    st->hist[perf.window][perf_bucket(usecs)]++;
+}
+
+/* called at the top of moveloop(); the previous pass is finished */
+void
+perf_action()
+{
+    unsigned long pass = 0UL;
+    int i, j, lev;
+
+    (void) perf_phase(PERF_OTHER);
+    if (!perf.started) {
+        /* whatever came before the first pass isn't part of one */
+        for (i = 0; i < NUM_PERF_PHASES; ++i)
+            perf.phases[i].cur = 0UL;
+        perf.started = TRUE;
+        perf_wrapprocs();
+        return;
+    }
+    for (i = 0; i < NUM_PERF_PHASES; ++i) {
+        if (!perf.phases[i].cur)
+            continue;
+        perf_record(&perf.phases[i], perf.phases[i].cur);
+        if (i != PERF_INPUT)
+            pass += perf.phases[i].cur;
+        perf.phases[i].cur = 0UL;
+    }
+    perf_record(&perf.phases[NUM_PERF_PHASES], pass);
+    perf.passes++;
+
+    lev = (int) ledger_no(&u.uz);
+    if (lev > 0 && lev < MAXLINFO) {
+        perf.levs[lev].passes++;
+        perf.levs[lev].total += (double) pass;
+        if (pass > perf.levs[lev].worst)
+            perf.levs[lev].worst = pass;
+    }
+
+    if (++perf.inwindow >= PERF_WINDOW) {
+        perf.window = !perf.window;
+        perf.inwindow = 0L;
+        for (i = 0; i <= NUM_PERF_PHASES; ++i)
+            for (j = 0; j < PERF_BUCKETS; ++j)
+                perf.phases[i].hist[perf.window][j] = 0L;
+    }
+}
+
+/* charge a dochug() or m_move() call which began at perf_busy() 'start'
+   to 'mndx' */
+void
+perf_mon(mndx, moving, start)
+int mndx;
+boolean moving;
+unsigned long start;
+{
+    int which = moving ? 1 : 0;
+
+    if (mndx >= LOW_PM && mndx < NUMMONS) {
+        perf.mons[mndx].calls[which]++;
+        perf.mons[mndx].total[which] += (double) (perf_busy() - start);
+    }
+}
+
+/* put the window port's routines which can block behind ones that switch
+   to PERF_INPUT around them */
+static void
+perf_wrapprocs()
+{
+    perf_real = windowprocs;
+    windowprocs.win_nhgetch = perf_nhgetch;
+    windowprocs.win_nh_poskey = perf_nh_poskey;
+    windowprocs.win_yn_function = perf_yn_function;
+    windowprocs.win_getlin = perf_getlin;
+    windowprocs.win_get_ext_cmd = perf_get_ext_cmd;
+    windowprocs.win_select_menu = perf_select_menu;
+    windowprocs.win_message_menu = perf_message_menu;
+    windowprocs.win_display_nhwindow = perf_display_nhwindow;
+    windowprocs.win_display_file = perf_display_file;
+    windowprocs.win_putstr = perf_putstr;
+    windowprocs.win_doprev_message = perf_doprev_message;
+}
+
+static int
+perf_nhgetch()
+{
+    int prev = perf_phase(PERF_INPUT), c;
+
+    c = (*perf_real.win_nhgetch)();
+    (void) perf_phase(prev);
+    return c;
+}
+
+static int
+perf_nh_poskey(x, y, mod)
+int *x, *y, *mod;
+{
+    int prev = perf_phase(PERF_INPUT), c;
+
+    c = (*perf_real.win_nh_poskey)(x, y, mod);
+    (void) perf_phase(prev);
+    return c;
+}
+
+static char
+perf_yn_function(query, resp, def)
+const char *query, *resp;
+char def;
+{
+    int prev = perf_phase(PERF_INPUT);
+    char q;
+
+    q = (*perf_real.win_yn_function)(query, resp, def);
+    (void) perf_phase(prev);
+    return q;
+}
+
+static void
+perf_getlin(query, bufp)
+const char *query;
+char *bufp;
+{
+    int prev = perf_phase(PERF_INPUT);
+
+    (*perf_real.win_getlin)(query, bufp);
+    (void) perf_phase(prev);
+}
+
+static int
+perf_get_ext_cmd()
+{
+    int prev = perf_phase(PERF_INPUT), idx;
+
+    idx = (*perf_real.win_get_ext_cmd)();
+    (void) perf_phase(prev);
+    return idx;
+}
+
+static int
+perf_select_menu(win, how, menu_list)
+winid win;
+int how;
+menu_item **menu_list;
+{
+    int prev = perf_phase(PERF_INPUT), n;
+
+    n = (*perf_real.win_select_menu)(win, how, menu_list);
+    (void) perf_phase(prev);
+    return n;
+}
+
+static char
+perf_message_menu(let, how, mesg)
+char let;
+int how;
+const char *mesg;
+{
+    int prev = perf_phase(PERF_INPUT);
+    char c;
+
+    c = (*perf_real.win_message_menu)(let, how, mesg);
+    (void) perf_phase(prev);
+    return c;
+}
+
+static void
+perf_display_nhwindow(win, blocking)
+winid win;
+boolean blocking;
+{
+    int prev;
+
+    /* redrawing the map or status doesn't wait unless asked to */
+    if (!blocking && (win == WIN_MAP || win == WIN_STATUS)) {
+        (*perf_real.win_display_nhwindow)(win, blocking);
+        return;
+    }
+    prev = perf_phase(PERF_INPUT);
+    (*perf_real.win_display_nhwindow)(win, blocking);
+    (void) perf_phase(prev);
+}
+
+static void
+perf_display_file(fname, complain)
+const char *fname;
+boolean complain;
+{
+    int prev = perf_phase(PERF_INPUT);
+
+    (*perf_real.win_display_file)(fname, complain);
+    (void) perf_phase(prev);
+}
+
+/* a message can put up --More-- for the one before it */
+static void
+perf_putstr(win, attr, str)
+winid win;
+int attr;
+const char *str;
+{
+    int prev;
+
+    if (win != WIN_MESSAGE) {
+        (*perf_real.win_putstr)(win, attr, str);
+        return;
+    }
+    prev = perf_phase(PERF_INPUT);
+    (*perf_real.win_putstr)(win, attr, str);
+    (void) perf_phase(prev);
+}
+
+static int
+perf_doprev_message()
+{
+    int prev = perf_phase(PERF_INPUT), res;
+
+    res = (*perf_real.win_doprev_message)();
+    (void) perf_phase(prev);
+    return res;
+}
+
+/* number of passes covered by the histograms */
+static long
+perf_inwindows()
+{
+    return min(perf.passes, PERF_WINDOW + perf.inwindow);
+}
+
+static void
+perf_levname(lev, buf)
+int lev;
+char *buf;
+{
+    Sprintf(buf, "%s:%d", g.dungeons[ledger_to_dnum((xchar) lev)].dname,
+            (int) ledger_to_dlev((xchar) lev));
+}
+
+/* qsort() comparison: monster types with most time in dochug() first */
+static int
+perf_moncmp(p1, p2)
+const genericptr p1;
+const genericptr p2;
+{
+    const struct perf_monstat *m1 = &perf.mons[*(const short *) p1],
+                              *m2 = &perf.mons[*(const short *) p2];
+
+    if (m1->total[0] != m2->total[0])
+        return (m1->total[0] < m2->total[0]) ? 1 : -1;
+    return (int) (*(const short *) p1 - *(const short *) p2);
+}
+
+/* #perfstats */
+void
+perf_report(win)
+winid win;
+{
+    char buf[BUFSZ], lbuf[BUFSZ];
+    struct perf_phasestat *st;
+    short order[NUMMONS];
+    int i, j, n;
+
+    Sprintf(buf, "%ld passes through moveloop, %.1f ms not counting input",
+            perf.passes, perf.phases[NUM_PERF_PHASES].total / 1000.0);
+    putstr(win, 0, buf);
+    putstr(win, 0, "");
+    Sprintf(buf, "%-14s %8s %11s %9s %9s", "phase", "passes", "total ms",
+            "avg us", "worst us");
+    putstr(win, 0, buf);
+    for (i = 0; i <= NUM_PERF_PHASES; ++i) {
+        st = &perf.phases[i];
+        if (!st->passes)
+            continue;
+        Sprintf(buf, "%-14s %8ld %11.1f %9.0f %9lu", perf_names[i],
+                st->passes, st->total / 1000.0, st->total / st->passes,
+                st->worst);
+        putstr(win, 0, buf);
+    }
+
+    putstr(win, 0, "");
+    Sprintf(buf, "Microseconds per pass, last %ld passes:", perf_inwindows());
+    putstr(win, 0, buf);
+    Sprintf(buf, "%-14s", "phase");
+    for (j = 0; j < PERF_BUCKETS; ++j)
+        Sprintf(eos(buf), " %6s", perf_buckets[j]);
+    putstr(win, 0, buf);
+    for (i = 0; i <= NUM_PERF_PHASES; ++i) {
+        st = &perf.phases[i];
+        if (!st->passes)
+            continue;
+        Sprintf(buf, "%-14s", perf_names[i]);
+        for (j = 0; j < PERF_BUCKETS; ++j)
+            Sprintf(eos(buf), " %6ld", st->hist[0][j] + st->hist[1][j]);
+        putstr(win, 0, buf);
+    }
+
+    for (i = n = 0; i < NUMMONS; ++i)
+        if (perf.mons[i].calls[0])
+            order[n++] = (short) i;
+    if (n) {
+        qsort((genericptr_t) order, (size_t) n, sizeof order[0], perf_moncmp);
+        putstr(win, 0, "");
+        putstr(win, 0, "Monster types by time in dochug():");
+        Sprintf(buf, "%-24s %8s %9s %8s %9s", "monster", "dochug", "ms",
+                "m_move", "ms");
+        putstr(win, 0, buf);
+        for (i = 0; i < n && i < 20; ++i) {
+            struct perf_monstat *ms = &perf.mons[order[i]];
+
+            Sprintf(buf, "%-24.24s %8ld %9.1f %8ld %9.1f",
+                    mons[order[i]].mname, ms->calls[0], ms->total[0] / 1000.0,
+                    ms->calls[1], ms->total[1] / 1000.0);
+            putstr(win, 0, buf);
+        }
+    }
+
+    putstr(win, 0, "");
+    putstr(win, 0, "Levels:");
+    Sprintf(buf, "%-24s %8s %11s %9s", "level", "passes", "total ms",
+            "worst us");
+    putstr(win, 0, buf);
+    for (i = 1; i < MAXLINFO; ++i) {
+        if (!perf.levs[i].passes)
+            continue;
+        perf_levname(i, lbuf);
+        Sprintf(buf, "%-24.24s %8ld %11.1f %9lu", lbuf, perf.levs[i].passes,
+                perf.levs[i].total / 1000.0, perf.levs[i].worst);
+        putstr(win, 0, buf);
+    }
+}
+
+/*
+ * If ${NH_PERFSTATS} is defined, write the statistics to a file by that
+ * name when the game ends:  JSON if the name ends in ".json", otherwise
+ * CSV with one row per phase, level, and monster type's dochug() and
+ * m_move() calls.  Times are in microseconds.
+ */
+void
+perf_dump()
+{
+    const char *fname = getenv("NH_PERFSTATS");
+    static const char nohist[] = ",,,,,,,,"; /* PERF_BUCKETS commas */
+    const char *sep;
+    char lbuf[BUFSZ];
+    struct perf_phasestat *st;
+    FILE *fp;
+    boolean json;
+    int i, j;
+    size_t len;
+
+    if (!fname || !*fname || !perf.passes)
+        return;
+    len = strlen(fname);
+    json = (len > 5 && !strcmpi(fname + len - 5, ".json"));
+    if ((fp = fopen(fname, "w")) == 0)
+        return;
+
+    if (json) {
+        (void) fprintf(fp, "{\"passes\": %ld, \"recent_passes\": %ld,\n",
+                       perf.passes, perf_inwindows());
+        (void) fprintf(fp, " \"buckets\": [");
+        for (j = 0; j < PERF_BUCKETS; ++j)
+            (void) fprintf(fp, "%s\"%s\"", j ? ", " : "", perf_buckets[j]);
+        (void) fprintf(fp, "],\n \"phases\": [");
+        for (i = 0, sep = "\n"; i <= NUM_PERF_PHASES; ++i) {
+            st = &perf.phases[i];
+            (void) fprintf(fp, "%s  {\"name\": \"%s\", \"passes\": %ld, "
+                               "\"total_us\": %.0f, \"worst_us\": %lu, "
+                               "\"recent\": [",
+                           sep, perf_names[i], st->passes, st->total,
+                           st->worst);
+            for (j = 0; j < PERF_BUCKETS; ++j)
+                (void) fprintf(fp, "%s%ld", j ? ", " : "",
+                               st->hist[0][j] + st->hist[1][j]);
+            (void) fprintf(fp, "]}");
+            sep = ",\n";
+        }
+        (void) fprintf(fp, "],\n \"levels\": [");
+        for (i = 1, sep = "\n"; i < MAXLINFO; ++i) {
+            if (!perf.levs[i].passes)
+                continue;
+            perf_levname(i, lbuf);
+            (void) fprintf(fp, "%s  {\"name\": \"%s\", \"passes\": %ld, "
+                               "\"total_us\": %.0f, \"worst_us\": %lu}",
+                           sep, lbuf, perf.levs[i].passes,
+                           perf.levs[i].total, perf.levs[i].worst);
+            sep = ",\n";
+        }
+        (void) fprintf(fp, "],\n \"monsters\": [");
+        for (i = LOW_PM, sep = "\n"; i < NUMMONS; ++i) {
+            if (!perf.mons[i].calls[0])
+                continue;
+            (void) fprintf(fp, "%s  {\"name\": \"%s\", \"dochug\": %ld, "
+                               "\"dochug_us\": %.0f, \"m_move\": %ld, "
+                               "\"m_move_us\": %.0f}",
+                           sep, mons[i].mname, perf.mons[i].calls[0],
+                           perf.mons[i].total[0], perf.mons[i].calls[1],
+                           perf.mons[i].total[1]);
+            sep = ",\n";
+        }
+        (void) fprintf(fp, "]}\n");
+    } else {
+        (void) fprintf(fp, "kind,name,count,total_us,worst_us");
+        for (j = 0; j < PERF_BUCKETS; ++j)
+            (void) fprintf(fp, ",%s", perf_buckets[j]);
+        (void) fprintf(fp, "\n");
+        for (i = 0; i <= NUM_PERF_PHASES; ++i) {
+            st = &perf.phases[i];
+            (void) fprintf(fp, "phase,%s,%ld,%.0f,%lu", perf_names[i],
+                           st->passes, st->total, st->worst);
+            for (j = 0; j < PERF_BUCKETS; ++j)
+                (void) fprintf(fp, ",%ld", st->hist[0][j] + st->hist[1][j]);
+            (void) fprintf(fp, "\n");
+        }
+        for (i = 1; i < MAXLINFO; ++i) {
+            if (!perf.levs[i].passes)
+                continue;
+            perf_levname(i, lbuf);
+            (void) fprintf(fp, "level,%s,%ld,%.0f,%lu%s\n", lbuf,
+                           perf.levs[i].passes, perf.levs[i].total,
+                           perf.levs[i].worst, nohist);
+        }
+        for (i = LOW_PM; i < NUMMONS; ++i) {
+            for (j = 0; j < 2; ++j)
+                if (perf.mons[i].calls[j])
+                    (void) fprintf(fp, "%s,%s,%ld,%.0f,%s\n",
+                                   j ? "m_move" : "dochug", mons[i].mname,
+                                   perf.mons[i].calls[j],
+                                   perf.mons[i].total[j], nohist);
+        }
+    }
+    (void) fclose(fp);
+}
+#endif /* PERF_STATS */
+
 /*allmain.c*/
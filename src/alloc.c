@@ -17,6 +17,12 @@ char *FDECL(fmt_ptr, (const genericptr));
 #undef free
 extern void FDECL(free, (genericptr_t));
 static void NDECL(heapmon_init);
+static struct heapsite *FDECL(heapsite_find, (const char *, int));
+static void FDECL(heapblk_add, (genericptr_t, unsigned, const char *, int));
+static void FDECL(heapblk_remove, (genericptr_t));
+static void NDECL(heapblk_grow);
+static int FDECL(heapsite_cmp, (const genericptr, const genericptr));
+static void FDECL(heapmon_fputs, (const char *, genericptr_t));
 
 static FILE *heaplog = 0;
 static boolean tried_heaplog = FALSE;
@@ -119,6 +125,7 @@ int line;
     /* potential panic in alloc() was deferred til here */
     if (!ptr)
         panic("Cannot get %u bytes, line %d of %s", lth, line, file);
+    heapblk_add((genericptr_t) ptr, lth, file, line);
 
     return ptr;
 }
@@ -134,6 +141,7 @@ int line;
     if (heaplog)
         (void) fprintf(heaplog, "-      %s %4d %s\n",
                        fmt_ptr((genericptr_t) ptr), line, file);
+    heapblk_remove(ptr);
 
     free(ptr);
 }
@@ -150,8 +158,543 @@ int line;
 }
 #undef dupstr
 
+/*
+ * Per-call-site statistics.  Every block handed out by nhalloc() is
+ * remembered, along with its size and the site which asked for it, so
+ * that nhfree() can charge the release back to that site; then the
+ * sites still holding the most memory can be listed without having to
+ * run heaputil over a heaplog.  nhfree() of something which nhalloc()
+ * didn't supply (via realloc() or from libc) is merely counted.
+ *
+ * The bookkeeping itself comes straight from malloc() and is never
+ * given back.
+ */
+#define HEAPSITE_HASH 512  /* buckets for call sites; a power of 2 */
+#define HEAPBLK_HASH 4096  /* initial buckets for live blocks; likewise */
+#define HEAPBLK_BATCH 256  /* block records obtained at a time */
+#define HEAPSIZE_CLASSES 12 /* histogram: up to 16 bytes, 32, ..., more */
+
+struct heapsite {
+    struct heapsite *next;
+    const char *file;
+    int line;
+    long nalloc, nfree;   /* calls */
+    long curbytes, curblks; /* still allocated */
+    long peakbytes;       /* high water mark of curbytes */
+    long totbytes;        /* all-time */
+    long sizes[HEAPSIZE_CLASSES];
+};
+
+struct heapblk {
+    struct heapblk *next;
+    genericptr_t ptr;
+    unsigned size;
+    struct heapsite *site;
+};
+
+static struct heapsite *heapsites[HEAPSITE_HASH];
+static long nheapsites = 0L;
+static struct heapblk **heapblks = 0, *heapblk_spare = 0;
+static unsigned long heapblk_mask = 0UL, nheapblks = 0UL;
+static long heap_curbytes = 0L, heap_peakbytes = 0L, heap_untracked = 0L;
+
+#define heapblk_hash(p) \
+    ((unsigned long) (((size_t) (p) >> 4) * 2654435761UL) & heapblk_mask)
+
+static struct heapsite *
+heapsite_find(file, line)
+const char *file;
+int line;
+{
+    struct heapsite *site;
+    unsigned h = (unsigned) line & (HEAPSITE_HASH - 1);
+
+    for (site = heapsites[h]; site; site = site->next)
+        if (site->line == line
+            && (site->file == file || !strcmp(site->file, file)))
+            return site;
+    site = (struct heapsite *) malloc(sizeof *site);
+    if (!site)
+        panic("heapsite_find: out of memory");
+    (void) memset((genericptr_t) site, 0, sizeof *site);
+    site->file = file;
+    site->line = line;
+    site->next = heapsites[h];
+    heapsites[h] = site;
+    ++nheapsites;
+    return site;
+}
+
+/* double the number of buckets for live blocks */
+static void
+heapblk_grow()
+{
+    struct heapblk **old = heapblks, *blk, *nxt;
+    unsigned long i, oldcnt = heapblk_mask + 1;
+
+    heapblk_mask = old ? 2 * oldcnt - 1 : HEAPBLK_HASH - 1;
+    heapblks = (struct heapblk **) calloc(heapblk_mask + 1, sizeof *heapblks);
+    if (!heapblks)
+        panic("heapblk_grow: out of memory");
+    if (old) {
+        for (i = 0; i < oldcnt; ++i)
+            for (blk = old[i]; blk; blk = nxt) {
+                nxt = blk->next;
+                blk->next = heapblks[heapblk_hash(blk->ptr)];
+                heapblks[heapblk_hash(blk->ptr)] = blk;
+            }
+        free((genericptr_t) old);
+    }
+}
+
+static void
+heapblk_add(ptr, lth, file, line)
+genericptr_t ptr;
+unsigned lth;
+const char *file;
+int line;
+{
+    struct heapsite *site = heapsite_find(file, line);
+    struct heapblk *blk;
+    unsigned long h;
+    int i;
+
+    if (!heapblks || nheapblks > 2 * (heapblk_mask + 1))
+        heapblk_grow();
+    if (!heapblk_spare) {
+        blk = (struct heapblk *) malloc(HEAPBLK_BATCH * sizeof *blk);
+        if (!blk)
+            panic("heapblk_add: out of memory");
+        for (i = 0; i < HEAPBLK_BATCH; ++i) {
+            blk[i].next = heapblk_spare;
+            heapblk_spare = &blk[i];
+        }
+    }
+    blk = heapblk_spare;
+    heapblk_spare = blk->next;
+    blk->ptr = ptr;
+    blk->size = lth;
+    blk->site = site;
+    h = heapblk_hash(ptr);
+    blk->next = heapblks[h];
+    heapblks[h] = blk;
+    ++nheapblks;
+
+    site->nalloc++;
+    site->curblks++;
+    site->curbytes += (long) lth;
+    site->totbytes += (long) lth;
+    if (site->curbytes > site->peakbytes)
+        site->peakbytes = site->curbytes;
+    for (i = 0; i < HEAPSIZE_CLASSES - 1 && lth > (16U << i); ++i)
+        continue;
+    site->sizes[i]++;
+    heap_curbytes += (long) lth;
+    if (heap_curbytes > heap_peakbytes)
+        heap_peakbytes = heap_curbytes;
+}
+
+static void
+heapblk_remove(ptr)
+genericptr_t ptr;
+{
+    struct heapblk *blk, **prev;
+
+    if (heapblks)
+        for (prev = &heapblks[heapblk_hash(ptr)]; (blk = *prev) != 0;
+             prev = &blk->next)
+            if (blk->ptr == ptr) {
+                *prev = blk->next;
+                --nheapblks;
+                blk->site->nfree++;
+                blk->site->curblks--;
+                blk->site->curbytes -= (long) blk->size;
+                heap_curbytes -= (long) blk->size;
+                blk->next = heapblk_spare;
+                heapblk_spare = blk;
+                return;
+            }
+    if (ptr)
+        ++heap_untracked;
+}
+
+/* qsort() comparison: most memory still held first, then most churn */
+static int
+heapsite_cmp(p1, p2)
+const genericptr p1;
+const genericptr p2;
+{
+    const struct heapsite *s1 = *(const struct heapsite *const *) p1,
+                          *s2 = *(const struct heapsite *const *) p2;
+
+    if (s1->curbytes != s2->curbytes)
+        return (s1->curbytes < s2->curbytes) ? 1 : -1;
+    if (s1->totbytes != s2->totbytes)
+        return (s1->totbytes < s2->totbytes) ? 1 : -1;
+    return (s1->line - s2->line);
+}
+
+/* pass the statistics, one line at a time, to 'out'; list at most
+   'maxsites' call sites (all of them if 0) */
+void
+heapmon_report(out, arg, maxsites)
+void FDECL((*out), (const char *, genericptr_t));
+genericptr_t arg;
+int maxsites;
+{
+    char buf[BUFSZ], where[18 + 1 + 11 + 1], *p;
+    const char *fnam;
+    struct heapsite **sites, *site;
+    long i, n = 0L;
+    int j;
+
+    Sprintf(buf, "%ld bytes in %lu blocks, peak %ld; %ld frees untracked",
+            heap_curbytes, nheapblks, heap_peakbytes, heap_untracked);
+    (*out)(buf, arg);
+    if (!nheapsites)
+        return;
+    sites = (struct heapsite **) malloc(nheapsites * sizeof *sites);
+    if (!sites)
+        return;
+    for (j = 0; j < HEAPSITE_HASH; ++j)
+        for (site = heapsites[j]; site; site = site->next)
+            sites[n++] = site;
+    qsort((genericptr_t) sites, (size_t) n, sizeof *sites, heapsite_cmp);
+    if (maxsites > 0 && n > (long) maxsites)
+        n = (long) maxsites;
+
+    (*out)("", arg);
+    Sprintf(buf, "%-24s %9s %7s %9s %9s %7s %7s", "call site", "live",
+            "blocks", "peak", "total", "allocs", "frees");
+    (*out)(buf, arg);
+    for (i = 0; i < n; ++i) {
+        site = sites[i];
+        /* keep the end of a long pathname, where the file's name is */
+        fnam = site->file;
+        if (strlen(fnam) > 18)
+            fnam += strlen(fnam) - 18;
+        Sprintf(where, "%.18s:%d", fnam, site->line);
+        Sprintf(buf, "%-24s %9ld %7ld %9ld %9ld %7ld %7ld", where,
+                site->curbytes, site->curblks, site->peakbytes,
+                site->totbytes, site->nalloc, site->nfree);
+        (*out)(buf, arg);
+        /* sizes requested, by power of 2: "<=16:3 <=64:12 >16384:1" */
+        p = buf;
+        for (j = 0; j < HEAPSIZE_CLASSES; ++j) {
+            if (!site->sizes[j])
+                continue;
+            if (p - buf > BUFSZ - 40)
+                break;
+            Sprintf(p, "%s%s%u:%ld", (p == buf) ? "    sizes " : " ",
+                    (j < HEAPSIZE_CLASSES - 1) ? "<=" : ">",
+                    16U << ((j < HEAPSIZE_CLASSES - 1) ? j : j - 1),
+                    site->sizes[j]);
+            p += strlen(p);
+        }
+        if (p != buf)
+            (*out)(buf, arg);
+    }
+    free((genericptr_t) sites);
+}
+
+static void
+heapmon_fputs(line, arg)
+const char *line;
+genericptr_t arg;
+{
+    (void) fprintf((FILE *) arg, "%s\n", line);
+}
+
+/* If ${NH_HEAPSTATS} is defined, write the complete statistics to a file
+   by that name; called when the game is over.  Unlike the heaplog, this
+   is replaced each time. */
+void
+heapmon_dump()
+{
+    char *fname = getenv("NH_HEAPSTATS");
+    FILE *fp;
+
+    if (fname && *fname && (fp = fopen(fname, "w")) != 0) {
+        heapmon_report(heapmon_fputs, (genericptr_t) fp, 0);
+        (void) fclose(fp);
+    }
+}
+
 #endif /* MONITOR_HEAP */
 
+#ifndef MONITOR_HEAP
+/*
+ * Pools of same-sized items.  Items are carved out of chunks of about
+ * POOL_CHUNKSIZE bytes and handed out in address order, so that things
+ * made together sit together; released ones go on a free list to be
+ * reused before the pool grows again.  Chunks are only given back by
+ * pool_release(), when everything in the pool is being thrown away.
+ * (With MONITOR_HEAP, global.h maps these onto nhalloc() and nhfree().)
+ */
+#define POOL_CHUNKSIZE 8192
+
+/* chunk header; also sets the alignment of items and free list links */
+union pool_chunk {
+    union pool_chunk *next;
+    genericptr_t p;
+    long l;
+    double d;
+};
+
+static void FDECL(pool_grow, (struct nhpool *));
+
+static void
+pool_grow(pool)
+struct nhpool *pool;
+{
+    union pool_chunk *chunk;
+    char *item;
+    unsigned n;
+
+    if (!pool->itemsize) {
+        n = (unsigned) sizeof (union pool_chunk);
+        pool->itemsize = ((pool->size + n - 1) / n) * n;
+        pool->perchunk = POOL_CHUNKSIZE / pool->itemsize;
+        if (pool->perchunk < 4)
+            pool->perchunk = 4;
+    }
+    chunk = (union pool_chunk *) alloc((unsigned) sizeof *chunk
+                                       + pool->perchunk * pool->itemsize);
+    chunk->next = (union pool_chunk *) pool->chunks;
+    pool->chunks = (genericptr_t) chunk;
+    pool->nchunks++;
+    /* thread the free list backwards so that it starts with the first */
+    item = (char *) (chunk + 1) + pool->perchunk * pool->itemsize;
+    for (n = pool->perchunk; n > 0; --n) {
+        item -= pool->itemsize;
+        *(genericptr_t *) item = pool->freelist;
+        pool->freelist = (genericptr_t) item;
+    }
+}
+
+genericptr_t
+pool_alloc(pool)
+struct nhpool *pool;
+{
+    genericptr_t item;
+
+    if (!pool->freelist)
+        pool_grow(pool);
+    item = pool->freelist;
+    pool->freelist = *(genericptr_t *) item;
+    pool->inuse++;
+    return item;
+}
+
+void
+pool_free(pool, item)
+struct nhpool *pool;
+genericptr_t item;
+{
+    *(genericptr_t *) item = pool->freelist;
+    pool->freelist = item;
+    pool->inuse--;
+}
+
+/* give back all of a pool's memory at once; anything still allocated
+   from it is gone too */
+void
+pool_release(pool)
+struct nhpool *pool;
+{
+    union pool_chunk *chunk;
+
+    while ((chunk = (union pool_chunk *) pool->chunks) != 0) {
+        pool->chunks = (genericptr_t) chunk->next;
+        free((genericptr_t) chunk);
+    }
+    pool->freelist = (genericptr_t) 0;
+    pool->inuse = pool->nchunks = 0L;
+}
+#endif /* !MONITOR_HEAP */
+
+/*
+ * Arenas, for things which are discarded all together (the current
+ * level's traps and engravings, in g.level.arena).  Space is handed out
+ * linearly from blocks; something released early goes on a free list
+ * for its size if it's small enough to have one, otherwise it waits for
+ * arena_reset(), which gives back every block at once.
+ *
+ * With EXTRA_SANITY_CHECKS, arena_reset() fills the blocks with
+ * ARENA_POISON and holds on to them until the next reset instead, so
+ * anything still pointing into them finds garbage rather than something
+ * else which has reused the space, and arena_owns() won't accept them.
+ */
+#define ARENA_BLOCKSIZE 16384
+#define ARENA_POISON 0xdb
+
+union arena_hdr;
+struct arena_block {
+    union arena_hdr *next;
+    unsigned size; /* bytes usable after the header */
+};
+/* block header, padded so that what follows is suitably aligned */
+union arena_hdr {
+    struct arena_block b;
+    genericptr_t p;
+    long l;
+    double d;
+};
+union arena_grain {
+    genericptr_t p;
+    long l;
+    double d;
+};
+#define ARENA_GRAIN ((unsigned) sizeof (union arena_grain))
+#define arena_grains(size) (((size) + ARENA_GRAIN - 1) / ARENA_GRAIN)
+
+static union arena_hdr *FDECL(arena_newblock, (unsigned));
+static void FDECL(arena_drop, (union arena_hdr *));
+
+static union arena_hdr *
+arena_newblock(size)
+unsigned size;
+{
+    union arena_hdr *blk;
+
+#ifdef MONITOR_HEAP
+    /* all arenas' blocks are charged to this call site */
+    blk = (union arena_hdr *) nhalloc((unsigned) sizeof *blk + size,
+                                      __FILE__, (int) __LINE__);
+#else
+    blk = (union arena_hdr *) alloc((unsigned) sizeof *blk + size);
+#endif
+    blk->b.next = (union arena_hdr *) 0;
+    blk->b.size = size;
+    return blk;
+}
+
+static void
+arena_drop(blk)
+union arena_hdr *blk;
+{
+    union arena_hdr *nxt;
+
+    for (; blk; blk = nxt) {
+        nxt = blk->b.next;
+#ifdef MONITOR_HEAP
+        nhfree((genericptr_t) blk, __FILE__, (int) __LINE__);
+#else
+        free((genericptr_t) blk);
+#endif
+    }
+}
+
+genericptr_t
+arena_alloc(arena, size)
+struct nharena *arena;
+unsigned size;
+{
+    union arena_hdr *blk;
+    genericptr_t item;
+    unsigned n = arena_grains(size);
+
+    if (!n)
+        n = 1;
+    if (n <= ARENA_FREELISTS && (item = arena->freelist[n - 1]) != 0) {
+        arena->freelist[n - 1] = *(genericptr_t *) item;
+        return item;
+    }
+    n *= ARENA_GRAIN;
+    if (!arena->next || (unsigned) (arena->end - arena->next) < n) {
+        if (n > ARENA_BLOCKSIZE / 4) {
+            /* gets a block of its own, put behind the current one so
+               that the latter's remaining space isn't abandoned */
+            blk = arena_newblock(n);
+            if (arena->blocks) {
+                blk->b.next = ((union arena_hdr *) arena->blocks)->b.next;
+                ((union arena_hdr *) arena->blocks)->b.next = blk;
+            } else {
+                arena->blocks = (genericptr_t) blk;
+            }
+            return (genericptr_t) (blk + 1);
+        }
+        blk = arena_newblock(ARENA_BLOCKSIZE);
+        blk->b.next = (union arena_hdr *) arena->blocks;
+        arena->blocks = (genericptr_t) blk;
+        arena->next = (char *) (blk + 1);
+        arena->end = arena->next + ARENA_BLOCKSIZE;
+    }
+    item = (genericptr_t) arena->next;
+    arena->next += n;
+    return item;
+}
+
+/* release something before the rest of the arena goes */
+void
+arena_free(arena, item, size)
+struct nharena *arena;
+genericptr_t item;
+unsigned size;
+{
+    unsigned n = arena_grains(size);
+
+    if (!n)
+        n = 1;
+#ifdef EXTRA_SANITY_CHECKS
+    (void) memset(item, ARENA_POISON, n * ARENA_GRAIN);
+#endif
+    if ((char *) item + n * ARENA_GRAIN == arena->next) {
+        arena->next = (char *) item; /* the most recent allocation */
+    } else if (n <= ARENA_FREELISTS) {
+        *(genericptr_t *) item = arena->freelist[n - 1];
+        arena->freelist[n - 1] = item;
+    }
+    /* else it's reclaimed by arena_reset() */
+}
+
+/* discard everything in the arena */
+void
+arena_reset(arena)
+struct nharena *arena;
+{
+    int i;
+#ifdef EXTRA_SANITY_CHECKS
+    union arena_hdr *blk;
+
+    arena_drop((union arena_hdr *) arena->stale);
+    for (blk = (union arena_hdr *) arena->blocks; blk; blk = blk->b.next)
+        (void) memset((genericptr_t) (blk + 1), ARENA_POISON, blk->b.size);
+    arena->stale = arena->blocks;
+#else
+    arena_drop((union arena_hdr *) arena->blocks);
+#endif
+    arena->blocks = (genericptr_t) 0;
+    arena->next = arena->end = (char *) 0;
+    for (i = 0; i < ARENA_FREELISTS; ++i)
+        arena->freelist[i] = (genericptr_t) 0;
+}
+
+/* discard everything and give back all memory, stale blocks included */
+void
+arena_release(arena)
+struct nharena *arena;
+{
+    arena_reset(arena);
+    arena_drop((union arena_hdr *) arena->stale);
+    arena->stale = (genericptr_t) 0;
+}
+
+/* is 'ptr' something handed out by the arena since its last reset? */
+boolean
+arena_owns(arena, ptr)
+struct nharena *arena;
+genericptr_t ptr;
+{
+    union arena_hdr *blk;
+    char *p = (char *) ptr;
+
+    for (blk = (union arena_hdr *) arena->blocks; blk; blk = blk->b.next)
+        if (p >= (char *) (blk + 1) && p < (char *) (blk + 1) + blk->b.size)
+            return TRUE;
+    return FALSE;
+}
+
 /* strdup() which uses our alloc() rather than libc's malloc();
    not used when MONITOR_HEAP is enabled, but included unconditionally
    in case utility programs get built using a different setting for that */
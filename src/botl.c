@@ -231,6 +231,8 @@ do_statusline2()
 void
 bot()
 {
+    int prevphase = perf_phase(PERF_BOT);
+
     /* dosave() flags completion by setting u.uhp to -1 */
     if ((u.uhp != -1) && g.youmonst.data && iflags.status_updates) {
         if (VIA_WINDOWPORT()) {
@@ -243,11 +245,14 @@ bot()
         }
     }
     g.context.botl = g.context.botlx = iflags.time_botl = FALSE;
+    (void) perf_phase(prevphase);
 }
 
 void
 timebot()
 {
+    int prevphase = perf_phase(PERF_BOT);
+
     if (flags.time && iflags.status_updates) {
         if (VIA_WINDOWPORT()) {
             stat_update_time();
@@ -257,6 +262,7 @@ timebot()
         }
     }
     iflags.time_botl = FALSE;
+    (void) perf_phase(prevphase);
 }
 
 /* convert experience level (1..30) to rank index (0..8) */
@@ -416,6 +422,11 @@ char *buf;
 
 static boolean FDECL(eval_notify_windowport_field, (int, boolean *, int));
 static void FDECL(evaluate_and_notify_windowport, (boolean *, int));
+static void FDECL(bl_keep, (int, int));
+static void NDECL(status_batch_begin);
+static void FDECL(status_deliver, (int, genericptr_t, int, int, int,
+                                   unsigned long *));
+static boolean FDECL(status_batch_end, (BOOLEAN_P, BOOLEAN_P));
 static void NDECL(init_blstats);
 static int FDECL(compare_blstats, (struct istat_s *, struct istat_s *));
 static char *FDECL(anything_to_s, (char *, anything *, int));
@@ -655,6 +666,10 @@ do {                                                        \
     }                                                       \
 } while (0)
 
+/* fields held for a single status_update(BL_BATCH) */
+static struct status_batch bl_batch[MAXBLSTATS];
+static int bl_batched = -1; /* -1: window port gets them one at a time */
+
 /* we don't put this next declaration in #ifdef STATUS_HILITES.
  * In the absence of STATUS_HILITES, each array
  * element will be 0 however, and quite meaningless,
@@ -671,6 +686,11 @@ bot_via_windowport()
     register char *nb;
     int i, idx, cap;
     long money;
+    unsigned long dirty;
+#ifdef EXTRA_SANITY_CHECKS
+    unsigned long clean;
+    int stale = -1;
+#endif
 
     if (!g.blinit)
         panic("bot before init.");
@@ -679,6 +699,17 @@ bot_via_windowport()
     idx = 1 - g.now_or_before_idx; /* 0 -> 1, 1 -> 0 */
     g.now_or_before_idx = idx;
 
+    /* the BL_DIRTY_FIELDS which nothing has marked with status_dirty()
+       are copied from the previous iteration instead of recomputed */
+    dirty = (g.update_all || g.context.botlx) ? ~0UL : g.bl_dirty;
+    g.bl_dirty = 0UL;
+#ifdef EXTRA_SANITY_CHECKS
+    /* recompute everything, then complain about any of those which
+       changed without having been marked */
+    clean = ~dirty & BL_DIRTY_FIELDS;
+    dirty = ~0UL;
+#endif
+
     /* clear the "value set" indicators */
     (void) memset((genericptr_t) g.valset, 0, MAXBLSTATS * sizeof (boolean));
 
@@ -691,25 +722,30 @@ bot_via_windowport()
     /*
      *  Player name and title.
      */
-    Strcpy(nb = buf, g.plname);
-    nb[0] = highc(nb[0]);
-    titl = !Upolyd ? rank() : mons[u.umonnum].mname;
-    i = (int) (strlen(buf) + sizeof " the " + strlen(titl) - sizeof "");
-    /* if "Name the Rank/monster" is too long, we truncate the name
-       but always keep at least 10 characters of it; when hitpintbar is
-       enabled, anything beyond 30 (long monster name) will be truncated */
-    if (i > 30) {
-        i = 30 - (int) (sizeof " the " + strlen(titl) - sizeof "");
-        nb[max(i, 10)] = '\0';
-    }
-    Strcpy(nb = eos(nb), " the ");
-    Strcpy(nb = eos(nb), titl);
-    if (Upolyd) { /* when poly'd, capitalize monster name */
-        for (i = 0; nb[i]; i++)
-            if (i == 0 || nb[i - 1] == ' ')
-                nb[i] = highc(nb[i]);
-    }
-    Sprintf(g.blstats[idx][BL_TITLE].val, "%-30s", buf);
+    if (dirty & (1UL << BL_TITLE)) {
+        Strcpy(nb = buf, g.plname);
+        nb[0] = highc(nb[0]);
+        titl = !Upolyd ? rank() : mons[u.umonnum].mname;
+        i = (int) (strlen(buf) + sizeof " the " + strlen(titl) - sizeof "");
+        /* if "Name the Rank/monster" is too long, we truncate the name
+           but always keep at least 10 characters of it; when hitpintbar is
+           enabled, anything beyond 30 (long monster name) will be
+           truncated */
+        if (i > 30) {
+            i = 30 - (int) (sizeof " the " + strlen(titl) - sizeof "");
+            nb[max(i, 10)] = '\0';
+        }
+        Strcpy(nb = eos(nb), " the ");
+        Strcpy(nb = eos(nb), titl);
+        if (Upolyd) { /* when poly'd, capitalize monster name */
+            for (i = 0; nb[i]; i++)
+                if (i == 0 || nb[i - 1] == ' ')
+                    nb[i] = highc(nb[i]);
+        }
+        Sprintf(g.blstats[idx][BL_TITLE].val, "%-30s", buf);
+    } else {
+        bl_keep(BL_TITLE, idx);
+    }
     g.valset[BL_TITLE] = TRUE; /* indicate val already set */
 
     /* Strength */
@@ -747,13 +783,20 @@ bot_via_windowport()
     g.blstats[idx][BL_HPMAX].a.a_int = min(i, 9999);
 
     /*  Dungeon level. */
-    (void) describe_level(g.blstats[idx][BL_LEVELDESC].val);
+    if (dirty & (1UL << BL_LEVELDESC))
+        (void) describe_level(g.blstats[idx][BL_LEVELDESC].val);
+    else
+        bl_keep(BL_LEVELDESC, idx);
     g.valset[BL_LEVELDESC] = TRUE; /* indicate val already set */
 
     /* Gold */
-    if ((money = money_cnt(g.invent)) < 0L)
-        money = 0L; /* ought to issue impossible() and then discard gold */
-    g.blstats[idx][BL_GOLD].a.a_long = min(money, 999999L);
+    if (dirty & (1UL << BL_GOLD)) {
+        if ((money = money_cnt(g.invent)) < 0L)
+            money = 0L; /* ought to issue impossible() and then discard */
+        g.blstats[idx][BL_GOLD].a.a_long = min(money, 999999L);
+    } else {
+        bl_keep(BL_GOLD, idx);
+    }
     /*
      * The tty port needs to display the current symbol for gold
      * as a field header, so to accommodate that we pass gold with
@@ -919,7 +962,33 @@ bot_via_windowport()
         if (condtests[i].enabled && condtests[i].test)
             cond_bitset(i);
     }
+#ifdef EXTRA_SANITY_CHECKS
+    for (i = 0; i < MAXBLSTATS; ++i)
+        if ((clean & (1UL << i)) != 0L
+            && compare_blstats(&g.blstats[1 - idx][i], &g.blstats[idx][i]))
+            stale = i;
+#endif
     evaluate_and_notify_windowport(g.valset, idx);
+#ifdef EXTRA_SANITY_CHECKS
+    /* reported after the round is over so that pline() doesn't
+       re-enter bot() */
+    if (stale >= 0)
+        impossible("status field '%s' changed without status_dirty()",
+                   initblstats[stale].fldname);
+#endif
+}
+
+/* carry a status field which hasn't been marked dirty over from the
+   previous bot() round */
+static void
+bl_keep(fld, idx)
+int fld, idx;
+{
+    struct istat_s *curr = &g.blstats[idx][fld],
+                   *prev = &g.blstats[1 - idx][fld];
+
+    curr->a = prev->a;
+    Strcpy(curr->val, prev->val);
 }
 
  
@@ -934,13 +1003,63 @@ stat_update_time()
     g.blstats[idx][fld].a.a_long = g.moves;
     g.valset[fld] = FALSE;
 
+    status_batch_begin();
     eval_notify_windowport_field(fld, g.valset, idx);
-    if ((windowprocs.wincap2 & WC2_FLUSH_STATUS) != 0L)
+    if (!status_batch_end(FALSE, FALSE)
+        && (windowprocs.wincap2 & WC2_FLUSH_STATUS) != 0L)
         status_update(BL_FLUSH, (genericptr_t) 0, 0, 0,
                       NO_COLOR, (unsigned long *) 0);
     return;
 }
 
+/* start holding field updates if the window port can take a whole
+   round of them in one status_update(BL_BATCH) */
+static void
+status_batch_begin()
+{
+    bl_batched = ((windowprocs.wincap2 & WC2_BATCH_STATUS) != 0L) ? 0 : -1;
+}
+
+/* pass one field to the window port, or hold it for BL_BATCH */
+static void
+status_deliver(fld, ptr, chg, percent, color, colormasks)
+int fld, chg, percent, color;
+genericptr_t ptr;
+unsigned long *colormasks;
+{
+    struct status_batch *sb;
+
+    if (bl_batched < 0 || bl_batched >= MAXBLSTATS) {
+        status_update(fld, ptr, chg, percent, color, colormasks);
+        return;
+    }
+    sb = &bl_batch[bl_batched++];
+    sb->fld = fld;
+    sb->ptr = ptr;
+    sb->chg = chg;
+    sb->percent = percent;
+    sb->color = color;
+}
+
+/* deliver the held fields, which also takes the place of BL_FLUSH (or
+   of BL_RESET when 'reset' is set); nothing is sent if no fields are
+   held unless 'force' is set; returns FALSE if nothing was being held
+   because the window port takes fields one at a time */
+static boolean
+status_batch_end(force, reset)
+boolean force, reset;
+{
+    int count = bl_batched;
+
+    if (count < 0)
+        return FALSE;
+    bl_batched = -1;
+    if (count > 0 || force || reset)
+        status_update(BL_BATCH, (genericptr_t) bl_batch, count, reset ? 1 : 0,
+                      NO_COLOR, g.cond_hilites);
+    return TRUE;
+}
+
 /* deal with player's choice to change processing of a condition */
 void
 condopt(addr, negated)
@@ -1094,12 +1213,12 @@ boolean *valsetlist;
                 }
             }
 #endif /* STATUS_HILITES */
-            status_update(fld, (genericptr_t) curr->val,
-                          chg, pc, color, (unsigned long *) 0);
+            status_deliver(fld, (genericptr_t) curr->val,
+                           chg, pc, color, (unsigned long *) 0);
         } else {
             /* Color for conditions is done through g.cond_hilites[] */
-            status_update(fld, (genericptr_t) &curr->a.a_ulong,
-                          chg, pc, color, g.cond_hilites);
+            status_deliver(fld, (genericptr_t) &curr->a.a_ulong,
+                           chg, pc, color, g.cond_hilites);
         }
         curr->chg = prev->chg = TRUE;
         updated = TRUE;
@@ -1113,10 +1232,12 @@ int idx;
 boolean *valsetlist;
 {
     int i, updated = 0, notpresent = 0;
+    boolean reset;
 
     /*
      *  Now pass the changed values to window port.
      */
+    status_batch_begin();
     for (i = 0; i < MAXBLSTATS; i++) {
         if (((i == BL_SCORE) && !flags.showscore)
             || ((i == BL_EXP) && !flags.showexp)
@@ -1151,8 +1272,15 @@ boolean *valsetlist;
      * all buffered changes received thus far but not reflected in
      * the display, call status_update() with BL_FLUSH.
      *
+     * A window port which sets WC2_BATCH_STATUS gets all of that in
+     * one status_update() with BL_BATCH instead.
+     *
      */
-    if (g.context.botlx && (windowprocs.wincap2 & WC2_RESET_STATUS) != 0L)
+    reset = (g.context.botlx
+             && (windowprocs.wincap2 & WC2_RESET_STATUS) != 0L);
+    if (status_batch_end(g.context.botlx, reset))
+        ; /* fields and the flush or reset went as one BL_BATCH */
+    else if (reset)
         status_update(BL_RESET, (genericptr_t) 0, 0, 0,
                       NO_COLOR, (unsigned long *) 0);
     else if ((updated || g.context.botlx)
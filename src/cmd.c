@@ -172,7 +172,15 @@ static void FDECL(mon_chain, (winid, const char *, struct monst *,
                                   BOOLEAN_P, long *, long *));
 static void FDECL(contained_stats, (winid, const char *, long *, long *));
 static void FDECL(misc_stats, (winid, long *, long *));
+static void FDECL(pool_stats, (winid));
 static int NDECL(wiz_show_stats);
+#ifdef MONITOR_HEAP
+static void FDECL(heapstats_putstr, (const char *, genericptr_t));
+static int NDECL(wiz_heapstats);
+#endif
+#ifdef PERF_STATS
+static int NDECL(wiz_perfstats);
+#endif
 static boolean FDECL(accept_menu_prefix, (int NDECL((*))));
 static int NDECL(wiz_rumor_check);
 
@@ -1731,6 +1739,10 @@ struct ext_func_tab extcmdlist[] = {
     { M('f'), "force", "force a lock", doforce, AUTOCOMPLETE },
     { ';', "glance", "show what type of thing a map symbol corresponds to",
             doquickwhatis, IFBURIED | GENERALCMD },
+#ifdef MONITOR_HEAP
+    { '\0', "heapstats", "show memory allocated by each call site",
+            wiz_heapstats, IFBURIED | AUTOCOMPLETE | WIZMODECMD },
+#endif
     { '?', "help", "give a help message", dohelp, IFBURIED | GENERALCMD },
     { '\0', "herecmdmenu", "show menu of commands you can do here",
             doherecmdmenu, IFBURIED },
@@ -1771,6 +1783,10 @@ struct ext_func_tab extcmdlist[] = {
     { '\0', "panic", "test panic routine (fatal to game)",
             wiz_panic, IFBURIED | AUTOCOMPLETE | WIZMODECMD },
     { 'p', "pay", "pay your shopping bill", dopay },
+#ifdef PERF_STATS
+    { '\0', "perfstats", "show where the time between commands goes",
+            wiz_perfstats, IFBURIED | AUTOCOMPLETE | WIZMODECMD },
+#endif
     { ',', "pickup", "pick up things at the current location", dopickup },
     { '\0', "polyself", "polymorph self",
             wiz_polyself, IFBURIED | AUTOCOMPLETE | WIZMODECMD },
@@ -2502,6 +2518,28 @@ long *total_size;
     }
 }
 
+/* objects, monsters and their extensions are carved out of pools (see
+   alloc.c); show how much of each pool is in use, which is already
+   counted above, and how much it holds in reserve */
+static void
+pool_stats(win)
+winid win;
+{
+    char buf[BUFSZ], hdrbuf[QBUFSZ];
+    struct nhpool *const *pool;
+    long size;
+
+    for (pool = nhpools; *pool; ++pool) {
+        if (!(*pool)->nchunks)
+            continue;
+        size = (*pool)->nchunks * (long) (*pool)->perchunk;
+        Sprintf(hdrbuf, "%s pool, %ld slots", (*pool)->name, size);
+        Sprintf(buf, template, hdrbuf, (*pool)->inuse,
+                size * (long) (*pool)->itemsize);
+        putstr(win, 0, buf);
+    }
+}
+
 /*
  * Display memory usage of all monsters and objects on the level.
  */
@@ -2580,6 +2618,10 @@ wiz_show_stats()
              + total_ovr_size + total_misc_size));
     putstr(win, 0, buf);
 
+    putstr(win, 0, "");
+    putstr(win, 0, "  Allocation pools (in use is included above)");
+    pool_stats(win);
+
 #if defined(__BORLANDC__) && !defined(_WIN32)
     show_borlandc_stats(win);
 #endif
@@ -2589,6 +2631,43 @@ wiz_show_stats()
     return 0;
 }
 
+#ifdef MONITOR_HEAP
+static void
+heapstats_putstr(line, arg)
+const char *line;
+genericptr_t arg;
+{
+    putstr(*(winid *) arg, 0, line);
+}
+
+/* #heapstats command - show the call sites holding the most memory */
+static int
+wiz_heapstats()
+{
+    winid win = create_nhwindow(NHW_TEXT);
+
+    putstr(win, 0, "Heap usage by call site:");
+    heapmon_report(heapstats_putstr, (genericptr_t) &win, 50);
+    display_nhwindow(win, FALSE);
+    destroy_nhwindow(win);
+    return 0;
+}
+#endif /* MONITOR_HEAP */
+
+#ifdef PERF_STATS
+/* #perfstats command - show the time spent in each phase of moveloop() */
+static int
+wiz_perfstats()
+{
+    winid win = create_nhwindow(NHW_TEXT);
+
+    perf_report(win);
+    display_nhwindow(win, FALSE);
+    destroy_nhwindow(win);
+    return 0;
+}
+#endif /* PERF_STATS */
+
 void
 sanity_check()
 {
@@ -2596,7 +2675,10 @@ sanity_check()
     timer_sanity_check();
     mon_sanity_check();
     light_sources_sanity_check();
+    region_sanity_check();
     bc_sanity_check();
+    trap_sanity_check();
+    engr_sanity_check();
 }
 
 #ifdef DEBUG_MIGRATING_MONS
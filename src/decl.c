@@ -22,6 +22,8 @@ const schar zdir[10] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, -1 };
 
 NEARDATA struct flag flags;
 NEARDATA boolean has_strong_rngseed = FALSE;
+NEARDATA unsigned long fixed_rngseed = 0L; /* nonzero: overrides system seed */
+NEARDATA time_t fixed_gametime = 0; /* nonzero: calendar doesn't move */
 #ifdef SYSFLAGS
 NEARDATA struct sysflag sysflags;
 #endif
@@ -140,6 +142,9 @@ const struct savefile_info default_sfinfo = {
 #endif
 #if defined(RLECOMP)
         | SFI1_RLECOMP
+#endif
+#if defined(LZCOMP)
+        | SFI1_LZCOMP
 #endif
     ,
 #ifdef NHSTDC
@@ -151,6 +156,20 @@ const struct savefile_info default_sfinfo = {
 
 NEARDATA struct savefile_info sfcap, sfrestinfo, sfsaveinfo;
 
+struct nhpool obj_pool = NHPOOL_INIT("obj", struct obj),
+              oextra_pool = NHPOOL_INIT("oextra", struct oextra),
+              monst_pool = NHPOOL_INIT("monst", struct monst),
+              mextra_pool = NHPOOL_INIT("mextra", struct mextra),
+              egd_pool = NHPOOL_INIT("egd", struct egd),
+              epri_pool = NHPOOL_INIT("epri", struct epri),
+              eshk_pool = NHPOOL_INIT("eshk", struct eshk),
+              emin_pool = NHPOOL_INIT("emin", struct emin),
+              edog_pool = NHPOOL_INIT("edog", struct edog);
+struct nhpool *const nhpools[] = {
+    &obj_pool, &oextra_pool, &monst_pool, &mextra_pool, &egd_pool,
+    &epri_pool, &eshk_pool, &emin_pool, &edog_pool, (struct nhpool *) 0
+};
+
 #ifdef PANICTRACE
 const char *ARGV0;
 #endif
@@ -235,6 +254,7 @@ const struct instance_globals g_init = {
 #endif
     UNDEFINED_VALUES, /* cond_hilites */
     0, /* now_or_before_idx */
+    0UL, /* bl_dirty */
 
     /* cmd.c */
     UNDEFINED_VALUES, /* Cmd */
@@ -303,6 +323,7 @@ const struct instance_globals g_init = {
     FALSE, /* unweapon */
     FALSE, /* mrg_to_wielded */
     NULL, /* plinemsg_types */
+    DUMMY, /* plinemsg_rx */
     UNDEFINED_VALUES, /* toplines */
     UNDEFINED_PTR, /* upstairs_room */
     UNDEFINED_PTR, /* dnstairs_room */
@@ -311,6 +332,7 @@ const struct instance_globals g_init = {
     FALSE, /* in_steed_dismounting */
     DUMMY, /* doors */
     NULL, /* menu_colorings */
+    DUMMY, /* menucolor_rx */
     DUMMY, /* lastseentyp */
     DUMMY, /* spl_book */
     UNDEFINED_VALUES, /* level_info */
@@ -388,6 +410,7 @@ const struct instance_globals g_init = {
     NULL, /* mydogs */
     NULL, /* migrating_mons */
     NULL, /* apelist */
+    DUMMY, /* ape_rx */
     UNDEFINED_VALUES, /* mvitals */
 
     /* dokick.c */
@@ -444,6 +467,8 @@ const struct instance_globals g_init = {
     /* hack.c */
     UNDEFINED_VALUES,
     UNDEFINED_VALUE,
+    NULL, /* travelcache */
+    0UL, /* travel_gen */
 
     /* invent.c */
     51, /* lastinvr */
@@ -480,7 +505,6 @@ const struct instance_globals g_init = {
     UNDEFINED_VALUE, /* made_branch */
 
     /* mkmap.c */
-    UNDEFINED_PTR, /* new_locations */
     UNDEFINED_VALUE, /* min_rx */
     UNDEFINED_VALUE, /* max_rx */
     UNDEFINED_VALUE, /* min_ry */
@@ -499,11 +523,15 @@ const struct instance_globals g_init = {
     UNDEFINED_VALUE, /* ymax */
     0, /* ransacked */
 
+    /* mkobj.c */
+    { NULL, 0, 0 }, /* oid_map */
+
     /* mon.c */
     UNDEFINED_VALUE, /* vamp_rise_msg */
     UNDEFINED_VALUE, /* disintegested */
     NULL, /* animal_list */
     UNDEFINED_VALUE, /* animal_list_count */
+    { NULL, 0, 0 }, /* mid_map */
 
     /* mthrowu.c */
     UNDEFINED_VALUE, /* mesg_given */
@@ -523,6 +551,9 @@ const struct instance_globals g_init = {
     MAX_LAN_USERNAME, /* lusername_size */
 #endif /* MAX_LAN_USERNAME */
 
+    /* nhlua.c */
+    NULL, /* luacore */
+
     /* o_init.c */
     DUMMY, /* disco */
 
@@ -585,10 +616,12 @@ const struct instance_globals g_init = {
     NULL, /* regions */
     0, /* n_regions */
     0, /* max_regions */
+    DUMMY, /* region_cells */
+    0L, /* region_clock */
+    0L, /* region_expiry */
 
     /* restore.c */
-    0, /* n_ids_mapped */
-    0, /* id_map */
+    { NULL, 0, 0 }, /* id_map */
     FALSE, /* restoring */
     UNDEFINED_PTR, /* oldfruit */
     UNDEFINED_VALUE, /* omoves */
@@ -644,7 +677,11 @@ const struct instance_globals g_init = {
     NULL, /* telescroll */
 
     /* timeout.c */
-    UNDEFINED_PTR, /* timer_base */
+    NULL, /* timer_heap */
+    0, /* timer_count */
+    0, /* timer_heapmax */
+    NULL, /* timer_hash */
+    0UL, /* timer_seq */
     1, /* timer_id */
 
     /* topten.c */
@@ -131,6 +131,7 @@ static void FDECL(display_warning, (struct monst *));
 
 static int FDECL(check_pos, (int, int, int));
 static int FDECL(get_bk_glyph, (XCHAR_P, XCHAR_P));
+static void FDECL(send_glyph_run, (int, int, int));
 static int FDECL(tether_glyph, (int, int));
 
 /*#define WA_VERBOSE*/ /* give (x,y) locations for all "bad" spots */
@@ -1433,7 +1434,7 @@ docrt()
 void
 redraw_map()
 {
-    int x, y, glyph;
+    int y;
 
     /*
      * Not sure whether this is actually necessary; save and restore did
@@ -1452,10 +1453,7 @@ redraw_map()
      * the map would currently be showing.
      */
     for (y = 0; y < ROWNO; ++y)
-        for (x = 1; x < COLNO; ++x) {
-            glyph = glyph_at(x, y); /* not levl[x][y].glyph */
-            print_glyph(WIN_MAP, x, y, glyph, get_bk_glyph(x, y));
-        }
+        send_glyph_run(1, y, COLNO - 1); /* gbuf[][], not levl[][].glyph */
     flush_screen(1);
 }
 
@@ -1600,11 +1598,16 @@ void
 row_refresh(start, stop, y)
 int start, stop, y;
 {
-    register int x;
+    register int x, n;
 
-    for (x = start; x <= stop; x++)
-        if (g.gbuf[y][x].glyph != GLYPH_UNEXPLORED)
-            print_glyph(WIN_MAP, x, y, g.gbuf[y][x].glyph, get_bk_glyph(x, y));
+    for (x = start; x <= stop; x += n + 1) {
+        for (n = 0; x + n <= stop
+                    && g.gbuf[y][x + n].glyph != GLYPH_UNEXPLORED; n++)
+            continue;
+        if (n)
+            send_glyph_run(x, y, n);
+        /* the 'n + 1' skips the unexplored spot which ended the run */
+    }
 }
 
 void
@@ -1640,7 +1643,8 @@ int cursor_on_u;
      */
     static int flushing = 0;
     static int delay_flushing = 0;
-    register int x, y;
+    register int x, y, n;
+    int prevphase;
 
     if (cursor_on_u == -1)
         delay_flushing = !delay_flushing;
@@ -1653,15 +1657,22 @@ int cursor_on_u;
     if (g.program_state.done_hup)
         return;
 #endif
+    prevphase = perf_phase(PERF_FLUSH);
 
     for (y = 0; y < ROWNO; y++) {
         register gbuf_entry *gptr = &g.gbuf[y][x = g.gbuf_start[y]];
 
-        for (; x <= g.gbuf_stop[y]; gptr++, x++)
-            if (gptr->gnew) {
-                print_glyph(WIN_MAP, x, y, gptr->glyph, get_bk_glyph(x, y));
-                gptr->gnew = 0;
+        while (x <= g.gbuf_stop[y]) {
+            if (!gptr->gnew) {
+                gptr++, x++;
+                continue;
             }
+            /* take the whole run of changed spots at once */
+            for (n = 0; x + n <= g.gbuf_stop[y] && gptr[n].gnew; n++)
+                gptr[n].gnew = 0;
+            send_glyph_run(x, y, n);
+            gptr += n, x += n;
+        }
     }
 
     if (cursor_on_u)
@@ -1669,12 +1680,37 @@ int cursor_on_u;
     display_nhwindow(WIN_MAP, FALSE);
     reset_glyph_bbox();
     flushing = 0;
+    (void) perf_phase(prevphase);
     if (g.context.botl || g.context.botlx)
         bot();
     else if (iflags.time_botl)
         timebot();
 }
 
+/*
+ * Send columns x through x+n-1 of map row y to the window port, in one
+ * print_glyph_run() if it can take them that way or else one spot at a
+ * time.
+ */
+static void
+send_glyph_run(x, y, n)
+int x, y, n;
+{
+    int i, glyphs[COLNO], bkglyphs[COLNO];
+
+    if (!(windowprocs.wincap2 & WC2_GLYPH_RUN)) {
+        for (i = 0; i < n; i++, x++)
+            print_glyph(WIN_MAP, x, y, g.gbuf[y][x].glyph,
+                        get_bk_glyph(x, y));
+        return;
+    }
+    for (i = 0; i < n; i++) {
+        glyphs[i] = g.gbuf[y][x + i].glyph;
+        bkglyphs[i] = get_bk_glyph(x + i, y);
+    }
+    print_glyph_run(WIN_MAP, x, y, n, glyphs, bkglyphs);
+}
+
 /* ======================================================================== */
 
 /*
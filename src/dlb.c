@@ -12,6 +12,12 @@
 #include <string.h>
 #endif
 
+#ifdef DLB_MMAP
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #define DATAPREFIX 4		/* see decl.h */
 
 #ifdef DLB
@@ -60,6 +66,8 @@ extern FILE *FDECL(fopen_datafile, (const char *, const char *, int));
 #define MAX_LIBS 4
 static library dlb_libs[MAX_LIBS];
 
+static unsigned FDECL(dirhash, (const char *));
+static void FDECL(hashlibdir, (library * lp));
 static boolean FDECL(readlibdir, (library * lp));
 static boolean FDECL(find_file, (const char *name, library **lib,
                                      long *startp, long *sizep));
@@ -115,6 +123,50 @@ extern char *FDECL(eos, (char *));
 #define DLB_MIN_VERS 1 /* min library version readable by this code */
 #define DLB_MAX_VERS 1 /* max library version readable by this code */
 
+/*
+ * Hash a file name.  Case is folded so that the result is usable
+ * whether or not FILENAME_CMP is case sensitive.
+ */
+static unsigned
+dirhash(name)
+const char *name;
+{
+    unsigned h = 0;
+    int c;
+
+    while ((c = *name++) != '\0') {
+        if (c >= 'A' && c <= 'Z')
+            c += 'a' - 'A';
+        h = h * 31 + (unsigned) c;
+    }
+    return h;
+}
+
+/*
+ * Build the hash index of the directory so find_file() doesn't have to
+ * compare against every entry.  Open addressing with linear probing; the
+ * table is kept at most half full.
+ */
+static void
+hashlibdir(lp)
+library *lp;
+{
+    long i, slot, mask;
+
+    for (lp->hashsize = 16; lp->hashsize < 2 * lp->nentries;)
+        lp->hashsize <<= 1;
+    lp->dhash = (int *) alloc(lp->hashsize * sizeof (int));
+    (void) memset((genericptr_t) lp->dhash, 0, lp->hashsize * sizeof (int));
+
+    mask = lp->hashsize - 1;
+    for (i = 0; i < lp->nentries; i++) {
+        slot = (long) (dirhash(lp->dir[i].fname) & (unsigned) mask);
+        while (lp->dhash[slot])
+            slot = (slot + 1) & mask;
+        lp->dhash[slot] = (int) i + 1;
+    }
+}
+
 /*
  * Read the directory from the library file.   This will allocate and
  * fill in our globals.  The file pointer is reset back to position
@@ -161,6 +213,8 @@ library *lp; /* library pointer to fill in */
             lp->dir[i].fsize = lp->dir[i + 1].foffset - lp->dir[i].foffset;
     }
 
+    hashlibdir(lp);
+
     (void) fseek(lp->fdata, 0L, SEEK_SET); /* reset back to zero */
     lp->fmark = 0;
 
@@ -178,11 +232,16 @@ library **lib;
 long *startp, *sizep;
 {
     int i, j;
+    long slot, mask;
+    unsigned h = dirhash(name);
     library *lp;
 
     for (i = 0; i < MAX_LIBS && dlb_libs[i].fdata; i++) {
         lp = &dlb_libs[i];
-        for (j = 0; j < lp->nentries; j++) {
+        mask = lp->hashsize - 1;
+        for (slot = (long) (h & (unsigned) mask); (j = lp->dhash[slot]) != 0;
+             slot = (slot + 1) & mask) {
+            --j;
             if (FILENAME_CMP(name, lp->dir[j].fname) == 0) {
                 *lib = lp;
                 *startp = lp->dir[j].foffset;
@@ -207,10 +266,34 @@ library *lp;
 {
     boolean status = FALSE;
 
+    lp->mapped = (char *) 0;
+    lp->mapsize = 0L;
     lp->fdata = fopen_datafile(lib_name, RDBMODE, DATAPREFIX);
     if (lp->fdata) {
         if (readlibdir(lp)) {
             status = TRUE;
+#ifdef DLB_MMAP
+            {
+                struct stat st;
+                genericptr_t m;
+
+                /* the archive is read-only data that every game reads
+                   from over and over, so map it and serve reads straight
+                   out of memory; stay with stdio if that can't be done.
+                   The mapping is private, but pages not yet read still
+                   come from the file:  if it's overwritten in place while
+                   a game is running (as 'make install' does; 'make
+                   update' moves the old one aside first), a read past
+                   its new end raises SIGBUS. */
+                if (!fstat(fileno(lp->fdata), &st) && st.st_size > 0
+                    && (m = mmap((genericptr_t) 0, (size_t) st.st_size,
+                                 PROT_READ, MAP_PRIVATE, fileno(lp->fdata),
+                                 (off_t) 0)) != MAP_FAILED) {
+                    lp->mapped = (char *) m;
+                    lp->mapsize = (long) st.st_size;
+                }
+            }
+#endif
         } else {
             (void) fclose(lp->fdata);
             lp->fdata = (FILE *) 0;
@@ -223,9 +306,14 @@ void
 close_library(lp)
 library *lp;
 {
+#ifdef DLB_MMAP
+    if (lp->mapped)
+        (void) munmap((genericptr_t) lp->mapped, (size_t) lp->mapsize);
+#endif
     (void) fclose(lp->fdata);
     free((genericptr_t) lp->dir);
     free((genericptr_t) lp->sspace);
+    free((genericptr_t) lp->dhash);
 
     (void) memset((char *) lp, 0, sizeof(library));
 }
@@ -320,6 +408,15 @@ dlb *dp;
     if (quan == 0)
         return 0;
 
+    if (dp->lib->mapped) {
+        nbytes = (long) size * quan;
+        (void) memcpy((genericptr_t) buf,
+                      (genericptr_t) (dp->lib->mapped + dp->start + dp->mark),
+                      (size_t) nbytes);
+        dp->mark += nbytes;
+        return quan;
+    }
+
     pos = dp->start + dp->mark;
     if (dp->lib->fmark != pos) {
         fseek(dp->lib->fdata, pos, SEEK_SET); /* check for error??? */
@@ -379,11 +476,24 @@ dlb *dp;
         return (char *) 0;
 
     len--; /* save room for null */
-    for (i = 0, bp = buf; i < len && dp->mark < dp->size && c != '\n';
-         i++, bp++) {
-        if (dlb_fread(bp, 1, 1, dp) <= 0)
-            break; /* EOF or error */
-        c = *bp;
+    if (dp->lib->mapped) {
+        const char *src = dp->lib->mapped + dp->start + dp->mark, *nl;
+
+        i = (dp->size - dp->mark < (long) len) ? (int) (dp->size - dp->mark)
+                                                : len;
+        if ((nl = (const char *) memchr((genericptr_t) src, '\n',
+                                        (size_t) i)) != 0)
+            i = (int) (nl - src) + 1;
+        (void) memcpy((genericptr_t) buf, (genericptr_t) src, (size_t) i);
+        dp->mark += i;
+        bp = buf + i;
+    } else {
+        for (i = 0, bp = buf; i < len && dp->mark < dp->size && c != '\n';
+             i++, bp++) {
+            if (dlb_fread(bp, 1, 1, dp) <= 0)
+                break; /* EOF or error */
+            c = *bp;
+        }
     }
     *bp = '\0';
 
@@ -403,7 +513,11 @@ dlb *dp;
 {
     char c;
 
-    if (lib_dlb_fread(&c, 1, 1, dp) != 1)
+    if (dp->lib->mapped) {
+        if (dp->mark >= dp->size)
+            return EOF;
+        c = dp->lib->mapped[dp->start + dp->mark++];
+    } else if (lib_dlb_fread(&c, 1, 1, dp) != 1)
         return EOF;
     return (int) c;
 }
@@ -580,6 +694,28 @@ dlb *dp;
     return do_dlb_ftell(dp);
 }
 
+/*
+ * Direct access to the whole contents of an open file, without copying.
+ * Only available when the file lives in a memory mapped library; returns
+ * null otherwise and the caller has to use dlb_fread() instead.  The
+ * pointer stays valid until dlb_cleanup() and the data is not terminated.
+ */
+const char *
+dlb_fmap(dp, sizep)
+dlb *dp;
+long *sizep;
+{
+    if (!dlb_initialized || dp->fp)
+        return (const char *) 0;
+#ifdef DLBLIB
+    if (dp->lib && dp->lib->mapped) {
+        *sizep = dp->size;
+        return dp->lib->mapped + dp->start;
+    }
+#endif
+    return (const char *) 0;
+}
+
 #endif /* DLB */
 
 /*dlb.c*/
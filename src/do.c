@@ -1444,6 +1444,7 @@ boolean at_stairs, falling, portal;
         recbranch_mapseen(&u.uz, newlevel);
     assign_level(&u.uz0, &u.uz);
     assign_level(&u.uz, newlevel);
+    status_dirty(BL_LEVELDESC);
     assign_level(&u.utolev, newlevel);
     u.utotype = 0;
     if (!builds_up(&u.uz)) { /* usual case */
@@ -14,7 +14,7 @@ struct monst *mtmp;
     if (!mtmp->mextra)
         mtmp->mextra = newmextra();
     if (!EDOG(mtmp)) {
-        EDOG(mtmp) = (struct edog *) alloc(sizeof(struct edog));
+        EDOG(mtmp) = (struct edog *) pool_alloc(&edog_pool);
         (void) memset((genericptr_t) EDOG(mtmp), 0, sizeof(struct edog));
     }
 }
@@ -24,7 +24,7 @@ free_edog(mtmp)
 struct monst *mtmp;
 {
     if (mtmp->mextra && EDOG(mtmp)) {
-        free((genericptr_t) EDOG(mtmp));
+        pool_free(&edog_pool, (genericptr_t) EDOG(mtmp));
         EDOG(mtmp) = (struct edog *) 0;
     }
     mtmp->mtame = 0;
@@ -41,8 +41,12 @@ static void FDECL(dump_everything, (int, time_t));
 #if defined(__BEOS__) || defined(MICRO) || defined(OS2) || defined(WIN32)
 extern void FDECL(nethack_exit, (int));
 #else
+#ifdef LIBNH
+extern void FDECL(nethack_exit, (int)) NORETURN;
+#else
 #define nethack_exit exit
 #endif
+#endif
 
 #define done_stopprint g.program_state.stopprint
 
@@ -1686,12 +1690,18 @@ nh_terminate(status)
 int status;
 {
     g.program_state.in_moveloop = 0; /* won't be returning to normal play */
+#ifdef RECORD_INPUT
+    record_finish();
+#endif
 #ifdef MAC
     getreturn("to exit");
 #endif
     /* don't bother to try to release memory if we're in panic mode, to
        avoid trouble in case that happens to be due to memory problems */
     if (!g.program_state.panicking) {
+#ifdef PERF_STATS
+        perf_dump();
+#endif
         freedynamicdata();
         dlb_cleanup();
     }
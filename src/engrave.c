@@ -244,14 +244,9 @@ struct engr *
 engr_at(x, y)
 xchar x, y;
 {
-    register struct engr *ep = head_engr;
-
-    while (ep) {
-        if (x == ep->engr_x && y == ep->engr_y)
-            return ep;
-        ep = ep->nxt_engr;
-    }
-    return (struct engr *) 0;
+    if (!isok(x, y))
+        return (struct engr *) 0;
+    return g.level.engravings[x][y];
 }
 
 /* Decide whether a particular string is engraved at a specified
@@ -402,6 +397,7 @@ xchar e_type;
     head_engr = ep;
     ep->engr_x = x;
     ep->engr_y = y;
+    g.level.engravings[x][y] = ep;
     ep->engr_txt = (char *) (ep + 1);
     Strcpy(ep->engr_txt, s);
     /* engraving Elbereth shows wisdom */
@@ -1192,8 +1188,9 @@ NHFILE *nhfp;
                 bwrite(nhfp->fd, (genericptr_t)ep, sizeof(struct engr) + ep->engr_lth);
             }
         }
+        /* the memory goes when savelev() resets the level's arena */
         if (release_data(nhfp))
-            dealloc_engr(ep);
+            g.level.engravings[ep->engr_x][ep->engr_y] = (struct engr *) 0;
     }
     if (perform_bwrite(nhfp)) {
         if (nhfp->structlevel)
@@ -1209,8 +1206,12 @@ NHFILE *nhfp;
 {
     struct engr *ep;
     unsigned lth = 0;
+    int x, y;
 
     head_engr = 0;
+    for (x = 0; x < COLNO; x++)
+        for (y = 0; y < ROWNO; y++)
+            g.level.engravings[x][y] = (struct engr *) 0;
     while (1) {
         if (nhfp->structlevel)
             mread(nhfp->fd, (genericptr_t) &lth, sizeof(unsigned));
@@ -1223,6 +1224,7 @@ NHFILE *nhfp;
         }
         ep->nxt_engr = head_engr;
         head_engr = ep;
+        g.level.engravings[ep->engr_x][ep->engr_y] = ep;
         ep->engr_txt = (char *) (ep + 1);	/* Andreas Bormann */
         /* mark as finished for bones levels -- no problem for
          * normal levels as the player must have finished engraving
@@ -1267,6 +1269,8 @@ register struct engr *ep;
             return;
         }
     }
+    if (g.level.engravings[ep->engr_x][ep->engr_y] == ep)
+        g.level.engravings[ep->engr_x][ep->engr_y] = (struct engr *) 0;
     dealloc_engr(ep);
 }
 
@@ -1284,8 +1288,11 @@ struct engr *ep;
         ty = rn2(ROWNO);
     } while (engr_at(tx, ty) || !goodpos(tx, ty, (struct monst *) 0, 0));
 
+    if (g.level.engravings[ep->engr_x][ep->engr_y] == ep)
+        g.level.engravings[ep->engr_x][ep->engr_y] = (struct engr *) 0;
     ep->engr_x = tx;
     ep->engr_y = ty;
+    g.level.engravings[tx][ty] = ep;
 }
 
 /* Create a headstone at the given location.
@@ -1338,4 +1345,25 @@ blengr(VOID_ARGS)
     return blind_writing[rn2(SIZE(blind_writing))];
 }
 
+/* like traps, engravings come from the current level's arena */
+void
+engr_sanity_check()
+{
+    struct engr *ep;
+    int x, y;
+
+    for (ep = head_engr; ep; ep = ep->nxt_engr)
+        if (!arena_owns(&g.level.arena, (genericptr_t) ep)) {
+            impossible("engraving sanity: stray engraving %s in list",
+                       fmt_ptr((genericptr_t) ep));
+            return; /* can't follow its nxt_engr */
+        }
+    for (x = 0; x < COLNO; x++)
+        for (y = 0; y < ROWNO; y++)
+            if ((ep = g.level.engravings[x][y]) != 0
+                && !arena_owns(&g.level.arena, (genericptr_t) ep))
+                impossible("engraving sanity: stray engraving %s at <%d,%d>",
+                           fmt_ptr((genericptr_t) ep), x, y);
+}
+
 /*engrave.c*/
@@ -169,6 +169,11 @@ static void FDECL(parseformat, (int *, char *));
 static boolean FDECL(copy_bytes, (int, int));
 #endif
 static NHFILE *FDECL(viable_nhfile, (NHFILE *));
+static NHFILE *FDECL(viable_memfile, (NHFILE *));
+static boolean FDECL(levelcache_wanted, (int));
+static void FDECL(levelcache_store, (NHFILE *));
+static boolean FDECL(levelcache_spill, (int));
+static boolean FDECL(levelcache_write, (int));
 
 /*
  * fname_encode()
@@ -446,6 +451,9 @@ close_nhfile(nhfp)
 NHFILE *nhfp;
 {
     if (nhfp) {
+        if (nhfp->ftype == NHF_LEVELFILE && nhfp->mode == WRITING
+            && is_membuf(nhfp->fd))
+            levelcache_store(nhfp);
         if (nhfp->structlevel && nhfp->fd != -1)
             (void) nhclose(nhfp->fd), nhfp->fd = -1;
         zero_nhfile(nhfp);
@@ -457,7 +465,9 @@ void
 rewind_nhfile(nhfp)
 NHFILE *nhfp;
 {
-    if (nhfp->structlevel) {
+    if (nhfp->structlevel && is_membuf(nhfp->fd)) {
+        membuf_rewind(nhfp->fd);
+    } else if (nhfp->structlevel) {
 #ifdef BSD
         (void) lseek(nhfp->fd, 0L, 0);
 #else
@@ -489,6 +499,149 @@ NHFILE *nhfp;
 
 /* ----------  BEGIN LEVEL FILE HANDLING ----------- */
 
+/*
+ * Level cache.
+ *
+ * The levels the hero isn't on are only needed by this process, so
+ * instead of a file apiece they're kept as in-memory files.
+ * create_levelfile() hands out one of those, which close_nhfile() stores
+ * here; open_levelfile() reads it back from here.  When more than
+ * sysopt.levelcache levels are held, the one which has gone unused the
+ * longest is written out as an ordinary level file.
+ *
+ * With INSURANCE and the checkpoint option, recover needs real level
+ * files as of the latest checkpoint, so savestateinlock() writes each
+ * cached level which has changed since then through to its file while
+ * keeping it in memory, and a stale file is left for that to replace
+ * rather than removed.
+ */
+static struct levelcache {
+    genericptr_t data; /* level's contents, or null if on disk */
+    long len;
+    long used;         /* when last stored or opened, for LRU */
+    int wfd;           /* in-memory file being written, or -1 */
+    boolean ondisk;    /* level file holds the same as 'data' */
+} lvcache[MAXLINFO];
+static long lvcache_clock = 0L;
+
+static boolean
+levelcache_wanted(lev)
+int lev;
+{
+    /* level 0 is the lock file, which has to be where others can see it */
+    if (lev <= 0 || lev >= MAXLINFO || sysopt.levelcache <= 0)
+        return FALSE;
+    return TRUE;
+}
+
+/* called by close_nhfile() for a level file that has just been written */
+static void
+levelcache_store(nhfp)
+NHFILE *nhfp;
+{
+    struct levelcache *lc;
+    int lev, oldest, ncached;
+    long oldtime;
+
+    for (lev = 1; lev < MAXLINFO; lev++)
+        if (lvcache[lev].wfd == nhfp->fd)
+            break;
+    if (lev == MAXLINFO) {
+        impossible("levelcache_store: unknown level file %d", nhfp->fd);
+        return;
+    }
+    lc = &lvcache[lev];
+    if (lc->data) {
+        free(lc->data);
+#ifdef INSURANCE
+    } else if (flags.ins_chkpt) {
+        ; /* keep the old file for recover until the next checkpoint */
+#endif
+    } else { /* a copy from before it was cached, or since spilled */
+        set_levelfile_name(g.lock, lev);
+        (void) unlink(fqname(g.lock, LEVELPREFIX, 0));
+    }
+    lc->data = membuf_detach(nhfp->fd, &lc->len);
+    lc->ondisk = FALSE;
+    lc->wfd = -1;
+    lc->used = ++lvcache_clock;
+    nhfp->fd = -1;
+
+    for (;;) {
+        ncached = 0, oldest = 0, oldtime = 0L;
+        for (lev = 1; lev < MAXLINFO; lev++)
+            if (lvcache[lev].data) {
+                ++ncached;
+                if (!oldest || lvcache[lev].used < oldtime)
+                    oldest = lev, oldtime = lvcache[lev].used;
+            }
+        if (ncached <= sysopt.levelcache || !levelcache_spill(oldest))
+            break;
+    }
+}
+
+/* write a cached level out as an ordinary level file and drop it from
+   memory */
+static boolean
+levelcache_spill(lev)
+int lev;
+{
+    struct levelcache *lc = &lvcache[lev];
+
+    if (!lc->ondisk && !levelcache_write(lev))
+        return FALSE;
+    free(lc->data);
+    lc->data = (genericptr_t) 0;
+    lc->len = 0L;
+    lc->ondisk = FALSE;
+    return TRUE;
+}
+
+/* copy a cached level to its level file, keeping it cached */
+static boolean
+levelcache_write(lev)
+int lev;
+{
+    struct levelcache *lc = &lvcache[lev];
+    const char *fq_lock;
+    int fd;
+    boolean ok;
+
+    set_levelfile_name(g.lock, lev);
+    fq_lock = fqname(g.lock, LEVELPREFIX, 0);
+#if defined(MICRO) || defined(WIN32)
+    fd = open(fq_lock, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, FCMASK);
+#else
+#ifdef MAC
+    fd = maccreat(fq_lock, LEVL_TYPE);
+#else
+    fd = creat(fq_lock, FCMASK);
+#endif
+#endif
+    if (fd < 0)
+        return FALSE;
+    ok = (write(fd, lc->data, (unsigned) lc->len) == lc->len);
+    (void) close(fd);
+    if (!ok) {
+        (void) unlink(fq_lock);
+        return FALSE;
+    }
+    lc->ondisk = TRUE;
+    return TRUE;
+}
+
+/* bring the level files up to date with the cache, for recover's sake */
+void
+flush_levelcache()
+{
+    int lev;
+
+    for (lev = 1; lev < MAXLINFO; lev++)
+        if (lvcache[lev].data && !lvcache[lev].ondisk
+            && !levelcache_write(lev))
+            impossible("Cannot write level file for level %d.", lev);
+}
+
 #ifdef MFLOPPY
 /* Set names for bones[] and lock[] */
 void
@@ -546,6 +699,22 @@ char errbuf[];
 
     if (errbuf)
         *errbuf = '\0';
+    if (levelcache_wanted(lev)) {
+        int i;
+
+        nhfp = create_memfile();
+        if (nhfp) {
+            nhfp->ftype = NHF_LEVELFILE;
+            /* forget any earlier file that was never closed */
+            for (i = 1; i < MAXLINFO; i++)
+                if (lvcache[i].wfd == nhfp->fd)
+                    lvcache[i].wfd = -1;
+            lvcache[lev].wfd = nhfp->fd;
+            g.level_info[lev].flags |= LFILE_EXISTS;
+            return nhfp;
+        }
+        /* out of in-memory files; fall back to an ordinary one */
+    }
     set_levelfile_name(g.lock, lev);
     fq_lock = fqname(g.lock, LEVELPREFIX, 0);
 
@@ -593,6 +762,19 @@ char errbuf[];
 
     if (errbuf)
         *errbuf = '\0';
+    if (lev > 0 && lev < MAXLINFO && lvcache[lev].data) {
+        nhfp = open_memfile(lvcache[lev].data, lvcache[lev].len);
+        if (nhfp) {
+            nhfp->ftype = NHF_LEVELFILE;
+            lvcache[lev].used = ++lvcache_clock;
+            return nhfp;
+        }
+        if (!levelcache_spill(lev)) {
+            if (errbuf)
+                Sprintf(errbuf, "Cannot open level %d from memory.", lev);
+            return (NHFILE *) 0;
+        }
+    }
     set_levelfile_name(g.lock, lev);
     fq_lock = fqname(g.lock, LEVELPREFIX, 0);
 #ifdef MFLOPPY
@@ -638,6 +820,12 @@ int lev;
      * Level 0 might be created by port specific code that doesn't
      * call create_levfile(), so always assume that it exists.
      */
+    if (lev > 0 && lev < MAXLINFO && lvcache[lev].data) {
+        free(lvcache[lev].data);
+        lvcache[lev].data = (genericptr_t) 0;
+        lvcache[lev].len = 0L;
+        lvcache[lev].ondisk = FALSE;
+    }
     if (lev == 0 || (g.level_info[lev].flags & LFILE_EXISTS)) {
         set_levelfile_name(g.lock, lev);
         (void) unlink(fqname(g.lock, LEVELPREFIX, 0));
@@ -699,10 +887,65 @@ int fd;
             bclose(fd);
         else
             retval = close(fd);
+    } else if (is_membuf(fd)) {
+        bclose(fd);
     }
     return retval;
 }
 
+/* in-memory counterparts of create_levelfile() and open_levelfile(),
+   for game snapshots and the level cache */
+NHFILE *
+create_memfile()
+{
+    NHFILE *nhfp = new_nhfile();
+
+    nhfp->structlevel = TRUE; /* bwrite() and mread() know about these */
+    nhfp->ftype = NHF_SAVEFILE;
+    nhfp->mode = WRITING;
+    nhfp->fd = membuf_open((genericptr_t) 0, 0L);
+    return viable_memfile(nhfp);
+}
+
+NHFILE *
+open_memfile(data, len)
+genericptr_t data;
+long len;
+{
+    NHFILE *nhfp = new_nhfile();
+
+    nhfp->structlevel = TRUE;
+    nhfp->ftype = NHF_SAVEFILE;
+    nhfp->mode = READING;
+    nhfp->fd = membuf_open(data, len);
+    return viable_memfile(nhfp);
+}
+
+/* close an in-memory file created by create_memfile() and return what
+   was written to it; the caller becomes responsible for freeing that */
+genericptr_t
+memfile_detach(nhfp, lenp)
+NHFILE *nhfp;
+long *lenp;
+{
+    genericptr_t data = membuf_detach(nhfp->fd, lenp);
+
+    nhfp->fd = -1;
+    close_nhfile(nhfp);
+    return data;
+}
+
+static NHFILE *
+viable_memfile(nhfp)
+NHFILE *nhfp;
+{
+    if (!is_membuf(nhfp->fd)) {
+        free_nhfile(nhfp);
+        nhfp = (NHFILE *) 0;
+    }
+    return nhfp;
+}
+
 /* ----------  END LEVEL FILE HANDLING ----------- */
 
 /* ----------  BEGIN BONES FILE HANDLING ----------- */
@@ -1602,6 +1845,10 @@ const char *filename UNUSED_if_not_COMPRESS;
 #ifdef PRAGMA_UNUSED
 #pragma unused(filename)
 #endif
+#elif defined(LZCOMP)
+    /* already compressed as it was written (sfstruct.c); the external
+       compressor is only needed to uncompress older files */
+    nhUse(filename);
 #else
     docompress_file(filename, FALSE);
 #endif
@@ -2603,6 +2850,9 @@ char *origbuf;
         /* note: right now bones_pools==0 is the same as bones_pools==1,
            but we could change that and make bones_pools==0 become an
            indicator to suppress bones usage altogether */
+    } else if (src == SET_IN_SYS && match_varname(buf, "LEVELCACHE", 10)) {
+        n = atoi(bufp);
+        sysopt.levelcache = max(n, 0);
     } else if (src == SET_IN_SYS && match_varname(buf, "SUPPORT", 7)) {
         if (sysopt.support)
             free((genericptr_t) sysopt.support);
@@ -470,6 +470,7 @@ register struct obj *obj;
                             (money + denomination - 1) / denomination;
                         coin_loss = min(coin_loss, otmp->quan);
                         otmp->quan -= coin_loss;
+                        status_dirty(BL_GOLD);
                         money -= coin_loss * denomination;
                         if (!otmp->quan)
                             delobj(otmp);
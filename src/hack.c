@@ -11,6 +11,12 @@ static void NDECL(maybe_wail);
 static int NDECL(moverock);
 static int FDECL(still_chewing, (XCHAR_P, XCHAR_P));
 static void NDECL(dosinkfall);
+static unsigned NDECL(travel_abilities);
+static void FDECL(travel_terrain, (unsigned short (*)[ROWNO]));
+static boolean NDECL(travel_cacheable);
+static struct travel_cache *FDECL(travel_cached, (int, int));
+static boolean FDECL(travel_search, (int, int, int, int, int, xchar (*)[ROWNO],
+                                     struct travel_cache *, int *, int *));
 static boolean FDECL(findtravelpath, (int));
 static boolean FDECL(trapmove, (int, int, struct trap *));
 static struct monst *FDECL(monstinroom, (struct permonst *, int));
@@ -940,6 +946,355 @@ int mode;
     return TRUE;
 }
 
+/*
+ * findtravelpath() is called for every step of a travel, and each call
+ * used to search the whole level afresh.  A search that isn't guessing
+ * depends only on where it starts (for travel, the destination), on the
+ * hero's abilities, and on the level itself, so its results are kept
+ * for reuse.  They're discarded when g.travel_gen has been bumped (by
+ * traps, doors, boulders, dug-out rock or the level itself changing) or
+ * when the parts of the map the search looked at don't match what they
+ * were; levl[] is changed directly in too many places for the counter to
+ * catch it all, but comparing the map is cheap next to searching it.
+ */
+#if ROWNO > 32
+#error "travel cache needs an unsigned long to hold a column of ROWNO bits"
+#endif
+
+#define TRAVEL_CACHED 2 /* destination and hero's own spot, when VALID */
+
+struct travel_cache {
+    boolean valid;
+    d_level uz;
+    unsigned long gen;          /* g.travel_gen when made */
+    long used;                  /* for picking one to replace */
+    xchar sx, sy;               /* where the search started */
+    short umonnum;              /* hero's form */
+    int squeeze;                /* cant_squeeze_thru(&g.youmonst) */
+    unsigned abilities;         /* travel_abilities() */
+    xchar travel[COLNO][ROWNO]; /* search radius when reached; 0: not */
+    xchar from[COLNO][ROWNO];   /* 1 + direction in which it was reached */
+    unsigned short terrain[COLNO][ROWNO]; /* travel_terrain() */
+    unsigned long vischk[COLNO]; /* spots whose visibility was looked at */
+    unsigned long visval[COLNO]; /* and what was found */
+};
+static long travelcache_clock = 0L;
+
+/* the parts of the hero's state which test_move() looks at */
+static unsigned
+travel_abilities()
+{
+    unsigned abil = 0;
+    struct obj *obj;
+
+    if (Passes_walls)
+        abil |= 0x001;
+    if (can_ooze(&g.youmonst))
+        abil |= 0x002;
+    if (Underwater)
+        abil |= 0x004;
+    if (Levitation)
+        abil |= 0x008;
+    if (Flying)
+        abil |= 0x010;
+    if (Blind)
+        abil |= 0x020;
+    if (Sokoban)
+        abil |= 0x040;
+    if (carrying(PICK_AXE) || carrying(DWARVISH_MATTOCK)
+        || ((obj = carrying(WAN_DIGGING)) != 0
+            && !objects[obj->otyp].oc_name_known))
+        abil |= 0x080;
+    if (flags.autodig && !g.context.run && !g.context.nopick && uwep
+        && is_pick(uwep))
+        abil |= 0x100;
+    if (g.context.run == 8)
+        abil |= 0x200;
+    return abil;
+}
+
+/* summarize the parts of the map which test_move() looks at */
+static void
+travel_terrain(terrain)
+unsigned short terrain[COLNO][ROWNO];
+{
+    unsigned long trapmap[COLNO];
+    struct trap *t;
+    struct rm *lev;
+    int x, y;
+
+    (void) memset((genericptr_t) trapmap, 0, sizeof trapmap);
+    for (t = g.ftrap; t; t = t->ntrap)
+        if (t->tseen)
+            trapmap[t->tx] |= 1UL << t->ty;
+
+    for (x = 0; x < COLNO; x++)
+        for (y = 0; y < ROWNO; y++) {
+            if (!isok(x, y)) {
+                terrain[x][y] = 0;
+                continue;
+            }
+            lev = &levl[x][y];
+            terrain[x][y] = (unsigned short) ((lev->typ & 0x3f)
+                                              | ((lev->flags & 0x1f) << 6));
+            if (lev->seenv && is_pool_or_lava(x, y))
+                terrain[x][y] |= 0x800;
+            if ((trapmap[x] >> y) & 1UL)
+                terrain[x][y] |= 0x1000;
+        }
+}
+
+/* can a search from here be reused, or saved for reuse? */
+static boolean
+travel_cacheable()
+{
+    struct trap *t;
+    struct monst *mtmp;
+
+#ifdef DEBUG
+    if (iflags.trav_debug)
+        return FALSE; /* show the search every time */
+#endif
+    /* test_move() doesn't avoid a trap or water at the hero's own spot,
+       and block_door() and block_entry() depend on the hero being in a
+       shop; a search made then would only be right for this spot */
+    if ((t = t_at(u.ux, u.uy)) != 0 && t->tseen)
+        return FALSE;
+    if (is_pool_or_lava(u.ux, u.uy) && levl[u.ux][u.uy].seenv)
+        return FALSE;
+    if (*u.ushops || (IS_DOOR(levl[u.ux][u.uy].typ)
+                      && levl[u.ux][u.uy].doormask == D_BROKEN))
+        return FALSE;
+    /* worm_cross() depends on where long worms are */
+    for (mtmp = fmon; mtmp; mtmp = mtmp->nmon)
+        if (mtmp->wormno && !DEADMONSTER(mtmp))
+            return FALSE;
+    return TRUE;
+}
+
+/* return a full search starting at tx,ty, made now or earlier */
+static struct travel_cache *
+travel_cached(tx, ty)
+int tx, ty;
+{
+    unsigned short terrain[COLNO][ROWNO];
+    struct travel_cache *tc, *oldest;
+    unsigned abil;
+    unsigned long bits;
+    short umonnum = u.umonnum;
+    int squeeze, i, x, y;
+
+    if (!travel_cacheable())
+        return (struct travel_cache *) 0;
+    if (!g.travelcache) {
+        g.travelcache = (struct travel_cache *) alloc(TRAVEL_CACHED
+                                                      * sizeof *tc);
+        (void) memset((genericptr_t) g.travelcache, 0,
+                      TRAVEL_CACHED * sizeof *tc);
+    }
+    abil = travel_abilities();
+    squeeze = cant_squeeze_thru(&g.youmonst);
+    travel_terrain(terrain);
+
+    oldest = &g.travelcache[0];
+    for (i = 0; i < TRAVEL_CACHED; i++) {
+        tc = &g.travelcache[i];
+        if (tc->used < oldest->used)
+            oldest = tc;
+        if (!tc->valid || tc->sx != tx || tc->sy != ty
+            || tc->gen != g.travel_gen || !on_level(&tc->uz, &u.uz)
+            || tc->umonnum != umonnum || tc->abilities != abil
+            || tc->squeeze != squeeze
+            || memcmp((genericptr_t) tc->terrain, (genericptr_t) terrain,
+                      sizeof terrain))
+            continue;
+        for (x = 0; x < COLNO; x++)
+            for (bits = tc->vischk[x], y = 0; bits; bits >>= 1, y++)
+                if ((bits & 1UL)
+                    && !(levl[x][y].seenv || (!Blind && couldsee(x, y)))
+                           != !((tc->visval[x] >> y) & 1UL))
+                    goto stale;
+        tc->used = ++travelcache_clock;
+        return tc;
+ stale:
+        tc->valid = FALSE;
+    }
+
+    tc = oldest;
+    tc->valid = TRUE;
+    assign_level(&tc->uz, &u.uz);
+    tc->gen = g.travel_gen;
+    tc->used = ++travelcache_clock;
+    tc->sx = tx, tc->sy = ty;
+    tc->umonnum = umonnum;
+    tc->abilities = abil;
+    tc->squeeze = squeeze;
+    (void) memcpy((genericptr_t) tc->terrain, (genericptr_t) terrain,
+                  sizeof terrain);
+    (void) memset((genericptr_t) tc->from, 0, sizeof tc->from);
+    (void) memset((genericptr_t) tc->vischk, 0, sizeof tc->vischk);
+    (void) memset((genericptr_t) tc->visval, 0, sizeof tc->visval);
+    (void) travel_search(TRAVP_TRAVEL, tx, ty, -1, -1, tc->travel, tc,
+                         (int *) 0, (int *) 0);
+    return tc;
+}
+
+/* release the saved searches */
+void
+free_travelcache()
+{
+    if (g.travelcache)
+        free((genericptr_t) g.travelcache), g.travelcache = 0;
+}
+
+/*
+ * Search outward from tx,ty, filling in 'travel'.  If ux,uy is reached
+ * for TRAVP_TRAVEL or TRAVP_VALID, stop and set *fx,*fy to the spot it
+ * was reached from.  When 'tc' is given, the whole level is searched
+ * and what the search found and looked at are recorded there.
+ */
+static boolean
+travel_search(mode, tx, ty, ux, uy, travel, tc, fx, fy)
+int mode, tx, ty, ux, uy;
+xchar travel[][ROWNO];
+struct travel_cache *tc;
+int *fx, *fy;
+{
+    xchar travelstepx[2][COLNO * ROWNO];
+    xchar travelstepy[2][COLNO * ROWNO];
+    int n = 1;      /* max offset in travelsteps */
+    int set = 0;    /* two sets current and previous */
+    int radius = 1; /* search radius */
+    int i;
+    boolean visible;
+
+    (void) memset((genericptr_t) travel, 0, COLNO * sizeof *travel);
+    travelstepx[0][0] = tx;
+    travelstepy[0][0] = ty;
+
+    while (n != 0) {
+        int nn = 0;
+
+        for (i = 0; i < n; i++) {
+            int dir;
+            int x = travelstepx[set][i];
+            int y = travelstepy[set][i];
+            static int ordered[] = { 0, 2, 4, 6, 1, 3, 5, 7 };
+            /* no diagonal movement for grid bugs */
+            int dirmax = NODIAG(u.umonnum) ? 4 : 8;
+            boolean alreadyrepeated = FALSE;
+
+            for (dir = 0; dir < dirmax; ++dir) {
+                int nx = x + xdir[ordered[dir]];
+                int ny = y + ydir[ordered[dir]];
+
+                /*
+                 * When guessing and trying to travel as close as possible
+                 * to an unreachable target space, don't include spaces
+                 * that would never be picked as a guessed target in the
+                 * travel matrix describing hero-reachable spaces.
+                 * This stops travel from getting confused and moving
+                 * the hero back and forth in certain degenerate
+                 * configurations of sight-blocking obstacles, e.g.
+                 *
+                 *  T         1. Dig this out and carry enough to not be
+                 *   ####       able to squeeze through diagonal gaps.
+                 *   #--.---    Stand at @ and target travel at space T.
+                 *    @.....
+                 *    |.....
+                 *
+                 *  T         2. couldsee() marks spaces marked a and x
+                 *   ####       as eligible guess spaces to move the hero
+                 *   a--.---    towards.  Space a is closest to T, so it
+                 *    @xxxxx    gets chosen.  Travel system moves @ right
+                 *    |xxxxx    to travel to space a.
+                 *
+                 *  T         3. couldsee() marks spaces marked b, c and x
+                 *   ####       as eligible guess spaces to move the hero
+                 *   a--c---    towards.  Since findtravelpath() is called
+                 *    b@xxxx    repeatedly during travel, it doesn't
+                 *    |xxxxx    remember that it wanted to go to space a,
+                 *              so in comparing spaces b and c, b is
+                 *              chosen, since it seems like the closest
+                 *              eligible space to T. Travel system moves @
+                 *              left to go to space b.
+                 *
+                 *            4. Go to 2.
+                 *
+                 * By limiting the travel matrix here, space a in the
+                 * example above is never included in it, preventing
+                 * the cycle.
+                 */
+                if (!isok(nx, ny)
+                    || ((mode == TRAVP_GUESS) && !couldsee(nx, ny)))
+                    continue;
+                if ((!Passes_walls && !can_ooze(&g.youmonst)
+                     && closed_door(x, y)) || sobj_at(BOULDER, x, y)
+                    || test_move(x, y, nx - x, ny - y, TEST_TRAP)) {
+                    /* closed doors and boulders usually
+                     * cause a delay, so prefer another path */
+                    if (travel[x][y] > radius - 3) {
+                        if (!alreadyrepeated) {
+                            travelstepx[1 - set][nn] = x;
+                            travelstepy[1 - set][nn] = y;
+                            /* don't change travel matrix! */
+                            nn++;
+                            alreadyrepeated = TRUE;
+                        }
+                        continue;
+                    }
+                }
+                if (!test_move(x, y, nx - x, ny - y, TEST_TRAV))
+                    continue;
+                visible = (levl[nx][ny].seenv
+                           || (!Blind && couldsee(nx, ny)));
+                if (tc) {
+                    tc->vischk[nx] |= 1UL << ny;
+                    if (visible)
+                        tc->visval[nx] |= 1UL << ny;
+                }
+                if (!visible)
+                    continue;
+                if (nx == ux && ny == uy) {
+                    if (mode == TRAVP_TRAVEL || mode == TRAVP_VALID) {
+                        *fx = x;
+                        *fy = y;
+                        return TRUE;
+                    }
+                } else if (!travel[nx][ny]) {
+                    travelstepx[1 - set][nn] = nx;
+                    travelstepy[1 - set][nn] = ny;
+                    travel[nx][ny] = radius;
+                    if (tc)
+                        tc->from[nx][ny] = ordered[dir] + 1;
+                    nn++;
+                }
+            }
+        }
+
+#ifdef DEBUG
+        if (iflags.trav_debug) {
+            /* Use of warning glyph is arbitrary. It stands out. */
+            tmp_at(DISP_ALL, warning_to_glyph(1));
+            for (i = 0; i < nn; ++i) {
+                tmp_at(travelstepx[1 - set][i], travelstepy[1 - set][i]);
+            }
+            delay_output();
+            if (flags.runmode == RUN_CRAWL) {
+                delay_output();
+                delay_output();
+            }
+            tmp_at(DISP_END, 0);
+        }
+#endif /* DEBUG */
+
+        n = nn;
+        set = 1 - set;
+        radius++;
+    }
+    return FALSE;
+}
+
 /*
  * Find a path from the destination (u.tx,u.ty) back to (u.ux,u.uy).
  * A shortest path is returned.  If guess is TRUE, consider various
@@ -969,13 +1324,10 @@ int mode;
     }
     if (u.tx != u.ux || u.ty != u.uy) {
         xchar travel[COLNO][ROWNO];
-        xchar travelstepx[2][COLNO * ROWNO];
-        xchar travelstepy[2][COLNO * ROWNO];
         xchar tx, ty, ux, uy;
-        int n = 1;      /* max offset in travelsteps */
-        int set = 0;    /* two sets current and previous */
-        int radius = 1; /* search radius */
-        int i;
+        struct travel_cache *tc;
+        int x, y, dir;
+        boolean reached;
 
         /* If guessing, first find an "obvious" goal location.  The obvious
          * goal is the position the player knows of, or might figure out
@@ -994,127 +1346,39 @@ int mode;
         }
 
  noguess:
-        (void) memset((genericptr_t) travel, 0, sizeof travel);
-        travelstepx[0][0] = tx;
-        travelstepy[0][0] = ty;
-
-        while (n != 0) {
-            int nn = 0;
-
-            for (i = 0; i < n; i++) {
-                int dir;
-                int x = travelstepx[set][i];
-                int y = travelstepy[set][i];
-                static int ordered[] = { 0, 2, 4, 6, 1, 3, 5, 7 };
-                /* no diagonal movement for grid bugs */
-                int dirmax = NODIAG(u.umonnum) ? 4 : 8;
-                boolean alreadyrepeated = FALSE;
-
-                for (dir = 0; dir < dirmax; ++dir) {
-                    int nx = x + xdir[ordered[dir]];
-                    int ny = y + ydir[ordered[dir]];
-
-                    /*
-                     * When guessing and trying to travel as close as possible
-                     * to an unreachable target space, don't include spaces
-                     * that would never be picked as a guessed target in the
-                     * travel matrix describing hero-reachable spaces.
-                     * This stops travel from getting confused and moving
-                     * the hero back and forth in certain degenerate
-                     * configurations of sight-blocking obstacles, e.g.
-                     *
-                     *  T         1. Dig this out and carry enough to not be
-                     *   ####       able to squeeze through diagonal gaps.
-                     *   #--.---    Stand at @ and target travel at space T.
-                     *    @.....
-                     *    |.....
-                     *
-                     *  T         2. couldsee() marks spaces marked a and x
-                     *   ####       as eligible guess spaces to move the hero
-                     *   a--.---    towards.  Space a is closest to T, so it
-                     *    @xxxxx    gets chosen.  Travel system moves @ right
-                     *    |xxxxx    to travel to space a.
-                     *
-                     *  T         3. couldsee() marks spaces marked b, c and x
-                     *   ####       as eligible guess spaces to move the hero
-                     *   a--c---    towards.  Since findtravelpath() is called
-                     *    b@xxxx    repeatedly during travel, it doesn't
-                     *    |xxxxx    remember that it wanted to go to space a,
-                     *              so in comparing spaces b and c, b is
-                     *              chosen, since it seems like the closest
-                     *              eligible space to T. Travel system moves @
-                     *              left to go to space b.
-                     *
-                     *            4. Go to 2.
-                     *
-                     * By limiting the travel matrix here, space a in the
-                     * example above is never included in it, preventing
-                     * the cycle.
-                     */
-                    if (!isok(nx, ny)
-                        || ((mode == TRAVP_GUESS) && !couldsee(nx, ny)))
-                        continue;
-                    if ((!Passes_walls && !can_ooze(&g.youmonst)
-                         && closed_door(x, y)) || sobj_at(BOULDER, x, y)
-                        || test_move(x, y, nx - x, ny - y, TEST_TRAP)) {
-                        /* closed doors and boulders usually
-                         * cause a delay, so prefer another path */
-                        if (travel[x][y] > radius - 3) {
-                            if (!alreadyrepeated) {
-                                travelstepx[1 - set][nn] = x;
-                                travelstepy[1 - set][nn] = y;
-                                /* don't change travel matrix! */
-                                nn++;
-                                alreadyrepeated = TRUE;
-                            }
-                            continue;
-                        }
-                    }
-                    if (test_move(x, y, nx - x, ny - y, TEST_TRAV)
-                        && (levl[nx][ny].seenv
-                            || (!Blind && couldsee(nx, ny)))) {
-                        if (nx == ux && ny == uy) {
-                            if (mode == TRAVP_TRAVEL || mode == TRAVP_VALID) {
-                                u.dx = x - ux;
-                                u.dy = y - uy;
-                                if (mode == TRAVP_TRAVEL
-                                    && x == u.tx && y == u.ty) {
-                                    nomul(0);
-                                    /* reset run so domove run checks work */
-                                    g.context.run = 8;
-                                    iflags.travelcc.x = iflags.travelcc.y = 0;
-                                }
-                                return TRUE;
-                            }
-                        } else if (!travel[nx][ny]) {
-                            travelstepx[1 - set][nn] = nx;
-                            travelstepy[1 - set][nn] = ny;
-                            travel[nx][ny] = radius;
-                            nn++;
-                        }
-                    }
-                }
+        /* the (uncached) search stops when it gets to ux,uy, which
+           is the spot that the cached search first reached it from */
+        if (mode != TRAVP_GUESS && (tc = travel_cached(tx, ty)) != 0) {
+            if ((reached = (tc->from[ux][uy] != 0)) != FALSE) {
+                dir = tc->from[ux][uy] - 1;
+                x = ux - xdir[dir];
+                y = uy - ydir[dir];
             }
+#ifdef EXTRA_SANITY_CHECKS
+            {
+                int cx = 0, cy = 0;
 
-#ifdef DEBUG
-            if (iflags.trav_debug) {
-                /* Use of warning glyph is arbitrary. It stands out. */
-                tmp_at(DISP_ALL, warning_to_glyph(1));
-                for (i = 0; i < nn; ++i) {
-                    tmp_at(travelstepx[1 - set][i], travelstepy[1 - set][i]);
-                }
-                delay_output();
-                if (flags.runmode == RUN_CRAWL) {
-                    delay_output();
-                    delay_output();
-                }
-                tmp_at(DISP_END, 0);
+                if (travel_search(mode, tx, ty, ux, uy, travel,
+                                  (struct travel_cache *) 0, &cx, &cy)
+                        != reached
+                    || (reached && (cx != x || cy != y)))
+                    impossible("findtravelpath: saved search is stale");
             }
-#endif /* DEBUG */
-
-            n = nn;
-            set = 1 - set;
-            radius++;
+#endif
+        } else {
+            reached = travel_search(mode, tx, ty, ux, uy, travel,
+                                  (struct travel_cache *) 0, &x, &y);
+        }
+        if (reached) {
+            u.dx = x - ux;
+            u.dy = y - uy;
+            if (mode == TRAVP_TRAVEL && x == u.tx && y == u.ty) {
+                nomul(0);
+                /* reset run so domove run checks work */
+                g.context.run = 8;
+                iflags.travelcc.x = iflags.travelcc.y = 0;
+            }
+            return TRUE;
         }
 
         /* if guessing, find best location in travel matrix and go there */
@@ -1171,8 +1435,6 @@ int mode;
             ty = py;
             ux = u.ux;
             uy = u.uy;
-            set = 0;
-            n = radius = 1;
             mode = TRAVP_TRAVEL;
             goto noguess;
         }
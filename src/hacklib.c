@@ -72,6 +72,10 @@
         void            strbuf_empty    (strbuf *)
         void            strbuf_nl_to_crlf (strbuf_t *)
         char *          nonconst        (const char *, char *)
+        void            idmap_set       (idmap_t *, unsigned, anything *)
+        anything *      idmap_get       (idmap_t *, unsigned)
+        void            idmap_remove    (idmap_t *, unsigned)
+        void            idmap_free      (idmap_t *)
 =*/
 #ifdef LINT
 #define Static /* pacify lint */
@@ -963,7 +967,9 @@ void
 init_random(fn)
 int FDECL((*fn), (int));
 {
-    set_random(sys_random_seed(), fn);
+    /* a fixed seed makes the game reproducible, for replaying or
+       for programs driving it */
+    set_random(fixed_rngseed ? fixed_rngseed : sys_random_seed(), fn);
 }
 
 /* Reshuffles the random number generator. */
@@ -989,7 +995,7 @@ getnow()
 static struct tm *
 getlt()
 {
-    time_t date = getnow();
+    time_t date = fixed_gametime ? fixed_gametime : getnow();
 
     return localtime((LOCALTIME_type) &date);
 }
@@ -1290,4 +1296,113 @@ char *buf;
     return retval;
 }
 
+/* ids are handed out sequentially, so multiplicative hashing spreads
+   them evenly over the table */
+#define idmap_home(id, mask) (((id) * 2654435761U) & (mask))
+
+/* slot where id is (or would be) stored; map must have at least one
+   empty slot, so the probe always terminates */
+static struct idmap_entry *
+idmap_slot(map, id)
+idmap_t *map;
+unsigned id;
+{
+    unsigned mask = (unsigned) map->size - 1, i = idmap_home(id, mask);
+
+    while (map->tab[i].id && map->tab[i].id != id)
+        i = (i + 1) & mask;
+    return &map->tab[i];
+}
+
+/* add or replace the entry for id; id 0 can't be stored */
+void
+idmap_set(map, id, val)
+idmap_t *map;
+unsigned id;
+anything *val;
+{
+    struct idmap_entry *e;
+
+    if (!id)
+        return;
+    if (2 * (map->count + 1) > map->size) {
+        struct idmap_entry *oldtab = map->tab;
+        int i, oldsize = map->size;
+
+        map->size = oldsize ? 2 * oldsize : 256;
+        map->tab = (struct idmap_entry *) alloc((unsigned) map->size
+                                                * sizeof *map->tab);
+        (void) memset((genericptr_t) map->tab, 0,
+                      (size_t) map->size * sizeof *map->tab);
+        for (i = 0; i < oldsize; i++)
+            if (oldtab[i].id)
+                *idmap_slot(map, oldtab[i].id) = oldtab[i];
+        if (oldtab)
+            free((genericptr_t) oldtab);
+    }
+    e = idmap_slot(map, id);
+    if (!e->id) {
+        e->id = id;
+        map->count++;
+    }
+    e->val = *val;
+}
+
+/* return the value stored for id, or Null if there isn't one */
+anything *
+idmap_get(map, id)
+idmap_t *map;
+unsigned id;
+{
+    struct idmap_entry *e;
+
+    if (!id || !map->count)
+        return (anything *) 0;
+    e = idmap_slot(map, id);
+    return e->id ? &e->val : (anything *) 0;
+}
+
+/* delete the entry for id, if any; later entries of the same probe
+   sequence are shifted back so that no tombstones are needed */
+void
+idmap_remove(map, id)
+idmap_t *map;
+unsigned id;
+{
+    struct idmap_entry *e;
+    unsigned mask, i, j, k;
+
+    if (!id || !map->count)
+        return;
+    e = idmap_slot(map, id);
+    if (!e->id)
+        return;
+    mask = (unsigned) map->size - 1;
+    i = j = (unsigned) (e - map->tab);
+    for (;;) {
+        j = (j + 1) & mask;
+        if (!map->tab[j].id)
+            break;
+        k = idmap_home(map->tab[j].id, mask);
+        /* entry at j can stay put if its home slot k is cyclically
+           within (i,j] */
+        if ((i <= j) ? (i < k && k <= j) : (i < k || k <= j))
+            continue;
+        map->tab[i] = map->tab[j];
+        i = j;
+    }
+    map->tab[i].id = 0;
+    map->count--;
+}
+
+void
+idmap_free(map)
+idmap_t *map;
+{
+    if (map->tab)
+        free((genericptr_t) map->tab);
+    map->tab = (struct idmap_entry *) 0;
+    map->size = map->count = 0;
+}
+
 /*hacklib.c*/
@@ -805,7 +805,7 @@ addinv_core1(obj)
 struct obj *obj;
 {
     if (obj->oclass == COIN_CLASS) {
-        g.context.botl = 1;
+        status_dirty(BL_GOLD);
     } else if (obj->otyp == AMULET_OF_YENDOR) {
         if (u.uhave.amulet)
             impossible("already have amulet?");
@@ -1069,6 +1069,8 @@ register struct obj *obj;
         obj->in_use = FALSE; /* no longer in use */
         obj->quan--;
         obj->owt = weight(obj);
+        if (obj->oclass == COIN_CLASS)
+            status_dirty(BL_GOLD);
         update_inventory();
     } else {
         useupall(obj);
@@ -1100,7 +1102,7 @@ freeinv_core(obj)
 struct obj *obj;
 {
     if (obj->oclass == COIN_CLASS) {
-        g.context.botl = 1;
+        status_dirty(BL_GOLD);
         return;
     } else if (obj->otyp == AMULET_OF_YENDOR) {
         if (!u.uhave.amulet)
@@ -7,8 +7,8 @@
 /*
  * Mobile light sources.
  *
- * This implementation minimizes memory at the expense of extra
- * recalculations.
+ * Each light source caches the locations it lights, so that
+ * recalculation is only needed when something relevant changes.
  *
  * Light sources are "things" that have a physical position and range.
  * They have a type, which gives us information about them.  Currently
@@ -24,12 +24,12 @@
  * The major working function is do_light_sources(). It is called
  * when the vision system is recreating its "could see" array.  Here
  * we add a flag (TEMP_LIT) to the array for all locations that are lit
- * via a light source.  The bad part of this is that we have to
- * re-calculate the LOS of each light source every time the vision
- * system runs.  Even if the light sources and any topology (vision blocking
- * positions) have not changed.  The good part is that no extra memory
- * is used, plus we don't have to figure out how far the sources have moved,
- * or if the topology has changed.
+ * via a light source.  The lit area of a source which isn't at the
+ * hero's position is computed with the vision system's view_from() and
+ * kept in a bitmap (one row mask per row within range).  It is thrown
+ * away when the source moves, when its range changes, or when
+ * block_point() or unblock_point() change a location within range
+ * (see clear_light_cache()), and rebuilt on the next vision pass.
  *
  * The structure of the save/restore mechanism is amazingly similar to
  * the timer save/restore.  This is because they both have the same
@@ -40,7 +40,13 @@
 /* flags */
 #define LSF_SHOW 0x1        /* display the light source */
 #define LSF_NEEDS_FIXUP 0x2 /* need oid fixup */
+#define LSF_LITMAP 0x4      /* litmap is up to date */
 
+/* rows in a litmap; enough for any range */
+#define LS_MAPROWS (2 * MAX_RADIUS + 1)
+
+static void FDECL(mark_lit, (int, int, genericptr_t));
+static void FDECL(free_ls, (light_source *));
 static void FDECL(write_ls, (NHFILE *, light_source *));
 static int FDECL(maybe_write_ls, (NHFILE *, int, BOOLEAN_P));
 
@@ -72,6 +78,7 @@ new_light_source(x, y, range, type, id)
     ls->type = type;
     ls->id = *id;
     ls->flags = 0;
+    ls->litmap = (unsigned long *) 0;
     g.light_base = ls;
 
     g.vision_full_recalc = 1; /* make the source show up */
@@ -115,7 +122,7 @@ anything *id;
             else
                 g.light_base = curr->next;
 
-            free((genericptr_t) curr);
+            free_ls(curr);
             g.vision_full_recalc = 1;
             return;
         }
@@ -124,6 +131,43 @@ anything *id;
                fmt_ptr((genericptr_t) id->a_obj));
 }
 
+static void
+free_ls(ls)
+light_source *ls;
+{
+    if (ls->litmap)
+        free((genericptr_t) ls->litmap);
+    free((genericptr_t) ls);
+}
+
+/* do_clear_area() callback for building a light source's litmap */
+static void
+mark_lit(x, y, arg)
+int x, y;
+genericptr_t arg;
+{
+    light_source *ls = (light_source *) arg;
+
+    ls->litmap[y - ls->y + ls->range] |= 1UL << (x - ls->x + ls->range);
+}
+
+/*
+ * Location <x,y> has become blocked or unblocked; discard the cached
+ * lit area of every light source that has it within range.  Negative
+ * x discards all of them (the level's topology was rebuilt).
+ */
+void
+clear_light_cache(x, y)
+int x, y;
+{
+    light_source *ls;
+
+    for (ls = g.light_base; ls; ls = ls->next)
+        if (x < 0 || (abs(x - ls->x) <= ls->range
+                      && abs(y - ls->y) <= ls->range))
+            ls->flags &= ~LSF_LITMAP;
+}
+
 /* Mark locations that are temporarily lit via mobile light sources. */
 void
 do_light_sources(cs_rows)
@@ -134,16 +178,14 @@ char **cs_rows;
     short at_hero_range = 0;
     light_source *ls;
     char *row;
+    xchar oldx, oldy;
+    unsigned long bits;
 
     for (ls = g.light_base; ls; ls = ls->next) {
         ls->flags &= ~LSF_SHOW;
 
-        /*
-         * Check for moved light sources.  It may be possible to
-         * save some effort if an object has not moved, but not in
-         * the current setup -- we need to recalculate for every
-         * vision recalc.
-         */
+        /* Check for moved light sources. */
+        oldx = ls->x, oldy = ls->y;
         if (ls->type == LS_OBJECT) {
             if (get_obj_location(ls->id.a_obj, &ls->x, &ls->y, 0))
                 ls->flags |= LSF_SHOW;
@@ -151,6 +193,8 @@ char **cs_rows;
             if (get_mon_location(ls->id.a_monst, &ls->x, &ls->y, 0))
                 ls->flags |= LSF_SHOW;
         }
+        if (ls->x != oldx || ls->y != oldy)
+            ls->flags &= ~LSF_LITMAP;
 
         /* minor optimization: don't bother with duplicate light sources
            at hero */
@@ -161,19 +205,21 @@ char **cs_rows;
                 at_hero_range = ls->range;
         }
 
-        if (ls->flags & LSF_SHOW) {
+        if (!(ls->flags & LSF_SHOW))
+            continue;
+
+        if ((max_y = (ls->y + ls->range)) >= ROWNO)
+            max_y = ROWNO - 1;
+        if ((y = (ls->y - ls->range)) < 0)
+            y = 0;
+
+        if (ls->x == u.ux && ls->y == u.uy) {
             /*
-             * Walk the points in the circle and see if they are
-             * visible from the center.  If so, mark'em.
-             *
-             * Kevin's tests indicated that doing this brute-force
-             * method is faster for radius <= 3 (or so).
+             * If the light source is located at the hero, then
+             * we can use the COULD_SEE bits already calculated
+             * by the vision system.
              */
             limits = circle_ptr(ls->range);
-            if ((max_y = (ls->y + ls->range)) >= ROWNO)
-                max_y = ROWNO - 1;
-            if ((y = (ls->y - ls->range)) < 0)
-                y = 0;
             for (; y <= max_y; y++) {
                 row = cs_rows[y];
                 offset = limits[abs(y - ls->y)];
@@ -181,28 +227,34 @@ char **cs_rows;
                     min_x = 0;
                 if ((max_x = (ls->x + offset)) >= COLNO)
                     max_x = COLNO - 1;
-
-                if (ls->x == u.ux && ls->y == u.uy) {
-                    /*
-                     * If the light source is located at the hero, then
-                     * we can use the COULD_SEE bits already calculated
-                     * by the vision system.  More importantly than
-                     * this optimization, is that it allows the vision
-                     * system to correct problems with clear_path().
-                     * The function clear_path() is a simple LOS
-                     * path checker that doesn't go out of its way to
-                     * make things look "correct".  The vision system
-                     * does this.
-                     */
-                    for (x = min_x; x <= max_x; x++)
-                        if (row[x] & COULD_SEE)
-                            row[x] |= TEMP_LIT;
-                } else {
-                    for (x = min_x; x <= max_x; x++)
-                        if ((ls->x == x && ls->y == y)
-                            || clear_path((int) ls->x, (int) ls->y, x, y))
-                            row[x] |= TEMP_LIT;
-                }
+                for (x = min_x; x <= max_x; x++)
+                    if (row[x] & COULD_SEE)
+                        row[x] |= TEMP_LIT;
+            }
+        } else {
+            /*
+             * Otherwise let the vision system work out what can be
+             * seen from the source (which also gets the same results
+             * as for the hero, rather than those of clear_path()),
+             * unless that's still known from a previous pass.
+             */
+            if (!(ls->flags & LSF_LITMAP)) {
+                if (!ls->litmap)
+                    ls->litmap = (unsigned long *) alloc(
+                                        LS_MAPROWS * sizeof *ls->litmap);
+                (void) memset((genericptr_t) ls->litmap, 0,
+                              LS_MAPROWS * sizeof *ls->litmap);
+                do_clear_area(ls->x, ls->y, ls->range, mark_lit,
+                              (genericptr_t) ls);
+                ls->flags |= LSF_LITMAP;
+            }
+            for (; y <= max_y; y++) {
+                row = cs_rows[y];
+                x = ls->x - ls->range;
+                for (bits = ls->litmap[y - ls->y + ls->range]; bits;
+                     bits >>= 1, x++)
+                    if (bits & 1UL)
+                        row[x] |= TEMP_LIT;
             }
         }
     }
@@ -290,10 +342,21 @@ find_mid(nid, fmflags)
 unsigned nid;
 unsigned fmflags;
 {
+    anything *val;
     struct monst *mtmp;
 
     if (!nid)
         return &g.youmonst;
+    /* registered monster which is on the map must be on fmon; anything
+       else (steed, or monster on migrating_mons or mydogs) is rare
+       enough that it's not worth tracking which list it's on */
+    if ((val = idmap_get(&g.mid_map, nid)) == 0)
+        return (struct monst *) 0;
+    mtmp = val->a_monst;
+    if ((fmflags & FM_FMON) && mtmp->m_id == nid && !DEADMONSTER(mtmp)
+        && mon_is_local(mtmp) && isok(mtmp->mx, mtmp->my)
+        && g.level.monsters[mtmp->mx][mtmp->my] == mtmp)
+        return mtmp;
     if (fmflags & FM_FMON)
         for (mtmp = fmon; mtmp; mtmp = mtmp->nmon)
             if (!DEADMONSTER(mtmp) && mtmp->m_id == nid)
@@ -351,7 +414,7 @@ int range;
             /* if global and not doing local, or vice versa, remove it */
             if (is_global ^ (range == RANGE_LEVEL)) {
                 *prev = curr->next;
-                free((genericptr_t) curr);
+                free_ls(curr);
             } else {
                 prev = &(*prev)->next;
             }
@@ -378,6 +441,8 @@ NHFILE *nhfp;
         ls = (light_source *) alloc(sizeof(light_source));
         if (nhfp->structlevel)
             mread(nhfp->fd, (genericptr_t) ls, sizeof(light_source));
+        ls->litmap = (unsigned long *) 0;
+        ls->flags &= ~LSF_LITMAP;
         ls->next = g.light_base;
         g.light_base = ls;
     }
@@ -397,6 +462,8 @@ long *count, *size;
     for (ls = g.light_base; ls; ls = ls->next) {
         ++*count;
         *size += (long) sizeof *ls;
+        if (ls->litmap)
+            *size += (long) (LS_MAPROWS * sizeof *ls->litmap);
     }
 }
 
@@ -642,10 +709,13 @@ struct obj *src, *dest;
              */
             new_ls = (light_source *) alloc(sizeof(light_source));
             *new_ls = *ls;
+            new_ls->litmap = (unsigned long *) 0;
+            new_ls->flags &= ~LSF_LITMAP;
             if (Is_candle(src)) {
                 /* split candles may emit less light than original group */
                 ls->range = candle_light_range(src);
                 new_ls->range = candle_light_range(dest);
+                ls->flags &= ~LSF_LITMAP;
                 g.vision_full_recalc = 1; /* in case range changed */
             }
             new_ls->id.a_obj = dest;
@@ -670,6 +740,7 @@ struct obj *src, *dest;
     for (ls = g.light_base; ls; ls = ls->next)
         if (ls->type == LS_OBJECT && ls->id.a_obj == dest) {
             ls->range = candle_light_range(dest);
+            ls->flags &= ~LSF_LITMAP;
             g.vision_full_recalc = 1; /* in case range changed */
             break;
         }
@@ -685,8 +756,10 @@ int new_radius;
 
     for (ls = g.light_base; ls; ls = ls->next)
         if (ls->type == LS_OBJECT && ls->id.a_obj == obj) {
-            if (new_radius != ls->range)
+            if (new_radius != ls->range) {
+                ls->flags &= ~LSF_LITMAP;
                 g.vision_full_recalc = 1;
+            }
             ls->range = new_radius;
             return;
         }
@@ -837,6 +837,7 @@ xchar x, y; /* clone's preferred location or 0 (near mon) */
     m2->m_id = g.context.ident++;
     if (!m2->m_id)
         m2->m_id = g.context.ident++; /* ident overflowed */
+    register_mid(m2);
     m2->mx = mm.x;
     m2->my = mm.y;
 
@@ -1018,7 +1019,7 @@ newmextra()
 {
     struct mextra *mextra;
 
-    mextra = (struct mextra *) alloc(sizeof(struct mextra));
+    mextra = (struct mextra *) pool_alloc(&mextra_pool);
     mextra->mname = 0;
     mextra->egd = 0;
     mextra->epri = 0;
@@ -1202,6 +1203,7 @@ int mmflags;
     mtmp->m_id = g.context.ident++;
     if (!mtmp->m_id)
         mtmp->m_id = g.context.ident++; /* ident overflowed */
+    register_mid(mtmp);
     set_mon_data(mtmp, ptr); /* mtmp->data = ptr; */
     if (ptr->msound == MS_LEADER && quest_info(MS_LEADER) == mndx)
         g.quest_status.leader_m_id = mtmp->m_id;
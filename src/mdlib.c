@@ -126,7 +126,7 @@ static struct win_info window_opts[] = {
 /*
  * Use this to explicitly mask out features during version checks.
  *
- * ZEROCOMP, RLECOMP, and ZLIB_COMP describe compression features
+ * ZEROCOMP, RLECOMP, LZCOMP, and ZLIB_COMP describe compression features
  * that the port/plaform which wrote the savefile was capable of
  * dealing with. Don't reject a savefile just because the port
  * reading the savefile doesn't match on all/some of them.
@@ -142,6 +142,7 @@ static struct win_info window_opts[] = {
     (0L | (1L << 19) /* SCORE_ON_BOTL */ \
      | (1L << 27)    /* ZEROCOMP */      \
      | (1L << 28)    /* RLECOMP */       \
+     | (1L << 29)    /* LZCOMP */        \
      )
 #endif /* MD_IGNORED_FEATUES */
 
@@ -189,6 +190,9 @@ make_version()
 #endif
 #ifdef RLECOMP
                                            | (1L << 28)
+#endif
+#ifdef LZCOMP
+                                           | (1L << 29)
 #endif
                                                );
     /*
@@ -407,6 +411,9 @@ static const char *build_opts[] = {
 #ifdef MFLOPPY
     "floppy drive support",
 #endif
+#ifdef RECORD_INPUT
+    "input recording for replays",
+#endif
 #ifdef INSURANCE
     "insurance files for recovering from crashes",
 #endif
@@ -425,6 +432,9 @@ static const char *build_opts[] = {
 #if defined(GNUDOS) || defined(__DJGPP__)
     "MSDOS protected mode",
 #endif
+#ifdef PERF_STATS
+    "moveloop phase timing",
+#endif
 #ifdef NEWS
     "news file",
 #endif
@@ -533,6 +543,9 @@ static const char *build_opts[] = {
 #ifdef RLECOMP
     "run-length compression of map in save files",
 #endif
+#ifdef LZCOMP
+    "built-in compression of save files",
+#endif
 #ifdef SYSCF
     "system configuration at run-time",
 #endif
@@ -12,7 +12,7 @@ struct monst *mtmp;
     if (!mtmp->mextra)
         mtmp->mextra = newmextra();
     if (!EMIN(mtmp)) {
-        EMIN(mtmp) = (struct emin *) alloc(sizeof(struct emin));
+        EMIN(mtmp) = (struct emin *) pool_alloc(&emin_pool);
         (void) memset((genericptr_t) EMIN(mtmp), 0, sizeof(struct emin));
     }
 }
@@ -22,7 +22,7 @@ free_emin(mtmp)
 struct monst *mtmp;
 {
     if (mtmp->mextra && EMIN(mtmp)) {
-        free((genericptr_t) EMIN(mtmp));
+        pool_free(&emin_pool, (genericptr_t) EMIN(mtmp));
         EMIN(mtmp) = (struct emin *) 0;
     }
     mtmp->isminion = 0;
@@ -605,6 +605,8 @@ clear_level_structures()
              */
             g.level.objects[x][y] = (struct obj *) 0;
             g.level.monsters[x][y] = (struct monst *) 0;
+            g.level.traps[x][y] = (struct trap *) 0;
+            g.level.engravings[x][y] = (struct engr *) 0;
         }
     }
     g.level.objlist = (struct obj *) 0;
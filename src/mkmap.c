@@ -8,12 +8,44 @@
 #define HEIGHT (ROWNO - 1)
 #define WIDTH (COLNO - 2)
 
+/*
+ * The cellular automaton passes work on a bitmap of the map rather than
+ * on levl[][] itself:  one unsigned long per column, with bit y set when
+ * that spot is fg_typ.  Spots outside the area which the passes look at
+ * are left clear, so count as bg_typ.  The neighbors of every spot in a
+ * column are counted at once by adding up shifted copies of the three
+ * columns involved; cnt[k] ends up holding bit k of each spot's count.
+ */
+#if ROWNO > 32
+#error "mkmap's cave bitmap needs an unsigned long to hold a column"
+#endif
+/* rows 1 through HEIGHT-1, the ones the passes may change */
+#define CAVE_ROWS (((1UL << HEIGHT) - 1UL) & ~1UL)
+
+/* one span of a flood fill; see flood_fill_rm() */
+struct ffill_span {
+    int sx, sy; /* leftmost spot of the span */
+    int nx;     /* just past its rightmost spot */
+    int dy;     /* neighboring row being examined, -1 then +1 */
+    int i;      /* spot of that row being examined */
+    int step;   /* 0: i itself, 1: i's left side, 2: i's right side */
+};
+
 static void FDECL(init_map, (SCHAR_P));
 static void FDECL(init_fill, (SCHAR_P, SCHAR_P));
-static schar FDECL(get_map, (int, int, SCHAR_P));
-static void FDECL(pass_one, (SCHAR_P, SCHAR_P));
-static void FDECL(pass_two, (SCHAR_P, SCHAR_P));
-static void FDECL(pass_three, (SCHAR_P, SCHAR_P));
+static void FDECL(cave_load, (unsigned long *, SCHAR_P));
+static void FDECL(cave_store, (unsigned long *, SCHAR_P, SCHAR_P));
+static void FDECL(cave_add, (unsigned long *, unsigned long));
+static void FDECL(cave_count, (unsigned long *, unsigned long, unsigned long,
+                               unsigned long, BOOLEAN_P));
+static void FDECL(pass_one, (unsigned long *));
+static void FDECL(pass_two, (unsigned long *));
+static void FDECL(pass_three, (unsigned long *));
+#ifdef EXTRA_SANITY_CHECKS
+static void FDECL(cave_check, (int, unsigned long *, unsigned long *));
+#endif
+static void FDECL(ffill_span, (struct ffill_span *, int, int, int,
+                               BOOLEAN_P, BOOLEAN_P, SCHAR_P));
 static void NDECL(wallify_map);
 static void FDECL(join_map, (SCHAR_P, SCHAR_P));
 static void FDECL(finish_map,
@@ -53,118 +85,189 @@ schar bg_typ, fg_typ;
     }
 }
 
-static schar
-get_map(col, row, bg_typ)
-int col, row;
-schar bg_typ;
+/* set up the bitmap from the part of the map the passes can see */
+static void
+cave_load(cave, fg_typ)
+unsigned long *cave;
+schar fg_typ;
 {
-    if (col <= 0 || row < 0 || col > WIDTH || row >= HEIGHT)
-        return bg_typ;
-    return levl[col][row].typ;
-}
+    int i, j;
 
-static const int dirs[16] = { -1, -1 /**/, -1, 0 /**/,  -1, 1 /**/, 0, -1 /**/,
-                               0,  1 /**/,  1,  -1 /**/, 1,  0 /**/, 1, 1 };
+    (void) memset((genericptr_t) cave, 0, COLNO * sizeof *cave);
+    for (i = 1; i <= WIDTH; i++)
+        for (j = 0; j < HEIGHT; j++)
+            if (levl[i][j].typ == fg_typ)
+                cave[i] |= 1UL << j;
+}
 
+/* copy the result back to the part of the map the passes can change */
 static void
-pass_one(bg_typ, fg_typ)
+cave_store(cave, bg_typ, fg_typ)
+unsigned long *cave;
 schar bg_typ, fg_typ;
 {
-    register int i, j;
-    short count, dr;
+    int i, j;
 
     for (i = 2; i <= WIDTH; i++)
-        for (j = 1; j < HEIGHT; j++) {
-            for (count = 0, dr = 0; dr < 8; dr++)
-                if (get_map(i + dirs[dr * 2], j + dirs[(dr * 2) + 1], bg_typ)
-                    == fg_typ)
-                    count++;
+        for (j = 1; j < HEIGHT; j++)
+            levl[i][j].typ = ((cave[i] >> j) & 1UL) ? fg_typ : bg_typ;
+}
 
-            switch (count) {
-            case 0: /* death */
-            case 1:
-            case 2:
-                levl[i][j].typ = bg_typ;
-                break;
-            case 5:
-            case 6:
-            case 7:
-            case 8:
-                levl[i][j].typ = fg_typ;
-                break;
-            default:
-                break;
-            }
-        }
+/* add one neighbor's worth of bits to the counts */
+static void
+cave_add(cnt, bits)
+unsigned long *cnt;
+unsigned long bits;
+{
+    unsigned long carry;
+    int k;
+
+    for (k = 0; k < 4 && bits; k++) {
+        carry = cnt[k] & bits;
+        cnt[k] ^= bits;
+        bits = carry;
+    }
 }
 
-#define new_loc(i, j) *(g.new_locations + ((j) * (WIDTH + 1)) + (i))
+/* count the fg_typ neighbors of each spot in the column 'here', between
+   columns 'left' and 'right'; the spot above (row y-1) is only counted
+   if 'above' is set */
+static void
+cave_count(cnt, left, here, right, above)
+unsigned long *cnt;
+unsigned long left, here, right;
+boolean above;
+{
+    cnt[0] = cnt[1] = cnt[2] = cnt[3] = 0UL;
+    /* a neighbor in row y-1 lands on bit y when shifted left, and one
+       in row y+1 when shifted right */
+    cave_add(cnt, left << 1);
+    cave_add(cnt, left);
+    cave_add(cnt, left >> 1);
+    cave_add(cnt, right << 1);
+    cave_add(cnt, right);
+    cave_add(cnt, right >> 1);
+    cave_add(cnt, here >> 1);
+    if (above)
+        cave_add(cnt, here << 1);
+}
 
+/*
+ * Spots with two or fewer fg_typ neighbors become bg_typ, those with five
+ * or more become fg_typ.  This pass updates the map as it goes, so each
+ * spot sees the new values of the column to its left and of the spot
+ * above it; the latter has to be dealt with a spot at a time.
+ */
 static void
-pass_two(bg_typ, fg_typ)
-schar bg_typ, fg_typ;
+pass_one(cave)
+unsigned long *cave;
 {
-    register int i, j;
-    short count, dr;
+    unsigned long cnt[4], here, bit;
+    int i, j, count;
 
-    for (i = 2; i <= WIDTH; i++)
+    for (i = 2; i <= WIDTH; i++) {
+        cave_count(cnt, cave[i - 1], cave[i], cave[i + 1], FALSE);
+        here = cave[i];
         for (j = 1; j < HEIGHT; j++) {
-            for (count = 0, dr = 0; dr < 8; dr++)
-                if (get_map(i + dirs[dr * 2], j + dirs[(dr * 2) + 1], bg_typ)
-                    == fg_typ)
-                    count++;
-            if (count == 5)
-                new_loc(i, j) = bg_typ;
-            else
-                new_loc(i, j) = get_map(i, j, bg_typ);
+            bit = 1UL << j;
+            count = ((cnt[0] & bit) ? 1 : 0) + ((cnt[1] & bit) ? 2 : 0)
+                    + ((cnt[2] & bit) ? 4 : 0) + ((here & (bit >> 1)) ? 1 : 0);
+            if (count <= 2) /* death */
+                here &= ~bit;
+            else if (count >= 5)
+                here |= bit;
         }
+        cave[i] = here;
+    }
+}
 
+/* spots with exactly five fg_typ neighbors become bg_typ */
+static void
+pass_two(cave)
+unsigned long *cave;
+{
+    unsigned long newcave[COLNO], cnt[4];
+    int i;
+
+    for (i = 2; i <= WIDTH; i++) {
+        cave_count(cnt, cave[i - 1], cave[i], cave[i + 1], TRUE);
+        newcave[i] = cave[i]
+                     & ~(cnt[0] & ~cnt[1] & cnt[2] & ~cnt[3] & CAVE_ROWS);
+    }
     for (i = 2; i <= WIDTH; i++)
-        for (j = 1; j < HEIGHT; j++)
-            levl[i][j].typ = new_loc(i, j);
+        cave[i] = newcave[i];
 }
 
+/* spots with fewer than three fg_typ neighbors become bg_typ */
 static void
-pass_three(bg_typ, fg_typ)
-schar bg_typ, fg_typ;
+pass_three(cave)
+unsigned long *cave;
 {
-    register int i, j;
-    short count, dr;
+    unsigned long newcave[COLNO], cnt[4];
+    int i;
+
+    for (i = 2; i <= WIDTH; i++) {
+        cave_count(cnt, cave[i - 1], cave[i], cave[i + 1], TRUE);
+        newcave[i] = cave[i]
+                     & ~(~cnt[3] & ~cnt[2] & ~(cnt[1] & cnt[0]) & CAVE_ROWS);
+    }
+    for (i = 2; i <= WIDTH; i++)
+        cave[i] = newcave[i];
+}
+
+#ifdef EXTRA_SANITY_CHECKS
+/* redo a pass the slow way, a spot and a neighbor at a time, and
+   complain if the bitmap version came up with something different */
+static void
+cave_check(pass, before, after)
+int pass;
+unsigned long *before, *after;
+{
+    static const int dirs[16] = { -1, -1, -1, 0, -1, 1, 0, -1,
+                                  0, 1, 1, -1, 1, 0, 1, 1 };
+    char map[COLNO][ROWNO], newmap[COLNO][ROWNO];
+    int i, j, dr, x, y, count;
+
+    for (i = 0; i < COLNO; i++)
+        for (j = 0; j < ROWNO; j++)
+            map[i][j] = newmap[i][j] = ((before[i] >> j) & 1UL) ? 1 : 0;
 
     for (i = 2; i <= WIDTH; i++)
         for (j = 1; j < HEIGHT; j++) {
-            for (count = 0, dr = 0; dr < 8; dr++)
-                if (get_map(i + dirs[dr * 2], j + dirs[(dr * 2) + 1], bg_typ)
-                    == fg_typ)
+            for (count = 0, dr = 0; dr < 8; dr++) {
+                x = i + dirs[dr * 2], y = j + dirs[dr * 2 + 1];
+                if (x > 0 && y >= 0 && x <= WIDTH && y < HEIGHT && map[x][y])
                     count++;
-            if (count < 3)
-                new_loc(i, j) = bg_typ;
-            else
-                new_loc(i, j) = get_map(i, j, bg_typ);
+            }
+            if (pass == 1) {
+                if (count <= 2)
+                    map[i][j] = 0;
+                else if (count >= 5)
+                    map[i][j] = 1;
+            } else if ((pass == 2) ? (count == 5) : (count < 3)) {
+                newmap[i][j] = 0;
+            }
         }
 
     for (i = 2; i <= WIDTH; i++)
         for (j = 1; j < HEIGHT; j++)
-            levl[i][j].typ = new_loc(i, j);
+            if ((pass == 1 ? map[i][j] : newmap[i][j])
+                != (((after[i] >> j) & 1UL) ? 1 : 0)) {
+                impossible("mkmap: pass %d differs at <%d,%d>", pass, i, j);
+                return;
+            }
 }
+#endif /* EXTRA_SANITY_CHECKS */
 
-/*
- * use a flooding algorithm to find all locations that should
- * have the same rm number as the current location.
- * if anyroom is TRUE, use IS_ROOM to check room membership instead of
- * exactly matching levl[sx][sy].typ and walls are included as well.
- */
-void
-flood_fill_rm(sx, sy, rmno, lit, anyroom)
-int sx;
-register int sy;
-register int rmno;
-boolean lit;
-boolean anyroom;
+/* start filling the span which includes sx,sy */
+static void
+ffill_span(f, sx, sy, rmno, lit, anyroom, fg_typ)
+struct ffill_span *f;
+int sx, sy, rmno;
+boolean lit, anyroom;
+schar fg_typ;
 {
     register int i;
-    int nx;
-    schar fg_typ = levl[sx][sy].typ;
 
     /* back up to find leftmost uninitialized location */
     while (sx > 0 && (anyroom ? IS_ROOM(levl[sx][sy].typ)
@@ -199,49 +302,105 @@ boolean anyroom;
         }
         g.n_loc_filled++;
     }
-    nx = i;
 
-    if (isok(sx, sy - 1)) {
-        for (i = sx; i < nx; i++)
-            if (levl[i][sy - 1].typ == fg_typ) {
-                if ((int) levl[i][sy - 1].roomno != rmno)
-                    flood_fill_rm(i, sy - 1, rmno, lit, anyroom);
+    f->sx = sx;
+    f->sy = sy;
+    f->nx = i;
+    f->dy = -1;
+    f->i = sx;
+    f->step = 0;
+}
+
+/*
+ * use a flooding algorithm to find all locations that should
+ * have the same rm number as the current location.
+ * if anyroom is TRUE, use IS_ROOM to check room membership instead of
+ * exactly matching levl[sx][sy].typ and walls are included as well.
+ *
+ * Each span is filled, then the rows above and below it are searched for
+ * more; the spans still being searched are kept on a stack instead of
+ * recursing, and visited in the same order recursion would visit them.
+ */
+void
+flood_fill_rm(sx, sy, rmno, lit, anyroom)
+int sx;
+register int sy;
+register int rmno;
+boolean lit;
+boolean anyroom;
+{
+    struct ffill_span *stack, *f;
+    int depth, stacksize, i, x, y;
+    schar fg_typ = levl[sx][sy].typ;
+
+    stacksize = 64;
+    stack = (struct ffill_span *) alloc(stacksize * sizeof *stack);
+    ffill_span(&stack[0], sx, sy, rmno, lit, anyroom, fg_typ);
+    depth = 1;
+
+    while (depth > 0) {
+        f = &stack[depth - 1];
+        if (f->dy > 1) {
+            /* both neighboring rows have been searched; span is done */
+            if (f->nx > g.max_rx)
+                g.max_rx = f->nx - 1; /* nx is just past valid region */
+            if (f->sy > g.max_ry)
+                g.max_ry = f->sy;
+            depth--;
+            continue;
+        }
+        y = f->sy + f->dy;
+        i = f->i;
+        if (i >= f->nx || !isok(f->sx, y)) {
+            f->dy += 2; /* on to the row below */
+            f->i = f->sx;
+            f->step = 0;
+            continue;
+        }
+
+        x = -1; /* set to a spot which starts another span */
+        switch (f->step) {
+        case 0:
+            if (levl[i][y].typ == fg_typ) {
+                if ((int) levl[i][y].roomno != rmno)
+                    x = i;
+                f->i++;
             } else {
-                if ((i > sx || isok(i - 1, sy - 1))
-                    && levl[i - 1][sy - 1].typ == fg_typ) {
-                    if ((int) levl[i - 1][sy - 1].roomno != rmno)
-                        flood_fill_rm(i - 1, sy - 1, rmno, lit, anyroom);
-                }
-                if ((i < nx - 1 || isok(i + 1, sy - 1))
-                    && levl[i + 1][sy - 1].typ == fg_typ) {
-                    if ((int) levl[i + 1][sy - 1].roomno != rmno)
-                        flood_fill_rm(i + 1, sy - 1, rmno, lit, anyroom);
-                }
+                f->step = 1;
             }
-    }
-    if (isok(sx, sy + 1)) {
-        for (i = sx; i < nx; i++)
-            if (levl[i][sy + 1].typ == fg_typ) {
-                if ((int) levl[i][sy + 1].roomno != rmno)
-                    flood_fill_rm(i, sy + 1, rmno, lit, anyroom);
-            } else {
-                if ((i > sx || isok(i - 1, sy + 1))
-                    && levl[i - 1][sy + 1].typ == fg_typ) {
-                    if ((int) levl[i - 1][sy + 1].roomno != rmno)
-                        flood_fill_rm(i - 1, sy + 1, rmno, lit, anyroom);
-                }
-                if ((i < nx - 1 || isok(i + 1, sy + 1))
-                    && levl[i + 1][sy + 1].typ == fg_typ) {
-                    if ((int) levl[i + 1][sy + 1].roomno != rmno)
-                        flood_fill_rm(i + 1, sy + 1, rmno, lit, anyroom);
-                }
+            break;
+        case 1:
+            if ((i > f->sx || isok(i - 1, y)) && levl[i - 1][y].typ == fg_typ
+                && (int) levl[i - 1][y].roomno != rmno)
+                x = i - 1;
+            f->step = 2;
+            break;
+        default:
+            if ((i < f->nx - 1 || isok(i + 1, y))
+                && levl[i + 1][y].typ == fg_typ
+                && (int) levl[i + 1][y].roomno != rmno)
+                x = i + 1;
+            f->step = 0;
+            f->i++;
+            break;
+        }
+
+        if (x >= 0) {
+            if (depth == stacksize) {
+                struct ffill_span *newstack;
+
+                newstack = (struct ffill_span *) alloc(2 * stacksize
+                                                       * sizeof *stack);
+                (void) memcpy((genericptr_t) newstack, (genericptr_t) stack,
+                              stacksize * sizeof *stack);
+                free((genericptr_t) stack);
+                stack = newstack;
+                stacksize *= 2;
             }
+            ffill_span(&stack[depth++], x, y, rmno, lit, anyroom, fg_typ);
+        }
     }
-
-    if (nx > g.max_rx)
-        g.max_rx = nx - 1; /* nx is just past valid region */
-    if (sy > g.max_ry)
-        g.max_ry = sy;
+    free((genericptr_t) stack);
 }
 
 /*
@@ -446,6 +605,18 @@ unsigned roomno;
 #define N_P2_ITER 1 /* tune map generation via this value */
 #define N_P3_ITER 2 /* tune map smoothing via this value */
 
+#ifdef EXTRA_SANITY_CHECKS
+#define CAVE_PASS(pass, n) \
+    do {                                                                \
+        (void) memcpy((genericptr_t) before, (genericptr_t) cave,       \
+                      sizeof before);                                   \
+        pass(cave);                                                     \
+        cave_check(n, before, cave);                                    \
+    } while (0)
+#else
+#define CAVE_PASS(pass, n) pass(cave)
+#endif
+
 boolean
 litstate_rnd(litstate)
 int litstate;
@@ -462,24 +633,35 @@ lev_init *init_lev;
     schar bg_typ = init_lev->bg, fg_typ = init_lev->fg;
     boolean smooth = init_lev->smoothed, join = init_lev->joined;
     xchar lit = init_lev->lit, walled = init_lev->walled;
+    unsigned long cave[COLNO];
+#ifdef EXTRA_SANITY_CHECKS
+    unsigned long before[COLNO];
+#endif
     int i;
 
     lit = litstate_rnd(lit);
 
-    g.new_locations = (char *) alloc((WIDTH + 1) * HEIGHT);
-
     init_map(bg_typ);
     init_fill(bg_typ, fg_typ);
 
-    for (i = 0; i < N_P1_ITER; i++)
-        pass_one(bg_typ, fg_typ);
+    /* when fg_typ and bg_typ are the same, the passes don't change
+       anything (and the bitmap couldn't tell the two apart) */
+    if (fg_typ != bg_typ) {
+        cave_load(cave, fg_typ);
 
-    for (i = 0; i < N_P2_ITER; i++)
-        pass_two(bg_typ, fg_typ);
+        for (i = 0; i < N_P1_ITER; i++) {
+            CAVE_PASS(pass_one, 1);
+        }
+        for (i = 0; i < N_P2_ITER; i++) {
+            CAVE_PASS(pass_two, 2);
+        }
+        if (smooth)
+            for (i = 0; i < N_P3_ITER; i++) {
+                CAVE_PASS(pass_three, 3);
+            }
 
-    if (smooth)
-        for (i = 0; i < N_P3_ITER; i++)
-            pass_three(bg_typ, fg_typ);
+        cave_store(cave, bg_typ, fg_typ);
+    }
 
     if (join)
         join_map(bg_typ, fg_typ);
@@ -491,7 +673,6 @@ lev_init *init_lev;
         g.level.flags.is_maze_lev = FALSE;
         g.level.flags.is_cavernous_lev = TRUE;
     }
-    free(g.new_locations);
 }
 
 /*mkmap.c*/
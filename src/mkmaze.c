@@ -1472,6 +1472,8 @@ movebubbles()
                             cons->y = y;
                             cons->what = CONS_TRAP;
                             cons->list = (genericptr_t) btrap;
+                            /* in transit; re-indexed when put down */
+                            g.level.traps[x][y] = (struct trap *) 0;
 
                             cons->next = b->cons;
                             b->cons = cons;
@@ -1918,6 +1920,7 @@ boolean ini;
 
                 btrap->tx = cons->x;
                 btrap->ty = cons->y;
+                g.level.traps[btrap->tx][btrap->ty] = btrap;
                 break;
             }
 
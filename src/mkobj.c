@@ -72,7 +72,7 @@ newoextra()
 {
     struct oextra *oextra;
 
-    oextra = (struct oextra *) alloc(sizeof (struct oextra));
+    oextra = (struct oextra *) pool_alloc(&oextra_pool);
     oextra->oname = 0;
     oextra->omonst = 0;
     oextra->omid = 0;
@@ -99,7 +99,7 @@ struct obj *o;
         if (x->omailcmd)
             free((genericptr_t) x->omailcmd);
 
-        free((genericptr_t) x);
+        pool_free(&oextra_pool, (genericptr_t) x);
         o->oextra = (struct oextra *) 0;
     }
 }
@@ -129,7 +129,7 @@ struct obj *otmp;
         if (m) {
             if (m->mextra)
                 dealloc_mextra(m);
-            free((genericptr_t) m);
+            pool_free(&monst_pool, (genericptr_t) m);
             OMONST(otmp) = (struct monst *) 0;
         }
     }
@@ -442,6 +442,7 @@ long num;
     *otmp = *obj; /* copies whole structure */
     otmp->oextra = (struct oextra *) 0;
     otmp->o_id = nextoid(obj, otmp);
+    register_oid(otmp);
     otmp->timed = 0;                  /* not timed, yet */
     otmp->lamplit = 0;                /* ditto */
     otmp->owornmask = 0L;             /* new object isn't worn */
@@ -670,6 +671,7 @@ register struct obj *otmp;
     dummy->o_id = g.context.ident++;
     if (!dummy->o_id)
         dummy->o_id = g.context.ident++; /* ident overflowed */
+    register_oid(dummy);
     dummy->timed = 0;
     copy_oextra(dummy, otmp);
     if (has_omid(dummy))
@@ -789,6 +791,7 @@ boolean artif;
     otmp->o_id = g.context.ident++;
     if (!otmp->o_id)
         otmp->o_id = g.context.ident++; /* ident overflowed */
+    register_oid(otmp);
     otmp->quan = 1L;
     otmp->oclass = let;
     otmp->otyp = otyp;
@@ -2165,6 +2168,25 @@ struct obj *container;
  * Deallocate the object.  _All_ objects should be run through here for
  * them to be deallocated.
  */
+/* make obj findable by find_oid() */
+void
+register_oid(obj)
+struct obj *obj;
+{
+    idmap_set(&g.oid_map, obj->o_id, obj_to_any(obj));
+}
+
+/* forget obj; its o_id might have been taken over by another object */
+void
+unregister_oid(obj)
+struct obj *obj;
+{
+    anything *val = idmap_get(&g.oid_map, obj->o_id);
+
+    if (val && val->a_obj == obj)
+        idmap_remove(&g.oid_map, obj->o_id);
+}
+
 void
 dealloc_obj(obj)
 struct obj *obj;
@@ -2176,6 +2198,8 @@ struct obj *obj;
     if (obj->cobj)
         panic("dealloc_obj with cobj");
 
+    unregister_oid(obj);
+
     /* free up any timers attached to the object */
     if (obj->timed)
         obj_stop_timers(obj);
@@ -2205,7 +2229,7 @@ struct obj *obj;
         obj->where = OBJ_LUAFREE;
         return;
     }
-    free((genericptr_t) obj);
+    pool_free(&obj_pool, (genericptr_t) obj);
 }
 
 /* create an object from a horn of plenty; mirrors bagotricks(makemon.c) */
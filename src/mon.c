@@ -29,6 +29,8 @@ static void FDECL(lifesaved_monster, (struct monst *));
 static void FDECL(migrate_mon, (struct monst *, XCHAR_P, XCHAR_P));
 static boolean FDECL(ok_to_obliterate, (struct monst *));
 static void FDECL(deal_with_overcrowding, (struct monst *));
+static int NDECL(mclass_kind);
+static void NDECL(init_mclass);
 
 /* note: duplicated in dog.c */
 #define LEVEL_SPECIFIC_NOCORPSE(mdat) \
@@ -1301,6 +1303,89 @@ struct obj *otmp;
     return iquan;
 }
 
+/*
+ * Terrain classes for mfndpos().  Everything it needs to know about a
+ * spot's terrain depends only on the spot's typ and flags, plus whether
+ * the level is arboreal (stone counts as trees) and whether it's
+ * Juiblex's swamp (drawbridges there aren't over moats).  So rather than
+ * keeping a map of classes which every change to levl[] would have to
+ * update, the classes of every typ and flags combination are worked out
+ * for the current kind of level, and only redone when that changes.
+ * mfndpos() turns a monster's abilities into masks of the classes it
+ * can't enter, then tests each neighbor's class against them.
+ */
+#define MC_ROCK     0x0001 /* IS_ROCK() */
+#define MC_TREE     0x0002 /* IS_TREE() */
+#define MC_PASSWALL 0x0004 /* may_passwall() */
+#define MC_DIGGABLE 0x0008 /* may_dig() */
+#define MC_BARS     0x0010 /* iron bars */
+#define MC_BARS_ND  0x0020 /* non-diggable iron bars */
+#define MC_DOOR     0x0040 /* IS_DOOR() */
+#define MC_CLOSED   0x0080 /* closed door */
+#define MC_LOCKED   0x0100 /* locked door */
+#define MC_NODIAG   0x0200 /* door which can't be entered diagonally */
+#define MC_POOL     0x0400 /* is_pool() */
+#define MC_LAVA     0x0800 /* is_lava() */
+/* MC_TREE, MC_PASSWALL and MC_DIGGABLE as a number from 0 to 7 */
+#define MC_ROCKBITS(c) (((c) >> 1) & 7)
+
+static unsigned short mclass[MAX_TYPE][32]; /* [typ][flags] */
+static int mclass_level = -1; /* mclass_kind() it was set up for */
+
+/* the things about the current level which terrain classes depend on */
+static int
+mclass_kind()
+{
+    return ((g.level.flags.arboreal ? 1 : 0)
+            | (Is_juiblex_level(&u.uz) ? 2 : 0));
+}
+
+/* fill in mclass[]; has to agree with is_pool(), may_dig(), &c */
+static void
+init_mclass()
+{
+    boolean jb = Is_juiblex_level(&u.uz);
+    int typ, fl;
+    unsigned short c;
+
+    for (typ = 0; typ < MAX_TYPE; typ++)
+        for (fl = 0; fl < 32; fl++) {
+            c = 0;
+            if (IS_ROCK(typ))
+                c |= MC_ROCK;
+            if (IS_TREE(typ))
+                c |= MC_TREE;
+            if (!(IS_STWALL(typ) && (fl & W_NONPASSWALL)))
+                c |= MC_PASSWALL;
+            if (!((IS_STWALL(typ) || IS_TREE(typ))
+                  && (fl & W_NONDIGGABLE)))
+                c |= MC_DIGGABLE;
+            if (typ == IRONBARS) {
+                c |= MC_BARS;
+                if (fl & W_NONDIGGABLE)
+                    c |= MC_BARS_ND;
+            }
+            if (IS_DOOR(typ)) {
+                c |= MC_DOOR;
+                if (fl & D_CLOSED)
+                    c |= MC_CLOSED;
+                if (fl & D_LOCKED)
+                    c |= MC_LOCKED;
+                if (fl & ~D_BROKEN)
+                    c |= MC_NODIAG;
+            }
+            if (typ == POOL || typ == MOAT || typ == WATER
+                || (!jb && typ == DRAWBRIDGE_UP
+                    && (fl & DB_UNDER) == DB_MOAT))
+                c |= MC_POOL;
+            if (typ == LAVAPOOL
+                || (typ == DRAWBRIDGE_UP && (fl & DB_UNDER) == DB_LAVA))
+                c |= MC_LAVA;
+            mclass[typ][fl] = c;
+        }
+    mclass_level = mclass_kind();
+}
+
 /* return number of acceptable neighbour positions */
 int
 mfndpos(mon, poss, info, flag)
@@ -1321,10 +1406,16 @@ long flag;
     boolean poisongas_ok, in_poisongas;
     NhRegion *gas_reg;
     int gas_glyph = cmap_to_glyph(S_poisoncloud);
+    unsigned short cls, nowcls, blocked, diagmask;
+    unsigned rockmask;
+    int i;
 
+    if (mclass_kind() != mclass_level)
+        init_mclass();
     x = mon->mx;
     y = mon->my;
     nowtyp = levl[x][y].typ;
+    nowcls = mclass[nowtyp][levl[x][y].flags];
 
     nodiag = NODIAG(mdat - mons);
     wantpool = (mdat->mlet == S_EEL);
@@ -1372,6 +1463,29 @@ long flag;
     }
     if (!mon->mcansee)
         flag |= ALLOW_SSM;
+
+    /* which kinds of rock (by MC_ROCKBITS()) can be passed or dug */
+    for (rockmask = 0, i = 0; i < 8; i++)
+        if (((flag & ALLOW_WALL) && (i & (MC_PASSWALL >> 1)))
+            || (((i & (MC_TREE >> 1)) ? treeok : rockok)
+                && (i & (MC_DIGGABLE >> 1))))
+            rockmask |= 1U << i;
+    /* other terrain which is off limits */
+    blocked = 0;
+    /* KMH -- Added iron bars */
+    if (!(flag & ALLOW_BARS))
+        blocked |= MC_BARS;
+    else if (dmgtype(mdat, AD_RUST) || dmgtype(mdat, AD_CORR))
+        blocked |= MC_BARS_ND;
+    if (!(amorphous(mdat) || can_fog(mon)) && !thrudoor) {
+        if (!(flag & OPENDOOR))
+            blocked |= MC_CLOSED;
+        if (!(flag & UNLOCKDOOR))
+            blocked |= MC_LOCKED;
+    }
+    /* doors which can't be entered or left diagonally */
+    diagmask = MC_NODIAG | (Is_rogue_level(&u.uz) ? MC_DOOR : 0);
+
     maxx = min(x + 1, COLNO - 1);
     maxy = min(y + 1, ROWNO - 1);
     for (nx = max(1, x - 1); nx <= maxx; nx++)
@@ -1379,21 +1493,18 @@ long flag;
             if (nx == x && ny == y)
                 continue;
             ntyp = levl[nx][ny].typ;
-            if (IS_ROCK(ntyp)
-                && !((flag & ALLOW_WALL) && may_passwall(nx, ny))
-                && !((IS_TREE(ntyp) ? treeok : rockok) && may_dig(nx, ny)))
-                continue;
-            /* KMH -- Added iron bars */
-            if (ntyp == IRONBARS
-                && (!(flag & ALLOW_BARS)
-                    || ((levl[nx][ny].wall_info & W_NONDIGGABLE)
-                        && (dmgtype(mdat, AD_RUST)
-                            || dmgtype(mdat, AD_CORR)))))
-                continue;
-            if (IS_DOOR(ntyp) && !(amorphous(mdat) || can_fog(mon))
-                && (((levl[nx][ny].doormask & D_CLOSED) && !(flag & OPENDOOR))
-                    || ((levl[nx][ny].doormask & D_LOCKED)
-                        && !(flag & UNLOCKDOOR))) && !thrudoor)
+            cls = mclass[ntyp][levl[nx][ny].flags];
+#ifdef EXTRA_SANITY_CHECKS
+            if (!(cls & MC_POOL) != !is_pool(nx, ny)
+                || !(cls & MC_LAVA) != !is_lava(nx, ny)
+                || !(cls & MC_DIGGABLE) != !may_dig(nx, ny)
+                || !(cls & MC_PASSWALL) != !may_passwall(nx, ny))
+                impossible("mfndpos: wrong terrain class %#x at <%d,%d>",
+                           (unsigned) cls, nx, ny);
+#endif
+            if ((cls & blocked)
+                || ((cls & MC_ROCK)
+                    && !((rockmask >> MC_ROCKBITS(cls)) & 1U)))
                 continue;
             /* avoid poison gas? */
             if (!poisongas_ok && !in_poisongas
@@ -1402,18 +1513,14 @@ long flag;
                 continue;
             /* first diagonal checks (tight squeezes handled below) */
             if (nx != x && ny != y
-                && (nodiag
-                    || (IS_DOOR(nowtyp) && (levl[x][y].doormask & ~D_BROKEN))
-                    || (IS_DOOR(ntyp) && (levl[nx][ny].doormask & ~D_BROKEN))
-                    || ((IS_DOOR(nowtyp) || IS_DOOR(ntyp))
-                        && Is_rogue_level(&u.uz))
+                && (nodiag || ((nowcls | cls) & diagmask)
                     /* mustn't pass between adjacent long worm segments,
                        but can attack that way */
                     || (m_at(x, ny) && m_at(nx, y) && worm_cross(x, y, nx, ny)
                         && !m_at(nx, ny) && (nx != u.ux || ny != u.uy))))
                 continue;
-            if ((is_pool(nx, ny) == wantpool || poolok)
-                && (lavaok || !is_lava(nx, ny))) {
+            if ((!(cls & MC_POOL) == !wantpool || poolok)
+                && (lavaok || !(cls & MC_LAVA))) {
                 int dispx, dispy;
                 boolean monseeu = (mon->mcansee
                                    && (!Invis || perceives(mdat)));
@@ -1666,6 +1773,7 @@ struct monst *mtmp, *mtmp2;
     }
     mtmp2->nmon = fmon;
     fmon = mtmp2;
+    register_mid(mtmp2);
     if (u.ustuck == mtmp)
         u.ustuck = mtmp2;
     if (u.usteed == mtmp)
@@ -1786,22 +1894,41 @@ struct monst *m;
         if (x->mname)
             free((genericptr_t) x->mname);
         if (x->egd)
-            free((genericptr_t) x->egd);
+            pool_free(&egd_pool, (genericptr_t) x->egd);
         if (x->epri)
-            free((genericptr_t) x->epri);
+            pool_free(&epri_pool, (genericptr_t) x->epri);
         if (x->eshk)
-            free((genericptr_t) x->eshk);
+            pool_free(&eshk_pool, (genericptr_t) x->eshk);
         if (x->emin)
-            free((genericptr_t) x->emin);
+            pool_free(&emin_pool, (genericptr_t) x->emin);
         if (x->edog)
-            free((genericptr_t) x->edog);
+            pool_free(&edog_pool, (genericptr_t) x->edog);
         /* [no action needed for x->mcorpsenm] */
 
-        free((genericptr_t) x);
+        pool_free(&mextra_pool, (genericptr_t) x);
         m->mextra = (struct mextra *) 0;
     }
 }
 
+/* make mon findable by find_mid() */
+void
+register_mid(mon)
+struct monst *mon;
+{
+    idmap_set(&g.mid_map, mon->m_id, monst_to_any(mon));
+}
+
+/* forget mon; a replacement might have taken over its m_id */
+void
+unregister_mid(mon)
+struct monst *mon;
+{
+    anything *val = idmap_get(&g.mid_map, mon->m_id);
+
+    if (val && val->a_monst == mon)
+        idmap_remove(&g.mid_map, mon->m_id);
+}
+
 void
 dealloc_monst(mon)
 struct monst *mon;
@@ -1813,9 +1940,11 @@ struct monst *mon;
         describe_level(buf);
         panic("dealloc_monst with nmon on %s", buf);
     }
+    unregister_mid(mon);
+    forget_region_mon(mon);
     if (mon->mextra)
         dealloc_mextra(mon);
-    free((genericptr_t) mon);
+    pool_free(&monst_pool, (genericptr_t) mon);
 }
 
 /* remove effects of mtmp from other data structures */
@@ -110,8 +110,16 @@ register struct monst *mtmp;
 {
     int x = mtmp->mx, y = mtmp->my;
     boolean already_saw_mon = !g.occupation ? 0 : canspotmon(mtmp);
+#ifdef PERF_STATS
+    int mndx = monsndx(mtmp->data);
+    unsigned long start = perf_busy();
+#endif
     int rd = dochug(mtmp);
 
+#ifdef PERF_STATS
+    perf_mon(mndx, FALSE, start);
+#endif
+
     /* a similar check is in monster_nearby() in hack.c */
     /* check whether hero notices monster and stops current activity */
     if (g.occupation && !rd && !Confusion && (!mtmp->mpeaceful || Hallucination)
@@ -655,8 +663,17 @@ register struct monst *mtmp;
             }
         }
 
-        if (!tmp)
+        if (!tmp) {
+#ifdef PERF_STATS
+            int mndx = monsndx(mtmp->data);
+            unsigned long start = perf_busy();
+
             tmp = m_move(mtmp, 0);
+            perf_mon(mndx, TRUE, start);
+#else
+            tmp = m_move(mtmp, 0);
+#endif
+        }
         if (tmp != 2)
             distfleeck(mtmp, &inrange, &nearby, &scared); /* recalc */
 
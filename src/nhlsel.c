@@ -93,8 +93,7 @@ lua_State *L;
 
     sel->wid = tmp->wid;
     sel->hei = tmp->hei;
-    sel->map = dupstr(tmp->map);
-    selection_free(tmp);
+    sel->map = tmp->map; /* sel takes over tmp's map */
     free(tmp);
 
     return sel;
@@ -115,16 +114,14 @@ l_selection_clone(L)
 lua_State *L;
 {
     struct selectionvar *sel = l_selection_check(L, 1);
-    struct selectionvar *tmp;
-    /* int x,y; */   /* REVIEW: unreferenced */
+    struct selectionvar *tmp, *copy = selection_clone(sel);
+
     lua_pop(L, 1);
     (void) l_selection_new(L);
     tmp = l_selection_check(L, 1);
-    if (tmp->map)
-        free(tmp->map);
-    tmp->map = dupstr(sel->map);
-    tmp->wid = sel->wid;
-    tmp->hei = sel->hei;
+    selection_free(tmp);
+    *tmp = *copy; /* tmp takes over copy's map */
+    free(copy);
     return 1;
 }
 
@@ -223,15 +220,10 @@ static int
 l_selection_and(L)
 lua_State *L;
 {
-    int x,y;
     struct selectionvar *sela = l_selection_check(L, 1);
     struct selectionvar *selb = l_selection_check(L, 2);
 
-    for (x = 0; x < sela->wid; x++)
-        for (y = 0; y < sela->hei; y++) {
-            int val = selection_getpoint(x, y, sela) & selection_getpoint(x, y, selb);
-            selection_setpoint(x, y, sela, val);
-        }
+    selection_combine(sela, selb, '&');
 
     lua_settop(L, 1);
     return 1;
@@ -242,15 +234,10 @@ static int
 l_selection_or(L)
 lua_State *L;
 {
-    int x,y;
     struct selectionvar *sela = l_selection_check(L, 1);
     struct selectionvar *selb = l_selection_check(L, 2);
 
-    for (x = 0; x < sela->wid; x++)
-        for (y = 0; y < sela->hei; y++) {
-            int val = selection_getpoint(x, y, sela) | selection_getpoint(x, y, selb);
-            selection_setpoint(x, y, sela, val);
-        }
+    selection_combine(sela, selb, '|');
 
     lua_settop(L, 1);
     return 1;
@@ -261,15 +248,10 @@ static int
 l_selection_xor(L)
 lua_State *L;
 {
-    int x,y;
     struct selectionvar *sela = l_selection_check(L, 1);
     struct selectionvar *selb = l_selection_check(L, 2);
 
-    for (x = 0; x < sela->wid; x++)
-        for (y = 0; y < sela->hei; y++) {
-            int val = selection_getpoint(x, y, sela) ^ selection_getpoint(x, y, selb);
-            selection_setpoint(x, y, sela, val);
-        }
+    selection_combine(sela, selb, '^');
 
     lua_settop(L, 1);
     return 1;
@@ -959,18 +959,36 @@ lua_State *L;
     return 1;
 }
 
-/* read lua code/data from a dlb module or an external file
-   into a string buffer and feed that to lua */
-boolean
-nhl_loadlua(L, fname)
+/* registry key of the table holding compiled chunks, indexed by file name;
+   only the persistent core state keeps one */
+#define NHL_CHUNKCACHE "nhl_chunks"
+
+static int
+nhl_dumpwriter(L, p, sz, ud)
+lua_State *L UNUSED;
+const void *p;
+size_t sz;
+void *ud;
+{
+    luaL_addlstring((luaL_Buffer *) ud, (const char *) p, sz);
+    return 0;
+}
+
+/* compile lua code from a dlb module or an external file and leave the
+   resulting function on top of the stack; the file may contain either
+   source text or a chunk precompiled by luac */
+static boolean
+nhl_loadchunk(L, fname)
 lua_State *L;
 const char *fname;
 {
 #define LOADCHUNKSIZE (1L << 13) /* 8K */
-    boolean ret = TRUE;
+    boolean ret = TRUE, cacheit = (L == g.luacore);
     dlb *fh;
     char *buf = (char *) 0, *bufin, *bufout, *p, *nl, *altfname;
+    const char *chunk;
     long buflen, ct, cnt;
+    size_t chunklen;
     int llret;
 
     altfname = (char *) alloc(strlen(fname) + 3); /* 3: '('...')\0' */
@@ -978,22 +996,67 @@ const char *fname;
        if we did, we could choose between "nhdat(<fname>)" and "<fname>"
        but since we don't, compromise */
     Sprintf(altfname, "(%s)", fname);
-    fh = dlb_fopen(fname, "r");
+
+    if (cacheit) {
+        lua_getfield(L, LUA_REGISTRYINDEX, NHL_CHUNKCACHE);
+        lua_getfield(L, -1, fname);
+        if ((chunk = lua_tolstring(L, -1, &chunklen)) != 0) {
+            /* already compiled once; undumping is much cheaper than
+               reading and parsing the script again */
+            llret = luaL_loadbuffer(L, chunk, chunklen, altfname);
+            lua_remove(L, -2); /* cached string */
+            lua_remove(L, -2); /* cache table */
+            if (llret != LUA_OK) {
+                impossible("luaL_loadbuffer: Error loading %s (errcode %i)",
+                           altfname, llret);
+                lua_pop(L, 1); /* error message */
+                ret = FALSE;
+            }
+            goto give_up;
+        }
+        lua_pop(L, 2);
+    }
+
+    fh = dlb_fopen(fname, RDBMODE);
     if (!fh) {
         impossible("nhl_loadlua: Error loading %s", altfname);
         ret = FALSE;
         goto give_up;
     }
 
+    if ((chunk = dlb_fmap(fh, &buflen)) != 0) {
+        /* file is in a memory mapped archive; lua can take it in place,
+           text or precompiled, and the data outlives the handle */
+        chunklen = (size_t) buflen;
+        (void) dlb_fclose(fh);
+        goto compile;
+    }
+
     dlb_fseek(fh, 0L, SEEK_END);
     buflen = dlb_ftell(fh);
     dlb_fseek(fh, 0L, SEEK_SET);
 
     /* extra +1: room to add final '\n' if missing */
-    buf = bufout = (char *) alloc(buflen + 1 + 1);
+    chunk = buf = bufout = (char *) alloc(buflen + 1 + 1);
     buf[0] = '\0';
     bufin = bufout = buf;
 
+    if (dlb_fgetc(fh) == LUA_SIGNATURE[0]) {
+        /* precompiled chunk; binary data, so no line handling */
+        dlb_fseek(fh, 0L, SEEK_SET);
+        chunklen = 0;
+        while (buflen > 0) {
+            if ((cnt = dlb_fread(bufin, 1, min(buflen, LOADCHUNKSIZE),
+                                 fh)) <= 0L)
+                break;
+            bufin += cnt, buflen -= cnt;
+            chunklen += (size_t) cnt;
+        }
+        (void) dlb_fclose(fh);
+        goto compile;
+    }
+    dlb_fseek(fh, 0L, SEEK_SET);
+
     ct = 0L;
     while (buflen > 0 || ct) {
         /*
@@ -1042,27 +1105,39 @@ const char *fname;
             } else {
                 /* LOADCHUNKSIZE portion of buffer already completely full */
                 impossible("(%s) line too long", altfname);
+                (void) dlb_fclose(fh);
+                ret = FALSE;
                 goto give_up;
             }
         }
     }
     *bufout = '\0';
     (void) dlb_fclose(fh);
+    chunklen = strlen(buf);
 
-    llret = luaL_loadbuffer(L, buf, strlen(buf), altfname);
+ compile:
+    llret = luaL_loadbuffer(L, chunk, chunklen, altfname);
     if (llret != LUA_OK) {
         impossible("luaL_loadbuffer: Error loading %s (errcode %i)",
                    altfname, llret);
+        lua_pop(L, 1); /* error message */
         ret = FALSE;
-        goto give_up;
-    } else {
-        lua_pushcfunction(L, traceback_handler);
-        lua_insert(L, 1);
-        if (lua_pcall(L, 0, LUA_MULTRET, -2)) {
-            impossible("Lua error: %s", lua_tostring(L, -1));
-            ret = FALSE;
-            goto give_up;
+    } else if (cacheit) {
+        luaL_Buffer b;
+
+        lua_getfield(L, LUA_REGISTRYINDEX, NHL_CHUNKCACHE);
+        lua_pushvalue(L, -2); /* the function to dump */
+        luaL_buffinit(L, &b);
+        if (!lua_dump(L, nhl_dumpwriter, &b, 0)) {
+            luaL_pushresult(&b);
+            lua_setfield(L, -3, fname);
+            lua_pop(L, 1); /* copy of the function */
+        } else {
+            /* not fatal, just won't be cached */
+            luaL_pushresult(&b);
+            lua_pop(L, 2);
         }
+        lua_pop(L, 1); /* cache table */
     }
 
  give_up:
@@ -1073,6 +1148,37 @@ const char *fname;
     return ret;
 }
 
+/* call the function on top of the stack, with a traceback on error;
+   the function and anything it returned are popped */
+static boolean
+nhl_runchunk(L)
+lua_State *L;
+{
+    boolean ret = TRUE;
+    int base = lua_gettop(L);
+
+    lua_pushcfunction(L, traceback_handler);
+    lua_insert(L, base);
+    if (lua_pcall(L, 0, LUA_MULTRET, base)) {
+        impossible("Lua error: %s", lua_tostring(L, -1));
+        ret = FALSE;
+    }
+    lua_settop(L, base - 1);
+    return ret;
+}
+
+/* read lua code/data from a dlb module or an external file
+   into a string buffer and feed that to lua */
+boolean
+nhl_loadlua(L, fname)
+lua_State *L;
+const char *fname;
+{
+    if (!nhl_loadchunk(L, fname))
+        return FALSE;
+    return nhl_runchunk(L);
+}
+
 lua_State *
 nhl_init()
 {
@@ -1105,25 +1211,82 @@ nhl_init()
     return L;
 }
 
+/* the long-lived state used by load_lua(); built on first use so that
+   the bindings are only registered once per game */
+static lua_State *
+nhl_core()
+{
+    lua_State *L;
+
+    if (!g.luacore && (L = nhl_init()) != 0) {
+        lua_newtable(L);
+        lua_setfield(L, LUA_REGISTRYINDEX, NHL_CHUNKCACHE);
+        g.luacore = L;
+    }
+    return g.luacore;
+}
+
+/* release the persistent state */
+void
+nhl_done()
+{
+    if (g.luacore) {
+        lua_close(g.luacore);
+        g.luacore = (lua_State *) 0;
+    }
+}
+
+/* run a script in a sandbox: a fresh global environment which falls
+   back to the shared bindings for reading, so whatever one script
+   defines is gone by the time the next one runs */
 boolean
 load_lua(name)
 const char *name;
 {
     boolean ret = TRUE;
-    lua_State *L = nhl_init();
+    lua_State *L = nhl_core();
+    int env;
+
+    if (!L)
+        return FALSE;
 
-    if (!L) {
+    lua_settop(L, 0);
+    lua_newtable(L);
+    env = lua_gettop(L);
+    lua_newtable(L);
+    lua_pushglobaltable(L);
+    lua_setfield(L, -2, "__index");
+    lua_setmetatable(L, env);
+
+    /* nhlib.lua is re-run in the new environment rather than inherited
+       so that per-level setup such as the shuffled alignments is redone */
+    if (!nhl_loadchunk(L, "nhlib.lua")) {
+        ret = FALSE;
+        goto give_up;
+    }
+    lua_pushvalue(L, env);
+    (void) lua_setupvalue(L, -2, 1); /* _ENV */
+    if (!nhl_runchunk(L)) {
         ret = FALSE;
         goto give_up;
     }
 
-    if (!nhl_loadlua(L, name)) {
+    if (!nhl_loadchunk(L, name)) {
+        ret = FALSE;
+        goto give_up;
+    }
+    lua_pushvalue(L, env);
+    (void) lua_setupvalue(L, -2, 1); /* _ENV */
+    if (!nhl_runchunk(L)) {
         ret = FALSE;
         goto give_up;
     }
 
  give_up:
-    lua_close(L);
+    lua_settop(L, 0);
+    /* collect the script's leftovers now; obj userdata finalizers
+       release their objects, just as closing a state would */
+    lua_gc(L, LUA_GCCOLLECT, 0);
 
     return ret;
 }
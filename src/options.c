@@ -1656,6 +1656,7 @@ char *pattern;
     tmp->pattern = dupstr(pattern);
     tmp->next = g.plinemsg_types;
     g.plinemsg_types = tmp;
+    rxset_free(&g.plinemsg_rx); /* rebuilt when next needed */
     return TRUE;
 }
 
@@ -1671,6 +1672,7 @@ msgtype_free()
         free((genericptr_t) tmp);
     }
     g.plinemsg_types = (struct plinemsg_type *) 0;
+    rxset_free(&g.plinemsg_rx);
 }
 
 static void
@@ -1691,6 +1693,7 @@ int idx; /* 0 .. */
                 prev->next = next;
             else
                 g.plinemsg_types = next;
+            rxset_free(&g.plinemsg_rx);
             return;
         }
         idx--;
@@ -1706,13 +1709,17 @@ boolean norepeat; /* called from Norep(via pline) */
 {
     struct plinemsg_type *tmp = g.plinemsg_types;
 
-    while (tmp) {
-        /* we don't exclude entries with negative msgtype values
-           because then the msg might end up matching a later pattern */
-        if (regex_match(msg, tmp->regex))
-            return tmp->msgtype;
-        tmp = tmp->next;
-    }
+    if (!tmp)
+        return norepeat ? MSGTYP_NOREP : MSGTYP_NORMAL;
+    if (!g.plinemsg_rx.count)
+        for (; tmp; tmp = tmp->next)
+            rxset_add(&g.plinemsg_rx, tmp->pattern, tmp->regex,
+                      (genericptr_t) tmp);
+    /* we don't exclude entries with negative msgtype values
+       because then the msg might end up matching a later pattern */
+    tmp = (struct plinemsg_type *) rxset_match(&g.plinemsg_rx, msg);
+    if (tmp)
+        return tmp->msgtype;
     return norepeat ? MSGTYP_NOREP : MSGTYP_NORMAL;
 }
 
@@ -1825,6 +1832,7 @@ int c, a;
         tmp->color = c;
         tmp->attr = a;
         g.menu_colorings = tmp;
+        rxset_free(&g.menucolor_rx); /* rebuilt when next needed */
         return TRUE;
     }
 }
@@ -1884,13 +1892,18 @@ int *color, *attr;
 {
     struct menucoloring *tmpmc;
 
-    if (iflags.use_menu_color)
+    if (!iflags.use_menu_color || !g.menu_colorings)
+        return FALSE;
+    if (!g.menucolor_rx.count)
         for (tmpmc = g.menu_colorings; tmpmc; tmpmc = tmpmc->next)
-            if (regex_match(str, tmpmc->match)) {
-                *color = tmpmc->color;
-                *attr = tmpmc->attr;
-                return TRUE;
-            }
+            rxset_add(&g.menucolor_rx, tmpmc->origstr, tmpmc->match,
+                      (genericptr_t) tmpmc);
+    tmpmc = (struct menucoloring *) rxset_match(&g.menucolor_rx, str);
+    if (tmpmc) {
+        *color = tmpmc->color;
+        *attr = tmpmc->attr;
+        return TRUE;
+    }
     return FALSE;
 }
 
@@ -1905,6 +1918,7 @@ free_menu_coloring()
         free((genericptr_t) tmp->origstr);
         free((genericptr_t) tmp);
     }
+    rxset_free(&g.menucolor_rx);
 }
 
 static void
@@ -1925,6 +1939,7 @@ int idx; /* 0 .. */
                 prev->next = next;
             else
                 g.menu_colorings = next;
+            rxset_free(&g.menucolor_rx);
             return;
         }
         idx--;
@@ -6050,6 +6065,7 @@ const char *mapping;
     ape->grab = grab;
     ape->next = g.apelist;
     g.apelist = ape;
+    rxset_free(&g.ape_rx); /* rebuilt when next needed */
     return 1;
 }
 
@@ -6070,6 +6086,7 @@ struct autopickup_exception *whichape;
             regex_free(freeape->regex);
             free((genericptr_t) freeape->pattern);
             free((genericptr_t) freeape);
+            rxset_free(&g.ape_rx);
         } else {
             prev = ape;
             ape = ape->next;
@@ -6088,6 +6105,7 @@ free_autopickup_exceptions()
       g.apelist = ape->next;
       free((genericptr_t) ape);
     }
+    rxset_free(&g.ape_rx);
 }
 
 /* bundle some common usage into one easy-to-use routine */
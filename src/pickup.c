@@ -774,8 +774,12 @@ struct obj *obj;
     if (ape) {
         char *objdesc = makesingular(doname(obj));
 
-        while (ape && !regex_match(objdesc, ape->regex))
-            ape = ape->next;
+        if (!g.ape_rx.count)
+            for (; ape; ape = ape->next)
+                rxset_add(&g.ape_rx, ape->pattern, ape->regex,
+                          (genericptr_t) ape);
+        ape = (struct autopickup_exception *) rxset_match(&g.ape_rx,
+                                                          objdesc);
     }
     return ape;
 }
@@ -41,6 +41,7 @@ set_uasmon()
     boolean was_vampshifter = valid_vampshiftform(g.youmonst.cham, u.umonnum);
 
     set_mon_data(&g.youmonst, mdat);
+    status_dirty(BL_TITLE); /* rank or monster name */
 
     if (Protection_from_shape_changers)
         g.youmonst.cham = NON_PM;
@@ -253,6 +254,7 @@ change_sex()
     if (already_polyd) /* poly'd: also change saved sex */
         u.mfemale = !u.mfemale;
     max_rank_sz(); /* [this appears to be superfluous] */
+    status_dirty(BL_TITLE); /* rank titles can depend on sex */
     if ((already_polyd ? u.mfemale : flags.female) && g.urole.name.f)
         Strcpy(g.pl_character, g.urole.name.f);
     else
@@ -294,6 +296,7 @@ newman()
     if (u.ulevelmax < newlvl)
         u.ulevelmax = newlvl;
     u.ulevel = newlvl;
+    status_dirty(BL_TITLE);
 
     if (g.sex_change_ok && !rn2(10))
         change_sex();
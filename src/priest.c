@@ -19,7 +19,7 @@ struct monst *mtmp;
     if (!mtmp->mextra)
         mtmp->mextra = newmextra();
     if (!EPRI(mtmp)) {
-        EPRI(mtmp) = (struct epri *) alloc(sizeof(struct epri));
+        EPRI(mtmp) = (struct epri *) pool_alloc(&epri_pool);
         (void) memset((genericptr_t) EPRI(mtmp), 0, sizeof(struct epri));
     }
 }
@@ -29,7 +29,7 @@ free_epri(mtmp)
 struct monst *mtmp;
 {
     if (mtmp->mextra && EPRI(mtmp)) {
-        free((genericptr_t) EPRI(mtmp));
+        pool_free(&epri_pool, (genericptr_t) EPRI(mtmp));
         EPRI(mtmp) = (struct epri *) 0;
     }
     mtmp->ispriest = 0;
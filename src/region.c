@@ -4,6 +4,10 @@
 
 #include "hack.h"
 
+#ifndef LONG_MAX
+#include <limits.h>
+#endif
+
 /*
  * This should really go into the level structure, but
  * I'll start here for ease. It *WILL* move into the level
@@ -39,6 +43,12 @@ NhRegion *FDECL(create_force_field, (XCHAR_P,XCHAR_P,int,long));
 #endif
 
 static void FDECL(reset_region_mids, (NhRegion *));
+static void FDECL(set_region_ttl, (NhRegion *, long));
+static long FDECL(region_ttl, (NhRegion *));
+static boolean FDECL(region_active, (NhRegion *));
+static void FDECL(index_region, (NhRegion *, int));
+static boolean FDECL(region_mon_ok, (struct monst *, unsigned));
+static struct monst *FDECL(region_mon, (NhRegion *, int));
 
 static const callback_proc callbacks[] = {
 #define INSIDE_GAS_CLOUD 0
@@ -74,6 +84,70 @@ int x, y;
     return FALSE;
 }
 
+/* is reg in the list of active regions? */
+static boolean
+region_active(reg)
+NhRegion *reg;
+{
+    int i;
+
+    for (i = 0; i < g.n_regions; i++)
+        if (g.regions[i] == reg)
+            return TRUE;
+    return FALSE;
+}
+
+/*
+ * Count (delta 1) or uncount (delta -1) the spots covered by an active
+ * region in g.region_cells[][], so that the per-turn and per-step checks
+ * can pass over spots no region covers without looking at any of them.
+ */
+static void
+index_region(reg, delta)
+NhRegion *reg;
+int delta;
+{
+    int x, y;
+
+    for (x = reg->bounding_box.lx; x <= reg->bounding_box.hx; x++)
+        for (y = reg->bounding_box.ly; y <= reg->bounding_box.hy; y++)
+            /* Some regions can cross the level boundaries */
+            if (isok(x, y) && inside_region(reg, x, y))
+                g.region_cells[x][y] += delta;
+}
+
+/* macro for the callers which are given a spot that might not be isok() */
+#define region_cell_empty(x, y) (!isok(x, y) || !g.region_cells[x][y])
+
+/*
+ * Can a remembered pointer to a region's monster be used?  Freed monsters
+ * have already been forgotten by dealloc_monst(), so this only needs to
+ * rule out ones which are dead or have left the map; find_mid() gets the
+ * rest.
+ */
+static boolean
+region_mon_ok(mtmp, mid)
+struct monst *mtmp;
+unsigned mid;
+{
+    return (boolean) (mtmp && mtmp->m_id == mid && !DEADMONSTER(mtmp)
+                      && mtmp->mx > 0 && isok(mtmp->mx, mtmp->my)
+                      && g.level.monsters[mtmp->mx][mtmp->my] == mtmp);
+}
+
+/* the i'th monster listed for a region, if it's still around */
+static struct monst *
+region_mon(reg, i)
+NhRegion *reg;
+int i;
+{
+    struct monst *mtmp = reg->mptrs[i];
+
+    if (!region_mon_ok(mtmp, reg->monsters[i]))
+        reg->mptrs[i] = mtmp = find_mid(reg->monsters[i], FM_FMON);
+    return mtmp;
+}
+
 /*
  * Create a region. It does not activate it.
  */
@@ -126,6 +200,7 @@ int nrect;
     reg->n_monst = 0;
     reg->max_monst = 0;
     reg->monsters = (unsigned int *) 0;
+    reg->mptrs = (struct monst **) 0;
     reg->arg = cg.zeroany;
     return reg;
 }
@@ -139,7 +214,10 @@ NhRegion *reg;
 NhRect *rect;
 {
     NhRect *tmp_rect;
+    boolean active = region_active(reg);
 
+    if (active)
+        index_region(reg, -1);
     tmp_rect = (NhRect *) alloc((reg->nrects + 1) * sizeof (NhRect));
     if (reg->nrects > 0) {
         (void) memcpy((genericptr_t) tmp_rect, (genericptr_t) reg->rects,
@@ -158,6 +236,8 @@ NhRect *rect;
         reg->bounding_box.hx = rect->hx;
     if (reg->bounding_box.hy < rect->hy)
         reg->bounding_box.hy = rect->hy;
+    if (active)
+        index_region(reg, 1);
 }
 
 /*
@@ -170,18 +250,26 @@ struct monst *mon;
 {
     int i;
     unsigned *tmp_m;
+    struct monst **tmp_p;
 
     if (reg->max_monst <= reg->n_monst) {
         tmp_m = (unsigned *) alloc(sizeof (unsigned)
                                    * (reg->max_monst + MONST_INC));
+        tmp_p = (struct monst **) alloc(sizeof (struct monst *)
+                                        * (reg->max_monst + MONST_INC));
         if (reg->max_monst > 0) {
-            for (i = 0; i < reg->max_monst; i++)
+            for (i = 0; i < reg->max_monst; i++) {
                 tmp_m[i] = reg->monsters[i];
+                tmp_p[i] = reg->mptrs[i];
+            }
             free((genericptr_t) reg->monsters);
+            free((genericptr_t) reg->mptrs);
         }
         reg->monsters = tmp_m;
+        reg->mptrs = tmp_p;
         reg->max_monst += MONST_INC;
     }
+    reg->mptrs[reg->n_monst] = mon;
     reg->monsters[reg->n_monst++] = mon->m_id;
 }
 
@@ -199,6 +287,7 @@ struct monst *mon;
         if (reg->monsters[i] == mon->m_id) {
             reg->n_monst--;
             reg->monsters[i] = reg->monsters[reg->n_monst];
+            reg->mptrs[i] = reg->mptrs[reg->n_monst];
             return;
         }
 }
@@ -234,7 +323,7 @@ NhRegion *reg;
     NhRegion *ret_reg;
 
     ret_reg = create_region(reg->rects, reg->nrects);
-    ret_reg->ttl = reg->ttl;
+    set_region_ttl(ret_reg, region_ttl(reg));
     ret_reg->attach_2_u = reg->attach_2_u;
     ret_reg->attach_2_m = reg->attach_2_m;
  /* ret_reg->attach_2_o = reg->attach_2_o; */
@@ -270,6 +359,8 @@ NhRegion *reg;
             free((genericptr_t) reg->rects);
         if (reg->monsters)
             free((genericptr_t) reg->monsters);
+        if (reg->mptrs)
+            free((genericptr_t) reg->mptrs);
         if (reg->enter_msg)
             free((genericptr_t) reg->enter_msg);
         if (reg->leave_msg)
@@ -282,6 +373,37 @@ NhRegion *reg;
  * Add a region to the list.
  * This actually activates the region.
  */
+/*
+ * Regions don't count down their ttl every turn.  While a region is
+ * on the level its lifetime is kept as the value of g.region_clock
+ * (advanced once per run_regions()) at which it runs out, and
+ * g.region_expiry holds the earliest of those, so run_regions() only
+ * looks for expired regions on the turns when one is due.  ttl itself
+ * is current only when set and at save time.
+ */
+static void
+set_region_ttl(reg, ttl)
+NhRegion *reg;
+long ttl;
+{
+    reg->ttl = ttl;
+    if (ttl >= 0L) {
+        reg->expires = g.region_clock + ttl + 1L;
+        if (reg->expires < g.region_expiry)
+            g.region_expiry = reg->expires;
+    }
+}
+
+/* turns left for reg, or -1 for a permanent one */
+static long
+region_ttl(reg)
+NhRegion *reg;
+{
+    if (reg->ttl < 0L)
+        return reg->ttl;
+    return max(reg->expires - g.region_clock - 1L, 0L);
+}
+
 void
 add_region(reg)
 NhRegion *reg;
@@ -302,6 +424,8 @@ NhRegion *reg;
     }
     g.regions[g.n_regions] = reg;
     g.n_regions++;
+    index_region(reg, 1);
+    set_region_ttl(reg, reg->ttl);
     /* Check for monsters inside the region */
     for (i = reg->bounding_box.lx; i <= reg->bounding_box.hx; i++)
         for (j = reg->bounding_box.ly; j <= reg->bounding_box.hy; j++) {
@@ -339,6 +463,7 @@ NhRegion *reg;
     if (--g.n_regions != i)
         g.regions[i] = g.regions[g.n_regions];
     g.regions[g.n_regions] = (NhRegion *) 0;
+    index_region(reg, -1);
 
     /* Update screen if necessary */
     reg->ttl = -2L; /* for visible_region_at */
@@ -367,6 +492,8 @@ clear_regions()
         free((genericptr_t) g.regions);
     g.max_regions = 0;
     g.regions = (NhRegion **) 0;
+    g.region_expiry = 0L;
+    (void) memset((genericptr_t) g.region_cells, 0, sizeof g.region_cells);
 }
 
 /*
@@ -379,22 +506,39 @@ run_regions()
 {
     register int i, j, k;
     int f_indx;
+    NhRegion *reg;
 
-    /* End of life ? */
-    /* Do it backward because the array will be modified */
-    for (i = g.n_regions - 1; i >= 0; i--) {
-        if (g.regions[i]->ttl == 0L) {
-            if ((f_indx = g.regions[i]->expire_f) == NO_CALLBACK
-                || (*callbacks[f_indx])(g.regions[i], (genericptr_t) 0))
-                remove_region(g.regions[i]);
+    /* Make the regions age; see set_region_ttl() */
+    g.region_clock++;
+
+    /* End of life ?  Only worth a look when some region is due */
+    if (g.region_expiry <= g.region_clock) {
+        g.region_expiry = LONG_MAX;
+        /* Do it backward because the array will be modified */
+        for (i = g.n_regions - 1; i >= 0; i--) {
+            reg = g.regions[i];
+            if (reg->ttl < 0L)
+                continue;
+            if (reg->expires <= g.region_clock) {
+                reg->ttl = 0L;
+                if ((f_indx = reg->expire_f) == NO_CALLBACK
+                    || (*callbacks[f_indx])(reg, (genericptr_t) 0)) {
+                    remove_region(reg);
+                    continue;
+                }
+                /* the callback may have granted it more time; this turn
+                   counts as the first of those */
+                if (reg->ttl < 0L)
+                    continue;
+                reg->expires = g.region_clock + reg->ttl;
+            }
+            if (reg->expires < g.region_expiry)
+                g.region_expiry = reg->expires;
         }
     }
 
     /* Process remaining regions */
     for (i = 0; i < g.n_regions; i++) {
-        /* Make the region age */
-        if (g.regions[i]->ttl > 0L)
-            g.regions[i]->ttl--;
         /* Check if player is inside region */
         f_indx = g.regions[i]->inside_f;
         if (f_indx != NO_CALLBACK && hero_inside(g.regions[i]))
@@ -402,15 +546,16 @@ run_regions()
         /* Check if any monster is inside region */
         if (f_indx != NO_CALLBACK) {
             for (j = 0; j < g.regions[i]->n_monst; j++) {
-                struct monst *mtmp =
-                    find_mid(g.regions[i]->monsters[j], FM_FMON);
+                struct monst *mtmp = region_mon(g.regions[i], j);
 
                 if (!mtmp || DEADMONSTER(mtmp)
                     || (*callbacks[f_indx])(g.regions[i], mtmp)) {
                     /* The monster died, remove it from list */
                     k = (g.regions[i]->n_monst -= 1);
                     g.regions[i]->monsters[j] = g.regions[i]->monsters[k];
+                    g.regions[i]->mptrs[j] = g.regions[i]->mptrs[k];
                     g.regions[i]->monsters[k] = 0;
+                    g.regions[i]->mptrs[k] = (struct monst *) 0;
                     --j; /* current slot has been reused; recheck it next */
                 }
             }
@@ -426,12 +571,13 @@ in_out_region(x, y)
 xchar x, y;
 {
     int i, f_indx = 0;
+    boolean empty = region_cell_empty(x, y);
 
     /* First check if hero can do the move */
     for (i = 0; i < g.n_regions; i++) {
         if (g.regions[i]->attach_2_u)
             continue;
-        if (inside_region(g.regions[i], x, y)
+        if ((!empty && inside_region(g.regions[i], x, y))
             ? (!hero_inside(g.regions[i])
                && (f_indx = g.regions[i]->can_enter_f) != NO_CALLBACK)
             : (hero_inside(g.regions[i])
@@ -446,7 +592,7 @@ xchar x, y;
         if (g.regions[i]->attach_2_u)
             continue;
         if (hero_inside(g.regions[i])
-            && !inside_region(g.regions[i], x, y)) {
+            && (empty || !inside_region(g.regions[i], x, y))) {
             clear_hero_inside(g.regions[i]);
             if (g.regions[i]->leave_msg != (const char *) 0)
                 pline1(g.regions[i]->leave_msg);
@@ -456,10 +602,11 @@ xchar x, y;
     }
 
     /* Callbacks for the regions hero does enter */
+    empty = region_cell_empty(x, y); /* in case a callback added one */
     for (i = 0; i < g.n_regions; i++) {
         if (g.regions[i]->attach_2_u)
             continue;
-        if (!hero_inside(g.regions[i])
+        if (!empty && !hero_inside(g.regions[i])
             && inside_region(g.regions[i], x, y)) {
             set_hero_inside(g.regions[i]);
             if (g.regions[i]->enter_msg != (const char *) 0)
@@ -481,12 +628,13 @@ struct monst *mon;
 xchar x, y;
 {
     int i, f_indx = 0;
+    boolean empty = region_cell_empty(x, y);
 
     /* First check if mon can do the move */
     for (i = 0; i < g.n_regions; i++) {
         if (g.regions[i]->attach_2_m == mon->m_id)
             continue;
-        if (inside_region(g.regions[i], x, y)
+        if ((!empty && inside_region(g.regions[i], x, y))
             ? (!mon_in_region(g.regions[i], mon)
                && (f_indx = g.regions[i]->can_enter_f) != NO_CALLBACK)
             : (mon_in_region(g.regions[i], mon)
@@ -501,7 +649,7 @@ xchar x, y;
         if (g.regions[i]->attach_2_m == mon->m_id)
             continue;
         if (mon_in_region(g.regions[i], mon)
-            && !inside_region(g.regions[i], x, y)) {
+            && (empty || !inside_region(g.regions[i], x, y))) {
             remove_mon_from_reg(g.regions[i], mon);
             if ((f_indx = g.regions[i]->leave_f) != NO_CALLBACK)
                 (void) (*callbacks[f_indx])(g.regions[i], mon);
@@ -509,10 +657,11 @@ xchar x, y;
     }
 
     /* Callbacks for the regions mon does enter */
+    empty = region_cell_empty(x, y); /* in case a callback added one */
     for (i = 0; i < g.n_regions; i++) {
         if (g.regions[i]->attach_2_m == mon->m_id)
             continue;
-        if (!mon_in_region(g.regions[i], mon)
+        if (!empty && !mon_in_region(g.regions[i], mon)
             && inside_region(g.regions[i], x, y)) {
             add_mon_to_reg(g.regions[i], mon);
             if ((f_indx = g.regions[i]->enter_f) != NO_CALLBACK)
@@ -530,9 +679,11 @@ void
 update_player_regions()
 {
     register int i;
+    boolean empty = region_cell_empty(u.ux, u.uy);
 
     for (i = 0; i < g.n_regions; i++)
-        if (!g.regions[i]->attach_2_u && inside_region(g.regions[i], u.ux, u.uy))
+        if (!empty && !g.regions[i]->attach_2_u
+            && inside_region(g.regions[i], u.ux, u.uy))
             set_hero_inside(g.regions[i]);
         else
             clear_hero_inside(g.regions[i]);
@@ -546,9 +697,10 @@ update_monster_region(mon)
 struct monst *mon;
 {
     register int i;
+    boolean empty = region_cell_empty(mon->mx, mon->my);
 
     for (i = 0; i < g.n_regions; i++) {
-        if (inside_region(g.regions[i], mon->mx, mon->my)) {
+        if (!empty && inside_region(g.regions[i], mon->mx, mon->my)) {
             if (!mon_in_region(g.regions[i], mon))
                 add_mon_to_reg(g.regions[i], mon);
         } else {
@@ -558,6 +710,54 @@ struct monst *mon;
     }
 }
 
+/*
+ * A monster is being freed; forget any pointer to it that a region is
+ * holding.  Its id stays listed until run_regions() finds it gone, as
+ * happened before the pointers were kept.
+ */
+void
+forget_region_mon(mon)
+struct monst *mon;
+{
+    int i, j;
+
+    for (i = 0; i < g.n_regions; i++)
+        for (j = 0; j < g.regions[i]->n_monst; j++)
+            if (g.regions[i]->mptrs[j] == mon)
+                g.regions[i]->mptrs[j] = (struct monst *) 0;
+}
+
+/* to support the 'sanity_check' option */
+void
+region_sanity_check()
+{
+    NhRegion *reg;
+    struct monst *mtmp;
+    int i, j, x, y, n;
+
+    for (x = 1; x < COLNO; x++)
+        for (y = 0; y < ROWNO; y++) {
+            for (n = 0, i = 0; i < g.n_regions; i++)
+                if (inside_region(g.regions[i], x, y))
+                    n++;
+            if (n != (int) g.region_cells[x][y])
+                impossible("region sanity: %d regions at <%d,%d>, %u counted",
+                           n, x, y, g.region_cells[x][y]);
+        }
+    for (i = 0; i < g.n_regions; i++) {
+        reg = g.regions[i];
+        for (j = 0; j < reg->n_monst; j++) {
+            mtmp = reg->mptrs[j];
+            if (region_mon_ok(mtmp, reg->monsters[j])
+                && mtmp != find_mid(reg->monsters[j], FM_FMON))
+                impossible("region sanity: monster %u is %s, not %s",
+                           reg->monsters[j], fmt_ptr((genericptr_t) mtmp),
+                           fmt_ptr((genericptr_t) find_mid(reg->monsters[j],
+                                                           FM_FMON)));
+        }
+    }
+}
+
 #if 0
 /* not yet used */
 
@@ -605,6 +805,8 @@ xchar x, y;
 {
     register int i;
 
+    if (region_cell_empty(x, y))
+        return (NhRegion *) 0;
     for (i = 0; i < g.n_regions; i++) {
         if (!g.regions[i]->visible || g.regions[i]->ttl == -2L)
             continue;
@@ -631,6 +833,7 @@ NHFILE *nhfp;
 {
     int i, j;
     unsigned n;
+    long ttl;
 
     if (!perform_bwrite(nhfp))
         goto skip_lots;
@@ -673,8 +876,9 @@ NHFILE *nhfp;
                 bwrite(nhfp->fd, (genericptr_t) g.regions[i]->leave_msg, n);
             }
         }
+        ttl = region_ttl(g.regions[i]);
         if (nhfp->structlevel) {
-            bwrite(nhfp->fd, (genericptr_t) &g.regions[i]->ttl, sizeof (long));
+            bwrite(nhfp->fd, (genericptr_t) &ttl, sizeof (long));
             bwrite(nhfp->fd, (genericptr_t) &g.regions[i]->expire_f, sizeof (short));
             bwrite(nhfp->fd, (genericptr_t) &g.regions[i]->can_enter_f, sizeof (short));
             bwrite(nhfp->fd, (genericptr_t) &g.regions[i]->enter_f, sizeof (short));
@@ -773,6 +977,7 @@ NHFILE *nhfp;
         if (g.regions[i]->ttl >= 0L)
             g.regions[i]->ttl =
 		(g.regions[i]->ttl > tmstamp) ? g.regions[i]->ttl - tmstamp : 0L;
+        set_region_ttl(g.regions[i], g.regions[i]->ttl);
         if (nhfp->structlevel) {
             mread(nhfp->fd, (genericptr_t) &g.regions[i]->expire_f,
                     sizeof (short));
@@ -795,11 +1000,17 @@ NHFILE *nhfp;
         }
         if (nhfp->structlevel)
             mread(nhfp->fd, (genericptr_t) &g.regions[i]->n_monst, sizeof (short));
-        if (g.regions[i]->n_monst > 0)
+        if (g.regions[i]->n_monst > 0) {
             g.regions[i]->monsters =
                         (unsigned *) alloc(sizeof (unsigned) * g.regions[i]->n_monst);
-        else
+            g.regions[i]->mptrs = (struct monst **)
+                        alloc(sizeof (struct monst *) * g.regions[i]->n_monst);
+            (void) memset((genericptr_t) g.regions[i]->mptrs, 0,
+                          sizeof (struct monst *) * g.regions[i]->n_monst);
+        } else {
             g.regions[i]->monsters = (unsigned int *)0;
+            g.regions[i]->mptrs = (struct monst **) 0;
+        }
         g.regions[i]->max_monst = g.regions[i]->n_monst;
         for (j = 0; j < g.regions[i]->n_monst; j++) {
             if (nhfp->structlevel)
@@ -811,6 +1022,7 @@ NHFILE *nhfp;
             mread(nhfp->fd, (genericptr_t) &g.regions[i]->glyph, sizeof (int));
             mread(nhfp->fd, (genericptr_t) &g.regions[i]->arg, sizeof (anything));
         }
+        index_region(g.regions[i], 1);
     }
     /* remove expired regions, do not trigger the expire_f callback (yet!);
        also update monster lists if this data is coming from a bones file */
@@ -843,6 +1055,7 @@ long *count, *size;
         if (rg->leave_msg)
             *size += (long) (strlen(rg->leave_msg) + 1);
         *size += (long) rg->max_monst * (long) sizeof *rg->monsters;
+        *size += (long) rg->max_monst * (long) sizeof *rg->mptrs;
     }
     /* ? */
 }
@@ -859,6 +1072,7 @@ NhRegion *reg;
         if (!lookup_id_mapping(mid_list[i], &mid_list[i])) {
             /* shrink list to remove missing monster; order doesn't matter */
             mid_list[i] = mid_list[--n];
+            reg->mptrs[i] = reg->mptrs[n];
         } else {
             /* move on to next monster */
             ++i;
@@ -42,15 +42,6 @@ static void FDECL(rest_levl, (NHFILE *, BOOLEAN_P));
  * Save a mapping of IDs from ghost levels to the current level.  This
  * map is used by the timer routines when restoring ghost levels.
  */
-#define N_PER_BUCKET 64
-struct bucket {
-    struct bucket *next;
-    struct {
-        unsigned gid; /* ghost ID */
-        unsigned nid; /* new ID */
-    } map[N_PER_BUCKET];
-};
-
 static void NDECL(clear_id_mapping);
 static void FDECL(add_id_mapping, (unsigned, unsigned));
 
@@ -291,6 +282,7 @@ boolean frozen;
             add_id_mapping(otmp->o_id, nid);
             otmp->o_id = nid;
         }
+        register_oid(otmp);
         if (ghostly && otmp->otyp == SLIME_MOLD)
             ghostfruit(otmp);
         /* Ghost levels get object age shifted from old player's clock
@@ -451,6 +443,7 @@ NHFILE *nhfp;
             add_id_mapping(mtmp->m_id, nid);
             mtmp->m_id = nid;
         }
+        register_mid(mtmp);
         offset = mtmp->mnum;
         mtmp->data = &mons[offset];
         if (ghostly) {
@@ -999,6 +992,111 @@ NHFILE *nhfp;
     return 1;
 }
 
+/* replace the game in progress with a snapshot taken by snapshot_game() */
+boolean
+restore_snapshot(data, len)
+genericptr_t data;
+long len;
+{
+    char magic[sizeof SNAPSHOT_MAGIC], whynot[BUFSZ], buf[BUFSIZ];
+    unsigned int stuckid = 0, steedid = 0;
+    NHFILE *nhfp, *lnhfp;
+    struct obj *otmp;
+    int pid = 0;
+    long snapmoves = 0L, snapmonstermoves = 0L, flen;
+    unsigned cnt;
+    xchar ltmp;
+    boolean was_rogue;
+
+    nhfp = open_memfile(data, len);
+    if (!nhfp)
+        return FALSE;
+    restoreinfo.mread_flags = 1; /* return despite error */
+    mread(nhfp->fd, (genericptr_t) magic, sizeof magic);
+    mread(nhfp->fd, (genericptr_t) &pid, sizeof pid);
+    mread(nhfp->fd, (genericptr_t) &snapmoves, sizeof snapmoves);
+    mread(nhfp->fd, (genericptr_t) &snapmonstermoves, sizeof snapmonstermoves);
+    if (restoreinfo.mread_flags == -1
+        || strncmp(magic, SNAPSHOT_MAGIC, sizeof magic) || pid != g.hackpid) {
+        restoreinfo.mread_flags = 0;
+        close_nhfile(nhfp);
+        return FALSE;
+    }
+    restoreinfo.mread_flags = 0;
+
+    was_rogue = Is_rogue_level(&u.uz);
+    discard_game();
+
+    g.restoring = TRUE;
+    /* no time passes for the current level, and its monsters don't
+       get any catch-up movement */
+    g.moves = snapmoves;
+    g.monstermoves = snapmonstermoves;
+    u.uz.dnum = u.uz.dlevel = 0;
+    getlev(nhfp, 0, (xchar) 0);
+    if (!restgamestate(nhfp, &stuckid, &steedid))
+        panic("Cannot restore game snapshot.");
+    restlevelstate(stuckid, steedid);
+    /* objects and monsters on the current level were restored before
+       the context which refers to them */
+    if (g.context.victual.o_id && !g.context.victual.piece)
+        g.context.victual.piece = find_oid(g.context.victual.o_id);
+    if (g.context.tin.o_id && !g.context.tin.tin)
+        g.context.tin.tin = find_oid(g.context.tin.o_id);
+    if (g.context.spbook.o_id && !g.context.spbook.book)
+        g.context.spbook.book = find_oid(g.context.spbook.o_id);
+    if (g.context.polearm.m_id && !g.context.polearm.hitmon)
+        g.context.polearm.hitmon = find_mid(g.context.polearm.m_id, FM_FMON);
+    mread(nhfp->fd, (genericptr_t) &g.youmonst.movement,
+          sizeof g.youmonst.movement);
+
+    /* the other levels go back into level files just as they were */
+    for (;;) {
+        mread(nhfp->fd, (genericptr_t) &ltmp, sizeof ltmp);
+        if (!ltmp)
+            break;
+        mread(nhfp->fd, (genericptr_t) &flen, sizeof flen);
+        lnhfp = create_levelfile(ltmp, whynot);
+        if (!lnhfp)
+            panic("%s", whynot);
+        for (; flen > 0L; flen -= (long) cnt) {
+            cnt = (unsigned) min(flen, (long) sizeof buf);
+            mread(nhfp->fd, (genericptr_t) buf, cnt);
+            bwrite(lnhfp->fd, (genericptr_t) buf, cnt);
+        }
+        close_nhfile(lnhfp);
+    }
+    /* last, so that nothing above perturbs the random number sequence */
+    restore_rngstate(nhfp);
+    close_nhfile(nhfp);
+#ifdef INSURANCE
+    savestateinlock();
+#endif
+
+    if (Is_rogue_level(&u.uz))
+        assign_graphics(ROGUESET);
+    else if (was_rogue)
+        assign_graphics(PRIMARY);
+#ifdef USE_TILES
+    substitute_tiles(&u.uz);
+#endif
+    max_rank_sz();
+    /* take care of iron ball & chain */
+    for (otmp = fobj; otmp; otmp = otmp->nobj)
+        if (otmp->owornmask)
+            setworn(otmp, otmp->owornmask);
+    initrack();
+    reglyph_darkroom();
+    vision_reset();
+    g.vision_full_recalc = 1;
+    g.defer_see_monsters = FALSE;
+    docrt();
+    g.context.botlx = TRUE;
+    update_inventory();
+    g.restoring = FALSE;
+    return TRUE;
+}
+
 void
 restcemetery(nhfp, cemeteryaddr)
 NHFILE *nhfp;
@@ -1096,6 +1194,7 @@ xchar lev;
 
     if (ghostly)
         clear_id_mapping();
+    g.travel_gen++; /* findtravelpath()'s saved searches are for another map */
 
 #if defined(MSDOS) || defined(OS2)
     if (nhfp->structlevel)
@@ -1166,6 +1265,9 @@ xchar lev;
     rest_worm(nhfp);    /* restore worm information */
 
     g.ftrap = 0;
+    for (x = 0; x < COLNO; x++)
+        for (y = 0; y < ROWNO; y++)
+            g.level.traps[x][y] = (struct trap *) 0;
     for (;;) {
         trap = newtrap();
         if (nhfp->structlevel)
@@ -1173,6 +1275,7 @@ xchar lev;
         if (trap->tx != 0) {
             trap->ntrap = g.ftrap;
             g.ftrap = trap;
+            g.level.traps[trap->tx][trap->ty] = trap;
         } else
             break;
     }
@@ -1325,13 +1428,7 @@ NHFILE *nhfp;
 static void
 clear_id_mapping()
 {
-    struct bucket *curr;
-
-    while ((curr = g.id_map) != 0) {
-        g.id_map = curr->next;
-        free((genericptr_t) curr);
-    }
-    g.n_ids_mapped = 0;
+    idmap_free(&g.id_map);
 }
 
 /* Add a mapping to the ID map. */
@@ -1339,20 +1436,11 @@ static void
 add_id_mapping(gid, nid)
 unsigned gid, nid;
 {
-    int idx;
-
-    idx = g.n_ids_mapped % N_PER_BUCKET;
-    /* idx is zero on first time through, as well as when a new bucket is */
-    /* needed */
-    if (idx == 0) {
-        struct bucket *gnu = (struct bucket *) alloc(sizeof(struct bucket));
-        gnu->next = g.id_map;
-        g.id_map = gnu;
-    }
+    anything val;
 
-    g.id_map->map[idx].gid = gid;
-    g.id_map->map[idx].nid = nid;
-    g.n_ids_mapped++;
+    val = cg.zeroany;
+    val.a_uint = nid;
+    idmap_set(&g.id_map, gid, &val);
 }
 
 /*
@@ -1364,26 +1452,12 @@ boolean
 lookup_id_mapping(gid, nidp)
 unsigned gid, *nidp;
 {
-    int i;
-    struct bucket *curr;
-
-    if (g.n_ids_mapped)
-        for (curr = g.id_map; curr; curr = curr->next) {
-            /* first bucket might not be totally full */
-            if (curr == g.id_map) {
-                i = g.n_ids_mapped % N_PER_BUCKET;
-                if (i == 0)
-                    i = N_PER_BUCKET;
-            } else
-                i = N_PER_BUCKET;
-
-            while (--i >= 0)
-                if (gid == curr->map[i].gid) {
-                    *nidp = curr->map[i].nid;
-                    return TRUE;
-                }
-        }
+    anything *val = idmap_get(&g.id_map, gid);
 
+    if (val) {
+        *nidp = val->a_uint;
+        return TRUE;
+    }
     return FALSE;
 }
 
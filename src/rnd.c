@@ -239,4 +239,53 @@ int i;
     return (int) x;
 }
 
+/* save the generators' internal state, for game snapshots; nothing is
+   saved when the system's own generator is in use, so a restored
+   snapshot only repeats the original game's sequence with ISAAC64 */
+void
+save_rngstate(nhfp)
+NHFILE *nhfp;
+{
+#ifdef USE_ISAAC64
+    int i;
+
+    if (nhfp->structlevel)
+        for (i = 0; i < SIZE(rnglist); ++i)
+            bwrite(nhfp->fd, (genericptr_t) &rnglist[i].rng_state,
+                   sizeof rnglist[i].rng_state);
+#else
+    nhUse(nhfp);
+#endif
+}
+
+void
+restore_rngstate(nhfp)
+NHFILE *nhfp;
+{
+#ifdef USE_ISAAC64
+    int i;
+
+    if (nhfp->structlevel)
+        for (i = 0; i < SIZE(rnglist); ++i)
+            mread(nhfp->fd, (genericptr_t) &rnglist[i].rng_state,
+                  sizeof rnglist[i].rng_state);
+#else
+    nhUse(nhfp);
+#endif
+}
+
+/* how many numbers the main generator has produced since it was seeded;
+   used to tell whether two runs of a game stayed in step */
+unsigned long
+rng_position()
+{
+#ifdef USE_ISAAC64
+    isaac64_ctx *ctx = &rnglist[CORE].rng_state;
+
+    return (unsigned long) (ctx->c * ISAAC64_SZ - ctx->n);
+#else
+    return 0L;
+#endif
+}
+
 /*rnd.c*/
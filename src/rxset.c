@@ -0,0 +1,920 @@
+/* NetHack 3.7	rxset.c	$NHDT-Date$  $NHDT-Branch$:$NHDT-Revision$ */
+/* Copyright (c) NetHack Development Team 2020.                   */
+/* NetHack may be freely redistributed.  See license for details. */
+
+#include "hack.h"
+#include <ctype.h> /* for the character classes */
+
+/*
+ * Sets of regular expressions (MSGTYPE, MENUCOLOR, autopickup exceptions,
+ * sound mappings) which are tried against the same string, where what's
+ * wanted is the first one that matches.  Instead of running each pattern
+ * through regex_match() in turn, patterns written in the common subset
+ * of POSIX extended syntax are compiled together into one automaton that
+ * finds all of their matches in a single pass over the string.  Its
+ * states are sets of positions in a combined NFA and are only created as
+ * strings reach them, so the set stays cheap however many patterns it
+ * has.  Patterns using anything else (back-references, collating
+ * elements, escapes that some regex libraries treat specially, and
+ * constructs whose meaning isn't agreed on) are left to regex_match(),
+ * as is everything when the regex library in use doesn't implement
+ * POSIX syntax.
+ */
+
+extern const char regex_id[]; /* which regex library is linked in */
+
+#define RXN_CHAR 0  /* match a byte in sets[arg], then go to out */
+#define RXN_SPLIT 1 /* go to both out and out2 */
+#define RXN_BOL 2   /* only at start of string, then go to out */
+#define RXN_EOL 3   /* only at end of string, then go to out */
+#define RXN_MATCH 4 /* pattern arg has matched */
+
+struct rxnode {
+    int type, arg, out, out2;
+};
+
+/* parsed pattern, before it's turned into NFA nodes */
+#define RXT_SET 0 /* a is a char set */
+#define RXT_CAT 1 /* a then b */
+#define RXT_ALT 2 /* a or b */
+#define RXT_REP 3 /* a, min to max times (max < 0: unlimited) */
+#define RXT_BOL 4
+#define RXT_EOL 5
+
+struct rxtree {
+    int type, a, b, min, max;
+};
+
+struct rxstate {
+    int *nfa, nnfa; /* NFA nodes, sorted; identifies the state */
+    int *acc, nacc; /* patterns matched on arriving here */
+    int *eacc, neacc; /* patterns matched if the string ends here */
+    int *next;      /* state after each byte class, or -1 */
+    unsigned hash;
+};
+
+#define RXA_MAXSTATES 512  /* states kept before starting over */
+#define RXA_HASHSIZE 1024  /* 2 * RXA_MAXSTATES */
+#define RXA_PATNODES 4000  /* limit on one pattern's NFA nodes */
+#define RXA_PATTREE 1000   /* limit on one pattern's parse tree */
+
+struct rxset_auto {
+    struct rxnode *nodes;
+    int nnodes, maxnodes;
+    unsigned char (*sets)[32]; /* bitmaps of bytes */
+    int nsets, maxsets;
+    int *starts; /* first node of each pattern */
+    int nstarts, maxstarts;
+    struct rxtree *tree; /* parse scratch */
+    int ntree, maxtree;
+    const char *p;
+    int anchors;         /* '^' and '$' parsed so far */
+    /* the rest is built when the first string is matched */
+    boolean ready;
+    unsigned char classof[256], repr[256]; /* bytes which behave alike */
+    int nclasses;
+    struct rxstate *states;
+    int nstates, start0;
+    int table[RXA_HASHSIZE]; /* state + 1, or 0 */
+    unsigned *mark;                /* closure scratch */
+    int *stack, *seeds, *found;
+    unsigned stamp;
+};
+
+#define RX_ULBITS ((int) (8 * sizeof (unsigned long)))
+#define rx_inset(set, c) (((set)[(c) >> 3] & (1 << ((c) & 7))) != 0)
+
+static genericptr_t FDECL(rx_grow, (genericptr_t, unsigned, unsigned));
+static int FDECL(rxa_tree, (struct rxset_auto *, int, int, int));
+static int FDECL(rxa_set, (struct rxset_auto *));
+static int FDECL(rxa_class, (const char *, int));
+static int FDECL(rxa_bracket, (struct rxset_auto *));
+static int FDECL(rxa_atom, (struct rxset_auto *));
+static int FDECL(rxa_cat, (struct rxset_auto *));
+static int FDECL(rxa_alt, (struct rxset_auto *));
+static int FDECL(rxa_node, (struct rxset_auto *, int, int, int, int));
+static int FDECL(rxa_emit, (struct rxset_auto *, int, int, int));
+static boolean FDECL(rxa_compile, (struct rxset_auto *, const char *, int));
+static void FDECL(rxa_flush, (struct rxset_auto *));
+static void FDECL(rxa_unprepare, (struct rxset_auto *));
+static void FDECL(rxa_prepare, (struct rxset_auto *));
+static int FDECL(rxa_closure, (struct rxset_auto *, int, unsigned));
+static int FDECL(rxa_state, (struct rxset_auto *, int *, int));
+static int FDECL(rxa_step, (struct rxset_auto *, int, int));
+static void FDECL(rxa_endacc, (struct rxset_auto *, int, unsigned,
+                               unsigned long *));
+static void FDECL(rxa_run, (struct rxset_auto *, const char *,
+                            unsigned long *));
+
+/* a new block of 'size' bytes holding the first 'used' bytes of 'old',
+   which is freed */
+static genericptr_t
+rx_grow(old, used, size)
+genericptr_t old;
+unsigned used, size;
+{
+    genericptr_t newp = (genericptr_t) alloc(size);
+
+    if (old) {
+        (void) memcpy(newp, old, used);
+        free(old);
+    }
+    return newp;
+}
+
+static int
+rxa_tree(rxa, type, a, b)
+struct rxset_auto *rxa;
+int type, a, b;
+{
+    struct rxtree *t;
+
+    if (a < 0 || rxa->ntree >= RXA_PATTREE)
+        return -1;
+    if (rxa->ntree >= rxa->maxtree) {
+        rxa->maxtree = rxa->maxtree ? 2 * rxa->maxtree : 64;
+        rxa->tree = (struct rxtree *)
+            rx_grow((genericptr_t) rxa->tree,
+                    (unsigned) (rxa->ntree * sizeof *rxa->tree),
+                    (unsigned) (rxa->maxtree * sizeof *rxa->tree));
+    }
+    t = &rxa->tree[rxa->ntree];
+    t->type = type, t->a = a, t->b = b;
+    t->min = t->max = 0;
+    return rxa->ntree++;
+}
+
+/* new empty set of bytes; returns its index */
+static int
+rxa_set(rxa)
+struct rxset_auto *rxa;
+{
+    if (rxa->nsets >= rxa->maxsets) {
+        rxa->maxsets = rxa->maxsets ? 2 * rxa->maxsets : 64;
+        rxa->sets = (unsigned char (*)[32])
+            rx_grow((genericptr_t) rxa->sets,
+                    (unsigned) (rxa->nsets * sizeof *rxa->sets),
+                    (unsigned) (rxa->maxsets * sizeof *rxa->sets));
+    }
+    (void) memset((genericptr_t) rxa->sets[rxa->nsets], 0,
+                  sizeof *rxa->sets);
+    return rxa->nsets++;
+}
+
+/* is c in the character class named by the start of s ("alpha:]")? */
+static int
+rxa_class(s, c)
+const char *s;
+int c;
+{
+    static const char *const names[] = {
+        "alpha", "digit", "alnum", "upper", "lower", "space",
+        "blank", "punct", "print", "graph", "cntrl", "xdigit",
+    };
+    int i;
+
+    for (i = 0; i < SIZE(names); i++)
+        if (!strncmp(s, names[i], strlen(names[i]))
+            && !strncmp(s + strlen(names[i]), ":]", 2))
+            break;
+    switch (i) {
+    case 0: return isalpha(c) != 0;
+    case 1: return isdigit(c) != 0;
+    case 2: return isalnum(c) != 0;
+    case 3: return isupper(c) != 0;
+    case 4: return islower(c) != 0;
+    case 5: return isspace(c) != 0;
+    case 6: return (c == ' ' || c == '\t');
+    case 7: return ispunct(c) != 0;
+    case 8: return isprint(c) != 0;
+    case 9: return isgraph(c) != 0;
+    case 10: return iscntrl(c) != 0;
+    case 11: return isxdigit(c) != 0;
+    default: return -1; /* unknown class */
+    }
+}
+
+/* [...] with rxa->p just past the '['; returns a tree node */
+static int
+rxa_bracket(rxa)
+struct rxset_auto *rxa;
+{
+    const char *p = rxa->p;
+    boolean negate = FALSE, first = TRUE;
+    int c, lo, hi, s = rxa_set(rxa);
+    unsigned char *set = rxa->sets[s];
+
+    if (*p == '^')
+        negate = TRUE, ++p;
+    for (;; first = FALSE) {
+        lo = (uchar) *p;
+        if (!lo || lo == '\\')
+            return -1;
+        if (lo == ']' && !first) {
+            ++p;
+            break;
+        }
+        if (lo == '[' && (p[1] == '=' || p[1] == '.'))
+            return -1; /* equivalence class or collating element */
+        if (lo == '[' && p[1] == ':') {
+            if (rxa_class(p + 2, 'a') < 0)
+                return -1;
+            for (c = 1; c < 256; c++)
+                if (rxa_class(p + 2, c))
+                    set[c >> 3] |= 1 << (c & 7);
+            p = index(p + 2, ':') + 2;
+            continue;
+        }
+        /* a '-' which is neither first nor last has no agreed meaning */
+        if (lo == '-' && !first && p[1] != ']')
+            return -1;
+        hi = lo;
+        if (p[1] == '-' && p[2] && p[2] != ']') {
+            hi = (uchar) p[2];
+            if (hi == '[' || hi == '\\' || hi < lo)
+                return -1;
+            p += 2;
+        }
+        ++p;
+        for (c = lo; c <= hi; c++)
+            set[c >> 3] |= 1 << (c & 7);
+    }
+    if (negate)
+        for (c = 0; c < 32; c++)
+            set[c] = ~set[c];
+    set[0] &= ~1; /* never matches the terminator */
+    rxa->p = p;
+    return rxa_tree(rxa, RXT_SET, s, -1);
+}
+
+/* one atom, followed by at most one repetition operator */
+static int
+rxa_atom(rxa)
+struct rxset_auto *rxa;
+{
+    int c = (uchar) *rxa->p++, t, s, lo, hi, anchors = rxa->anchors;
+
+    switch (c) {
+    case '(':
+        t = rxa_alt(rxa);
+        if (t < 0 || *rxa->p++ != ')')
+            return -1;
+        break;
+    case '^':
+        rxa->anchors++;
+        return rxa_tree(rxa, RXT_BOL, 0, -1);
+    case '$':
+        rxa->anchors++;
+        return rxa_tree(rxa, RXT_EOL, 0, -1);
+    case '[':
+        t = rxa_bracket(rxa);
+        break;
+    case '.':
+        s = rxa_set(rxa);
+        (void) memset((genericptr_t) rxa->sets[s], 0xff, sizeof *rxa->sets);
+        rxa->sets[s][0] &= ~1;
+        t = rxa_tree(rxa, RXT_SET, s, -1);
+        break;
+    case '*':
+    case '+':
+    case '?':
+    case '{':
+    case ')':
+    case '|':
+        return -1; /* nothing to repeat, or unbalanced */
+    case '\\':
+        /* escaped punctuation is literal; letters and digits after a
+           backslash mean different things to different libraries */
+        c = (uchar) *rxa->p++;
+        if (!c || isalnum(c))
+            return -1;
+        /*FALLTHRU*/
+    default:
+        s = rxa_set(rxa);
+        rxa->sets[s][c >> 3] |= 1 << (c & 7);
+        t = rxa_tree(rxa, RXT_SET, s, -1);
+        break;
+    }
+    if (t < 0)
+        return -1;
+    switch (*rxa->p) {
+    case '*':
+        lo = 0, hi = -1;
+        break;
+    case '+':
+        lo = 1, hi = -1;
+        break;
+    case '?':
+        lo = 0, hi = 1;
+        break;
+    case '{':
+        if (!digit(rxa->p[1]))
+            return -1;
+        for (lo = 0; digit(*++rxa->p) && lo <= 255; )
+            lo = 10 * lo + *rxa->p - '0';
+        hi = lo;
+        if (*rxa->p == ',') {
+            hi = -1;
+            if (digit(rxa->p[1]))
+                for (hi = 0; digit(*++rxa->p) && hi <= 255; )
+                    hi = 10 * hi + *rxa->p - '0';
+            else
+                ++rxa->p;
+        }
+        if (*rxa->p != '}' || lo > 255 || hi > 255 || (hi >= 0 && hi < lo))
+            return -1;
+        break;
+    default:
+        return t;
+    }
+    ++rxa->p;
+    /* repeating a repetition or an anchor is left to the library; not
+       all of them agree about what it means */
+    if ((*rxa->p && index("*+?{", *rxa->p)) || rxa->anchors != anchors)
+        return -1;
+    t = rxa_tree(rxa, RXT_REP, t, -1);
+    if (t >= 0)
+        rxa->tree[t].min = lo, rxa->tree[t].max = hi;
+    return t;
+}
+
+/* a sequence of atoms, at least one */
+static int
+rxa_cat(rxa)
+struct rxset_auto *rxa;
+{
+    int t = -1, u;
+
+    while (*rxa->p && *rxa->p != '|' && *rxa->p != ')') {
+        if ((u = rxa_atom(rxa)) < 0)
+            return -1;
+        t = (t < 0) ? u : rxa_tree(rxa, RXT_CAT, t, u);
+        if (t < 0)
+            return -1;
+    }
+    return t; /* -1 for an empty alternative */
+}
+
+/* alternatives separated by '|' */
+static int
+rxa_alt(rxa)
+struct rxset_auto *rxa;
+{
+    int t = rxa_cat(rxa), u;
+
+    while (t >= 0 && *rxa->p == '|') {
+        ++rxa->p;
+        if ((u = rxa_cat(rxa)) < 0)
+            return -1;
+        t = rxa_tree(rxa, RXT_ALT, t, u);
+    }
+    return t;
+}
+
+/* add an NFA node; returns its index, or -2 if out or out2 is -2 because
+   the pattern has grown too big */
+static int
+rxa_node(rxa, type, arg, out, out2)
+struct rxset_auto *rxa;
+int type, arg, out, out2;
+{
+    struct rxnode *n;
+
+    if (out < -1 || out2 < -1)
+        return -2;
+    if (rxa->nnodes >= rxa->maxnodes) {
+        rxa->maxnodes = rxa->maxnodes ? 2 * rxa->maxnodes : 256;
+        rxa->nodes = (struct rxnode *)
+            rx_grow((genericptr_t) rxa->nodes,
+                    (unsigned) (rxa->nnodes * sizeof *rxa->nodes),
+                    (unsigned) (rxa->maxnodes * sizeof *rxa->nodes));
+    }
+    n = &rxa->nodes[rxa->nnodes];
+    n->type = type, n->arg = arg, n->out = out, n->out2 = out2;
+    return rxa->nnodes++;
+}
+
+/* NFA nodes for tree t, continuing at node next; returns the first one,
+   or -2 if the pattern needs more than RXA_PATNODES nodes */
+static int
+rxa_emit(rxa, t, next, limit)
+struct rxset_auto *rxa;
+int t, next, limit;
+{
+    struct rxtree tr;
+    int i, s, loop;
+
+    if (next < 0 || rxa->nnodes > limit)
+        return -2;
+    tr = rxa->tree[t];
+    switch (tr.type) {
+    case RXT_SET:
+        return rxa_node(rxa, RXN_CHAR, tr.a, next, -1);
+    case RXT_CAT:
+        return rxa_emit(rxa, tr.a, rxa_emit(rxa, tr.b, next, limit), limit);
+    case RXT_ALT:
+        s = rxa_emit(rxa, tr.a, next, limit);
+        return rxa_node(rxa, RXN_SPLIT, 0, s,
+                        rxa_emit(rxa, tr.b, next, limit));
+    case RXT_BOL:
+        return rxa_node(rxa, RXN_BOL, 0, next, -1);
+    case RXT_EOL:
+        return rxa_node(rxa, RXN_EOL, 0, next, -1);
+    case RXT_REP:
+        if (tr.max < 0) {
+            if ((loop = rxa_node(rxa, RXN_SPLIT, 0, -1, next)) < 0
+                || (s = rxa_emit(rxa, tr.a, loop, limit)) < 0)
+                return -2;
+            rxa->nodes[loop].out = s;
+            s = loop;
+        } else {
+            for (s = next, i = tr.min; i < tr.max && s >= 0; i++)
+                s = rxa_node(rxa, RXN_SPLIT, 0,
+                             rxa_emit(rxa, tr.a, s, limit), next);
+        }
+        for (i = 0; i < tr.min && s >= 0; i++)
+            s = rxa_emit(rxa, tr.a, s, limit);
+        return (s < 0) ? -2 : s;
+    }
+    return -2;
+}
+
+/* add pattern number pat to the automaton, if it can be handled there */
+static boolean
+rxa_compile(rxa, pattern, pat)
+struct rxset_auto *rxa;
+const char *pattern;
+int pat;
+{
+    int root, start, nnodes = rxa->nnodes, nsets = rxa->nsets;
+
+    rxa->ntree = 0;
+    rxa->anchors = 0;
+    rxa->p = pattern;
+    root = rxa_alt(rxa);
+    start = -2;
+    if (root >= 0 && !*rxa->p)
+        start = rxa_emit(rxa, root, rxa_node(rxa, RXN_MATCH, pat, -1, -1),
+                         nnodes + RXA_PATNODES);
+    if (start < 0) {
+        /* forget whatever was added for it */
+        rxa->nnodes = nnodes, rxa->nsets = nsets;
+        return FALSE;
+    }
+    if (rxa->nstarts >= rxa->maxstarts) {
+        rxa->maxstarts = rxa->maxstarts ? 2 * rxa->maxstarts : 32;
+        rxa->starts = (int *)
+            rx_grow((genericptr_t) rxa->starts,
+                    (unsigned) (rxa->nstarts * sizeof (int)),
+                    (unsigned) (rxa->maxstarts * sizeof (int)));
+    }
+    rxa->starts[rxa->nstarts++] = start;
+    rxa_unprepare(rxa);
+    return TRUE;
+}
+
+/* throw away the states found so far */
+static void
+rxa_flush(rxa)
+struct rxset_auto *rxa;
+{
+    struct rxstate *st;
+    int i;
+
+    for (i = 0; i < rxa->nstates; i++) {
+        st = &rxa->states[i];
+        free((genericptr_t) st->nfa);
+        if (st->acc)
+            free((genericptr_t) st->acc);
+        if (st->eacc)
+            free((genericptr_t) st->eacc);
+        free((genericptr_t) st->next);
+    }
+    rxa->nstates = 0;
+    rxa->start0 = -1;
+    (void) memset((genericptr_t) rxa->table, 0, sizeof rxa->table);
+}
+
+/* discard everything built for matching; patterns have been added */
+static void
+rxa_unprepare(rxa)
+struct rxset_auto *rxa;
+{
+    if (!rxa->ready)
+        return;
+    rxa_flush(rxa);
+    free((genericptr_t) rxa->states);
+    free((genericptr_t) rxa->mark);
+    free((genericptr_t) rxa->stack);
+    free((genericptr_t) rxa->seeds);
+    free((genericptr_t) rxa->found);
+    rxa->ready = FALSE;
+}
+
+/* get ready to match strings against the patterns added so far */
+static void
+rxa_prepare(rxa)
+struct rxset_auto *rxa;
+{
+    unsigned char newclass[256];
+    int remap[2 * 256], i, c, k, n = rxa->nnodes;
+
+    /* bytes which are in exactly the same sets are interchangeable */
+    (void) memset((genericptr_t) rxa->classof, 0, sizeof rxa->classof);
+    rxa->nclasses = 1;
+    for (i = 0; i < rxa->nsets; i++) {
+        for (k = 0; k < 2 * rxa->nclasses; k++)
+            remap[k] = -1;
+        for (k = c = 0; c < 256; c++) {
+            int key = 2 * rxa->classof[c] + rx_inset(rxa->sets[i], c);
+
+            if (remap[key] < 0)
+                remap[key] = k++;
+            newclass[c] = (unsigned char) remap[key];
+        }
+        (void) memcpy((genericptr_t) rxa->classof, (genericptr_t) newclass,
+                      sizeof newclass);
+        rxa->nclasses = k;
+    }
+    for (c = 255; c >= 0; c--)
+        rxa->repr[rxa->classof[c]] = (unsigned char) c;
+
+    rxa->states = (struct rxstate *) alloc(RXA_MAXSTATES
+                                           * sizeof *rxa->states);
+    rxa->mark = (unsigned *) alloc((unsigned) (n + 1) * sizeof (unsigned));
+    (void) memset((genericptr_t) rxa->mark, 0, (size_t) n * sizeof (unsigned));
+    rxa->stack = (int *) alloc((unsigned) (n + 1) * sizeof (int));
+    rxa->seeds = (int *) alloc((unsigned) (n + rxa->nstarts + 1)
+                               * sizeof (int));
+    rxa->found = (int *) alloc((unsigned) (n + 1) * sizeof (int));
+    rxa->stamp = 0;
+    rxa->nstates = 0;
+    rxa->ready = TRUE;
+    rxa_flush(rxa);
+}
+
+#define RXC_BOL 1 /* at start of string */
+#define RXC_EOL 2 /* at end of string */
+
+/* nodes reachable without consuming anything from the nseeds nodes in
+   rxa->seeds; leaves them, sorted, in rxa->found and returns how many */
+static int
+rxa_closure(rxa, nseeds, flags)
+struct rxset_auto *rxa;
+int nseeds;
+unsigned flags;
+{
+    struct rxnode *nd;
+    int i, j, x, sp = 0, n = 0;
+
+#define rxa_push(nx) \
+    do {                                                                \
+        if ((nx) >= 0 && rxa->mark[nx] != rxa->stamp) {                \
+            rxa->mark[nx] = rxa->stamp;                                \
+            rxa->stack[sp++] = (nx);                                   \
+        }                                                               \
+    } while (0)
+
+    if (!++rxa->stamp) {
+        (void) memset((genericptr_t) rxa->mark, 0,
+                      (size_t) rxa->nnodes * sizeof (unsigned));
+        rxa->stamp = 1;
+    }
+    for (i = 0; i < nseeds; i++)
+        rxa_push(rxa->seeds[i]);
+    while (sp > 0) {
+        x = rxa->stack[--sp];
+        nd = &rxa->nodes[x];
+        switch (nd->type) {
+        case RXN_SPLIT:
+            rxa_push(nd->out2);
+            rxa_push(nd->out);
+            break;
+        case RXN_BOL:
+            /* once past the start of the string it never matches */
+            if (flags & RXC_BOL)
+                rxa_push(nd->out);
+            break;
+        case RXN_EOL:
+            if (flags & RXC_EOL)
+                rxa_push(nd->out);
+            else
+                rxa->found[n++] = x;
+            break;
+        default:
+            rxa->found[n++] = x;
+            break;
+        }
+    }
+#undef rxa_push
+    /* insertion sort; the nodes tend to come out nearly in order */
+    for (i = 1; i < n; i++) {
+        x = rxa->found[i];
+        for (j = i; j > 0 && rxa->found[j - 1] > x; j--)
+            rxa->found[j] = rxa->found[j - 1];
+        rxa->found[j] = x;
+    }
+    return n;
+}
+
+/* the state made of the n nodes in nfa[]; returns -1 if there's no room
+   for another one */
+static int
+rxa_state(rxa, nfa, n)
+struct rxset_auto *rxa;
+int *nfa, n;
+{
+    struct rxstate *st;
+    unsigned h = 2166136261U;
+    int i, slot, nacc;
+
+    for (i = 0; i < n; i++)
+        h = (h ^ (unsigned) nfa[i]) * 16777619U;
+    for (slot = (int) (h & (RXA_HASHSIZE - 1)); rxa->table[slot];
+         slot = (slot + 1) & (RXA_HASHSIZE - 1)) {
+        st = &rxa->states[rxa->table[slot] - 1];
+        if (st->hash == h && st->nnfa == n
+            && !memcmp((genericptr_t) st->nfa, (genericptr_t) nfa,
+                       (size_t) n * sizeof (int)))
+            return rxa->table[slot] - 1;
+    }
+    if (rxa->nstates >= RXA_MAXSTATES)
+        return -1;
+    st = &rxa->states[rxa->nstates];
+    st->hash = h;
+    st->nnfa = n;
+    st->nfa = (int *) alloc((unsigned) (n + 1) * sizeof (int));
+    (void) memcpy((genericptr_t) st->nfa, (genericptr_t) nfa,
+                  (size_t) n * sizeof (int));
+    for (nacc = i = 0; i < n; i++)
+        if (rxa->nodes[nfa[i]].type == RXN_MATCH)
+            nacc++;
+    st->nacc = nacc;
+    st->acc = nacc ? (int *) alloc((unsigned) nacc * sizeof (int)) : 0;
+    for (nacc = i = 0; i < n; i++)
+        if (rxa->nodes[nfa[i]].type == RXN_MATCH)
+            st->acc[nacc++] = rxa->nodes[nfa[i]].arg;
+    st->eacc = (int *) 0;
+    st->neacc = -1; /* not known yet */
+    st->next = (int *) alloc((unsigned) rxa->nclasses * sizeof (int));
+    for (i = 0; i < rxa->nclasses; i++)
+        st->next[i] = -1;
+    rxa->table[slot] = ++rxa->nstates;
+    return rxa->nstates - 1;
+}
+
+/* the state after state s sees a byte of class cls, or -1 if it's new
+   and there's no room for it */
+static int
+rxa_step(rxa, s, cls)
+struct rxset_auto *rxa;
+int s, cls;
+{
+    struct rxstate *st = &rxa->states[s];
+    struct rxnode *nd;
+    int c = rxa->repr[cls], i, n = 0, t;
+
+    for (i = 0; i < st->nnfa; i++) {
+        nd = &rxa->nodes[st->nfa[i]];
+        if (nd->type == RXN_CHAR && rx_inset(rxa->sets[nd->arg], c))
+            rxa->seeds[n++] = nd->out;
+    }
+    /* any pattern can also start a match at the next byte */
+    for (i = 0; i < rxa->nstarts; i++)
+        rxa->seeds[n++] = rxa->starts[i];
+    n = rxa_closure(rxa, n, 0);
+    if ((t = rxa_state(rxa, rxa->found, n)) >= 0)
+        rxa->states[s].next[cls] = t;
+    return t;
+}
+
+/* add to hits the patterns which match if the string ends in state s */
+static void
+rxa_endacc(rxa, s, flags, hits)
+struct rxset_auto *rxa;
+int s;
+unsigned flags;
+unsigned long *hits;
+{
+    struct rxstate *st = &rxa->states[s];
+    int i, n = 0, nacc = 0, *acc;
+
+    if (st->neacc < 0 || (flags & RXC_BOL)) {
+        for (i = 0; i < st->nnfa; i++)
+            if (rxa->nodes[st->nfa[i]].type == RXN_EOL)
+                rxa->seeds[n++] = st->nfa[i];
+        n = n ? rxa_closure(rxa, n, flags | RXC_EOL) : 0;
+        for (i = 0; i < n; i++)
+            if (rxa->nodes[rxa->found[i]].type == RXN_MATCH)
+                rxa->found[nacc++] = rxa->nodes[rxa->found[i]].arg;
+        if (flags & RXC_BOL) {
+            /* empty string; not worth remembering */
+            for (i = 0; i < nacc; i++)
+                hits[rxa->found[i] / RX_ULBITS] |=
+                    1UL << (rxa->found[i] % RX_ULBITS);
+            return;
+        }
+        st->neacc = nacc;
+        if (nacc) {
+            st->eacc = (int *) alloc((unsigned) nacc * sizeof (int));
+            (void) memcpy((genericptr_t) st->eacc, (genericptr_t) rxa->found,
+                          (size_t) nacc * sizeof (int));
+        }
+    }
+    for (acc = st->eacc, i = 0; i < st->neacc; i++)
+        hits[acc[i] / RX_ULBITS] |= 1UL << (acc[i] % RX_ULBITS);
+}
+
+/* set the bits in hits for the patterns which match somewhere in s */
+static void
+rxa_run(rxa, s, hits)
+struct rxset_auto *rxa;
+const char *s;
+unsigned long *hits;
+{
+    struct rxstate *st;
+    const char *p;
+    int cur, nx, i, n, *keep;
+
+    if (!rxa->ready)
+        rxa_prepare(rxa);
+    if (rxa->start0 < 0) {
+        (void) memcpy((genericptr_t) rxa->seeds, (genericptr_t) rxa->starts,
+                      (size_t) rxa->nstarts * sizeof (int));
+        n = rxa_closure(rxa, rxa->nstarts, RXC_BOL);
+        if ((rxa->start0 = rxa_state(rxa, rxa->found, n)) < 0) {
+            rxa_flush(rxa);
+            rxa->start0 = rxa_state(rxa, rxa->found, n);
+        }
+    }
+    cur = rxa->start0;
+    for (p = s;; p++) {
+        st = &rxa->states[cur];
+        for (i = 0; i < st->nacc; i++)
+            hits[st->acc[i] / RX_ULBITS] |= 1UL << (st->acc[i] % RX_ULBITS);
+        if (!*p)
+            break;
+        i = rxa->classof[(uchar) *p];
+        if ((nx = st->next[i]) < 0 && (nx = rxa_step(rxa, cur, i)) < 0) {
+            /* out of room; start over with just the current state */
+            n = st->nnfa;
+            keep = (int *) alloc((unsigned) (n + 1) * sizeof (int));
+            (void) memcpy((genericptr_t) keep, (genericptr_t) st->nfa,
+                          (size_t) n * sizeof (int));
+            rxa_flush(rxa);
+            cur = rxa_state(rxa, keep, n);
+            free((genericptr_t) keep);
+            nx = rxa_step(rxa, cur, i);
+        }
+        cur = nx;
+    }
+    rxa_endacc(rxa, cur, (p == s) ? RXC_BOL : 0, hits);
+}
+
+/* add a pattern, already compiled into re, to a set; item is what the
+   caller wants back when it matches, and patterns are tried in the order
+   they're added */
+void
+rxset_add(set, pattern, re, item)
+rxset_t *set;
+const char *pattern;
+struct nhregex *re;
+genericptr_t item;
+{
+    int i = set->count;
+
+    if (set->count >= set->size) {
+        unsigned n = (unsigned) set->count, size;
+
+        /* hits[] has a bit per pattern; the others an entry */
+        size = set->size ? (unsigned) (set->size / RX_ULBITS + 1) : 0;
+        set->size = set->size ? 2 * set->size : 32;
+        set->items = (genericptr_t *)
+            rx_grow((genericptr_t) set->items,
+                    (unsigned) (n * sizeof (genericptr_t)),
+                    (unsigned) (set->size * sizeof (genericptr_t)));
+        set->regexes = (struct nhregex **)
+            rx_grow((genericptr_t) set->regexes,
+                    (unsigned) (n * sizeof (struct nhregex *)),
+                    (unsigned) (set->size * sizeof (struct nhregex *)));
+        set->solo = (boolean *)
+            rx_grow((genericptr_t) set->solo,
+                    (unsigned) (n * sizeof (boolean)),
+                    (unsigned) (set->size * sizeof (boolean)));
+        set->hits = (unsigned long *)
+            rx_grow((genericptr_t) set->hits,
+                    (unsigned) (size * sizeof (unsigned long)),
+                    (unsigned) ((set->size / RX_ULBITS + 1)
+                                * sizeof (unsigned long)));
+    }
+    if (!set->rxa) {
+        set->rxa = (struct rxset_auto *) alloc(sizeof *set->rxa);
+        (void) memset((genericptr_t) set->rxa, 0, sizeof *set->rxa);
+    }
+    set->items[i] = item;
+    set->regexes[i] = re;
+    set->solo[i] = (strcmp(regex_id, "posixregex")
+                    && strcmp(regex_id, "cppregex"))
+                   || !rxa_compile(set->rxa, pattern, i);
+    set->count++;
+}
+
+/* find the first pattern in the set which matches somewhere in s and
+   return its item, or Null if none do; rxset_next() goes on from there,
+   so s has to stay put while it's being used.  "First" is in the order
+   the patterns were added, which callers make their list order, so the
+   result is what trying them one at a time would give even though the
+   automaton tries all of them in the same pass */
+genericptr_t
+rxset_match(set, s)
+rxset_t *set;
+const char *s;
+{
+    set->subject = s;
+    set->at = -1;
+    if (!set->count || !s)
+        return (genericptr_t) 0;
+    (void) memset((genericptr_t) set->hits, 0,
+                  (size_t) (set->count / RX_ULBITS + 1)
+                      * sizeof (unsigned long));
+    if (set->rxa->nstarts) {
+        rxa_run(set->rxa, s, set->hits);
+#ifdef EXTRA_SANITY_CHECKS
+        {
+            int i;
+            boolean hit = FALSE;
+
+            for (i = 0; i < set->count; i++) {
+                if (set->solo[i])
+                    continue;
+                hit = (set->hits[i / RX_ULBITS] & (1UL << (i % RX_ULBITS)))
+                      != 0;
+                if (hit != regex_match(s, set->regexes[i]))
+                    break;
+            }
+            if (i < set->count && !g.program_state.in_impossible) {
+                impossible("rxset: pattern %d %s \"%s\"", i,
+                           hit ? "wrongly matches" : "misses", s);
+                /* the report might have reused the set */
+                set->subject = s;
+                set->at = -1;
+                (void) memset((genericptr_t) set->hits, 0,
+                              (size_t) (set->count / RX_ULBITS + 1)
+                                  * sizeof (unsigned long));
+                rxa_run(set->rxa, s, set->hits);
+            }
+        }
+#endif
+    }
+    return rxset_next(set);
+}
+
+/* the item of the next pattern which matches the string most recently
+   given to rxset_match(), or Null */
+genericptr_t
+rxset_next(set)
+rxset_t *set;
+{
+    int i;
+
+    if (!set->subject)
+        return (genericptr_t) 0;
+    while ((i = ++set->at) < set->count)
+        if (set->solo[i] ? regex_match(set->subject, set->regexes[i])
+                         : (set->hits[i / RX_ULBITS]
+                            & (1UL << (i % RX_ULBITS))) != 0)
+            return set->items[i];
+    return (genericptr_t) 0;
+}
+
+/* empty a set; the regexes given to rxset_add() belong to the caller */
+void
+rxset_free(set)
+rxset_t *set;
+{
+    struct rxset_auto *rxa = set->rxa;
+
+    if (rxa) {
+        rxa_unprepare(rxa);
+        if (rxa->nodes)
+            free((genericptr_t) rxa->nodes);
+        if (rxa->sets)
+            free((genericptr_t) rxa->sets);
+        if (rxa->starts)
+            free((genericptr_t) rxa->starts);
+        if (rxa->tree)
+            free((genericptr_t) rxa->tree);
+        free((genericptr_t) rxa);
+    }
+    if (set->items)
+        free((genericptr_t) set->items);
+    if (set->regexes)
+        free((genericptr_t) set->regexes);
+    if (set->solo)
+        free((genericptr_t) set->solo);
+    if (set->hits)
+        free((genericptr_t) set->hits);
+    (void) memset((genericptr_t) set, 0, sizeof *set);
+}
+
+/*rxset.c*/
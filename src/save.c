@@ -38,6 +38,8 @@ static void FDECL(savemonchn, (NHFILE *,struct monst *));
 static void FDECL(savetrapchn, (NHFILE *,struct trap *));
 static void FDECL(savegamestate, (NHFILE *));
 static void FDECL(save_msghistory, (NHFILE *));
+static boolean FDECL(snapshot_levelfile, (NHFILE *, XCHAR_P));
+static unsigned long FDECL(statehash_mix, (unsigned long, long));
 
 #ifdef MFLOPPY
 static void FDECL(savelev0, (NHFILE *, XCHAR_P, int));
@@ -426,6 +428,8 @@ savestateinlock()
         if (flags.ins_chkpt) {
             int currlev = ledger_no(&u.uz);
 
+            /* recover will want files for the levels held in memory */
+            flush_levelcache();
             if (nhfp->structlevel)
                 (void) write(nhfp->fd, (genericptr_t) &currlev, sizeof currlev);
             save_savefile_name(nhfp);
@@ -443,6 +447,223 @@ savestateinlock()
 }
 #endif
 
+/*
+ * Game snapshots:  the complete state of the game in progress, held in
+ * a single block of memory which restore_snapshot() can later put back
+ * in place of whatever game is in progress then.  They're intended for
+ * programs which run the game as a library (sys/libnh) and want to try
+ * several continuations from one position, so they're only taken
+ * between commands.  The levels other than the current one are copied
+ * straight from their level files (in memory or on disk), which record
+ * the process ID, so a snapshot is only good within the process which
+ * took it.
+ *
+ *  Snapshot contents:
+ *    SNAPSHOT_MAGIC, process ID, and turn counters;
+ *    current level, as for a save file;
+ *    game state, as for a save file;
+ *    hero's movement points;
+ *    for each other level with a level file:  its ledger number, size,
+ *      and the contents of the file; then a ledger number of 0;
+ *    random number generator state.
+ */
+genericptr_t
+snapshot_game(lenp)
+long *lenp;
+{
+    static const char magic[] = SNAPSHOT_MAGIC;
+    struct context_info savecontext;
+    NHFILE *nhfp;
+    xchar ltmp;
+    genericptr_t data;
+
+    *lenp = 0L;
+    nhfp = create_memfile();
+    if (!nhfp)
+        return (genericptr_t) 0;
+    bwrite(nhfp->fd, (genericptr_t) magic, sizeof magic);
+    bwrite(nhfp->fd, (genericptr_t) &g.hackpid, sizeof g.hackpid);
+    bwrite(nhfp->fd, (genericptr_t) &g.moves, sizeof g.moves);
+    bwrite(nhfp->fd, (genericptr_t) &g.monstermoves, sizeof g.monstermoves);
+
+    /* context pointers are written as ids, the way that saveobjchn() and
+       savemonchn() do it when freeing; they're put back afterward */
+    savecontext = g.context;
+    g.context.victual.o_id = g.context.victual.piece
+                                 ? g.context.victual.piece->o_id : 0;
+    g.context.tin.o_id = g.context.tin.tin ? g.context.tin.tin->o_id : 0;
+    g.context.spbook.o_id = g.context.spbook.book
+                                ? g.context.spbook.book->o_id : 0;
+    g.context.polearm.m_id = g.context.polearm.hitmon
+                                 ? g.context.polearm.hitmon->m_id : 0;
+    g.context.victual.piece = (struct obj *) 0;
+    g.context.tin.tin = (struct obj *) 0;
+    g.context.spbook.book = (struct obj *) 0;
+    g.context.polearm.hitmon = (struct monst *) 0;
+
+    g.ustuck_id = (u.ustuck ? u.ustuck->m_id : 0);
+    g.usteed_id = (u.usteed ? u.usteed->m_id : 0);
+    savelev(nhfp, ledger_no(&u.uz));
+    savegamestate(nhfp);
+    bwrite(nhfp->fd, (genericptr_t) &g.youmonst.movement,
+           sizeof g.youmonst.movement);
+    g.context = savecontext;
+
+    for (ltmp = (xchar) 1; ltmp <= maxledgerno(); ltmp++) {
+        if (ltmp == ledger_no(&u.uz))
+            continue;
+        if (!(g.level_info[ltmp].flags & LFILE_EXISTS))
+            continue;
+        if (!snapshot_levelfile(nhfp, ltmp)) {
+            close_nhfile(nhfp);
+            return (genericptr_t) 0;
+        }
+    }
+    ltmp = 0;
+    bwrite(nhfp->fd, (genericptr_t) &ltmp, sizeof ltmp);
+    save_rngstate(nhfp);
+    data = memfile_detach(nhfp, lenp);
+    return data;
+}
+
+/* copy level file 'lev' into a snapshot */
+static boolean
+snapshot_levelfile(nhfp, lev)
+NHFILE *nhfp;
+xchar lev;
+{
+    char whynot[BUFSZ], buf[BUFSIZ];
+    NHFILE *lnhfp;
+    long len, cnt;
+    int rlen;
+
+    lnhfp = open_levelfile(lev, whynot);
+    if (!lnhfp) {
+        impossible("%s", whynot);
+        return FALSE;
+    }
+    if (is_membuf(lnhfp->fd)) { /* kept in the level cache */
+        len = membuf_length(lnhfp->fd);
+    } else {
+        len = (long) lseek(lnhfp->fd, (off_t) 0, SEEK_END);
+        (void) lseek(lnhfp->fd, (off_t) 0, SEEK_SET);
+    }
+    bwrite(nhfp->fd, (genericptr_t) &lev, sizeof lev);
+    bwrite(nhfp->fd, (genericptr_t) &len, sizeof len);
+    for (cnt = 0L; cnt < len; cnt += (long) rlen) {
+        rlen = (int) min(len - cnt, (long) sizeof buf);
+        if (is_membuf(lnhfp->fd))
+            mread(lnhfp->fd, (genericptr_t) buf, (unsigned) rlen);
+        else
+            rlen = (int) read(lnhfp->fd, (genericptr_t) buf, (unsigned) rlen);
+        if (rlen <= 0) {
+            impossible("Cannot read level file for level %d.", lev);
+            close_nhfile(lnhfp);
+            return FALSE;
+        }
+        bwrite(nhfp->fd, (genericptr_t) buf, (unsigned) rlen);
+    }
+    close_nhfile(lnhfp);
+    return TRUE;
+}
+
+/* throw away the game in progress, ahead of restoring a snapshot */
+void
+discard_game()
+{
+    NHFILE tnhfp;
+    xchar ltmp;
+
+    for (ltmp = (xchar) 1; ltmp <= maxledgerno(); ltmp++)
+        delete_levelfile(ltmp);
+
+    zero_nhfile(&tnhfp); /* also sets fd to -1 */
+    tnhfp.mode = FREEING;
+    dmonsfree();
+    savelev(&tnhfp, ledger_no(&u.uz));
+    savegamestate(&tnhfp);
+    savemonchn(&tnhfp, g.mydogs), g.mydogs = 0;
+
+    /* what these pointed at is gone */
+    uwep = uarm = uswapwep = uquiver = uarmu = uskin = uarmc = NULL;
+    uarmh = uarms = uarmg = uarmf = uamul = uright = uleft = NULL;
+    ublindf = uchain = uball = NULL;
+    u.ustuck = u.usteed = (struct monst *) 0;
+    g.context.victual.piece = (struct obj *) 0;
+    g.context.tin.tin = (struct obj *) 0;
+    g.context.spbook.book = (struct obj *) 0;
+    g.context.polearm.hitmon = (struct monst *) 0;
+    g.context.victual.o_id = g.context.tin.o_id = 0;
+    g.context.spbook.o_id = 0;
+    g.context.polearm.m_id = 0;
+}
+
+/* fold one value into an FNV-1a hash, a byte at a time */
+static unsigned long
+statehash_mix(h, val)
+unsigned long h;
+long val;
+{
+    int i;
+
+    for (i = 0; i < 4; i++, val >>= 8)
+        h = ((h ^ (unsigned long) (val & 0xffL)) * 16777619UL)
+            & 0xffffffffUL;
+    return h;
+}
+
+/* short summary of the game in progress, for telling whether a replayed
+   game ended up where the original did; covers the hero, inventory, the
+   current level and the random number generator, not everything saved */
+unsigned long
+state_hash()
+{
+    unsigned long h = 2166136261UL;
+    struct obj *otmp;
+    struct monst *mtmp;
+    struct trap *ttmp;
+    int x, y, i;
+
+    h = statehash_mix(h, g.moves);
+    h = statehash_mix(h, (long) g.context.ident);
+    h = statehash_mix(h, (long) ((u.ux << 8) | u.uy));
+    h = statehash_mix(h, (long) ((u.uz.dnum << 8) | u.uz.dlevel));
+    h = statehash_mix(h, (long) u.uhp);
+    h = statehash_mix(h, (long) u.uen);
+    h = statehash_mix(h, u.uexp);
+    h = statehash_mix(h, (long) u.uhunger);
+    h = statehash_mix(h, money_cnt(g.invent));
+    for (i = 0; i < A_MAX; i++)
+        h = statehash_mix(h, (long) ACURR(i));
+
+    for (otmp = g.invent; otmp; otmp = otmp->nobj) {
+        h = statehash_mix(h, (long) otmp->o_id);
+        h = statehash_mix(h, (long) ((otmp->otyp << 8) | otmp->spe));
+        h = statehash_mix(h, otmp->quan);
+        h = statehash_mix(h, (long) ((otmp->blessed << 1) | otmp->cursed));
+    }
+    for (mtmp = fmon; mtmp; mtmp = mtmp->nmon) {
+        if (DEADMONSTER(mtmp))
+            continue;
+        h = statehash_mix(h, (long) mtmp->m_id);
+        h = statehash_mix(h, (long) mtmp->mnum);
+        h = statehash_mix(h, (long) ((mtmp->mx << 8) | mtmp->my));
+        h = statehash_mix(h, (long) mtmp->mhp);
+    }
+    for (x = 1; x < COLNO; x++)
+        for (y = 0; y < ROWNO; y++)
+            h = statehash_mix(h, (long) levl[x][y].typ);
+    for (otmp = fobj; otmp; otmp = otmp->nobj) {
+        h = statehash_mix(h, (long) otmp->o_id);
+        h = statehash_mix(h, (long) ((otmp->ox << 8) | otmp->oy));
+    }
+    for (ttmp = g.ftrap; ttmp; ttmp = ttmp->ntrap) {
+        h = statehash_mix(h, (long) ttmp->ttyp);
+        h = statehash_mix(h, (long) ((ttmp->tx << 8) | ttmp->ty));
+    }
+    return statehash_mix(h, (long) rng_position());
+}
+
 #ifdef MFLOPPY
 boolean
 savelev(nhfp, lev)
@@ -579,6 +800,7 @@ xchar lev;
             for (x = 0; x < COLNO; x++) {
                 g.level.monsters[x][y] = 0;
                 g.level.objects[x][y] = 0;
+                g.level.traps[x][y] = 0;
                 levl[x][y] = cg.zerorm;
             }
         fmon = 0;
@@ -591,6 +813,10 @@ xchar lev;
     save_engravings(nhfp);
     savedamage(nhfp); /* pending shop wall and/or floor repair */
     save_regions(nhfp);
+    if (release_data(nhfp)) {
+        /* traps and engravings, all at once */
+        arena_reset(&g.level.arena);
+    }
     if (nhfp->mode != FREEING) {
         if (nhfp->structlevel)
             bflush(nhfp->fd);
@@ -922,21 +1148,13 @@ NHFILE *nhfp;
 register struct trap *trap;
 {
     static struct trap zerotrap;
-    register struct trap *trap2;
 
-    while (trap) {
-        trap2 = trap->ntrap;
-        if (perform_bwrite(nhfp)) {
-            if (nhfp->structlevel)  
-                bwrite(nhfp->fd, (genericptr_t) trap, sizeof *trap);
-	}
-        if (release_data(nhfp))
-            dealloc_trap(trap);
-        trap = trap2;
-    }
-    if (perform_bwrite(nhfp)) {
-        if (nhfp->structlevel)
-            bwrite(nhfp->fd, (genericptr_t) &zerotrap, sizeof zerotrap);
+    /* when release_data(), the traps go with the level's arena, which
+       savelev() resets afterwards */
+    if (perform_bwrite(nhfp) && nhfp->structlevel) {
+        for (; trap; trap = trap->ntrap)
+            bwrite(nhfp->fd, (genericptr_t) trap, sizeof *trap);
+        bwrite(nhfp->fd, (genericptr_t) &zerotrap, sizeof zerotrap);
     }
 }
 
@@ -1091,7 +1309,11 @@ void
 freedynamicdata()
 {
     NHFILE tnhfp;
+    struct nhpool *const *pool;
 
+#ifdef MONITOR_HEAP
+    heapmon_dump(); /* before the game's memory goes */
+#endif
 #if defined(UNIX) && defined(MAIL)
     free_maildata();
 #endif
@@ -1099,9 +1321,11 @@ freedynamicdata()
     tnhfp.mode = FREEING;
     free_menu_coloring();
     free_invbuf();           /* let_to_name (invent.c) */
+    free_travelcache();      /* findtravelpath (hack.c) */
     free_youbuf();           /* You_buf,&c (pline.c) */
     msgtype_free();
     tmp_at(DISP_FREEMEM, 0); /* temporary display effects */
+    nhl_done();              /* persistent Lua state (nhlua.c) */
 #ifdef FREE_ALL_MEMORY
 #define free_current_level() savelev(&tnhfp, -1)
 #define freeobjchn(X) (saveobjchn(&tnhfp, X), X = 0)
@@ -1136,6 +1360,8 @@ freedynamicdata()
     freenames();
     free_waterlevel();
     free_dungeons();
+    idmap_free(&g.oid_map); /* find_oid() lookup (mkobj.c) */
+    idmap_free(&g.mid_map); /* find_mid() lookup (mon.c) */
 
     /* some pointers in iflags */
     if (iflags.wc_font_map)
@@ -1156,7 +1382,15 @@ freedynamicdata()
     /* miscellaneous */
     /* free_pickinv_cache();  --  now done from really_done()... */
     free_symsets();
+#ifdef USER_SOUNDS
+    release_sound_mappings();
+#endif
 #endif /* FREE_ALL_MEMORY */
+    /* objects and monsters which weren't freed individually above go in
+       bulk; with FREE_ALL_MEMORY that should be none */
+    for (pool = nhpools; *pool; ++pool)
+        pool_release(*pool);
+    arena_release(&g.level.arena);
     if (VIA_WINDOWPORT())
         status_finish();
 #ifdef DUMPLOG
@@ -42,6 +42,24 @@ void NDECL(minit);
 void FDECL(bclose, (int));
 #endif /* TRACE_BUFFERING */
 static int FDECL(getidx, (int, int));
+static struct memfile *FDECL(get_membuf, (int));
+static void FDECL(membuf_write, (struct memfile *, genericptr_t, unsigned));
+static int FDECL(membuf_read, (struct memfile *, genericptr_t, unsigned));
+static void FDECL(bw_raw, (int, int, genericptr_t, unsigned));
+#ifdef LZCOMP
+struct lzstream;
+static unsigned FDECL(lz_compress, (const unsigned char *, unsigned,
+                                    unsigned char *, unsigned));
+static boolean FDECL(lz_expand, (const unsigned char *, unsigned,
+                                 unsigned char *, unsigned));
+static void FDECL(lz_putblock, (int, int));
+static void FDECL(lz_endsegment, (int, int));
+static int FDECL(lz_readfull, (int, unsigned char *, unsigned));
+static int FDECL(lz_getblock, (struct lzstream *, int));
+static int FDECL(lz_read, (struct lzstream *, int, unsigned char *,
+                           unsigned));
+static void FDECL(lz_reset, (struct lzstream *));
+#endif
 
 #if defined(UNIX) || defined(WIN32)
 #define USE_BUFFERING
@@ -97,6 +115,157 @@ static FILE *bw_FILE[MAXFD] = {0,0,0,0,0};
  *       happen.
  */
 
+/*
+ * In-memory files, used for game snapshots (see snapshot_game()).
+ *
+ * They're identified by descriptors below -1 so that they can't be
+ * mistaken for real ones or for the -1 of a failed open.  bwrite(),
+ * mread() and the buffering routines check for them before anything
+ * else, so the structlevel save and restore code works on them as is.
+ */
+#define MEMFD_BASE (-2)
+#define MAXMEMFD 4
+#define MEMFD_CHUNK (64L * 1024L)
+
+static struct memfile {
+    boolean inuse;
+    boolean borrowed; /* buf belongs to caller; read it but don't free */
+    char *buf;
+    long len, size, pos;
+} memfiles[MAXMEMFD];
+
+static struct memfile *
+get_membuf(fd)
+int fd;
+{
+    int idx = MEMFD_BASE - fd;
+
+    if (idx >= 0 && idx < MAXMEMFD && memfiles[idx].inuse)
+        return &memfiles[idx];
+    return (struct memfile *) 0;
+}
+
+boolean
+is_membuf(fd)
+int fd;
+{
+    return (get_membuf(fd) != 0);
+}
+
+/* open an in-memory file; a new empty one for writing if data is null,
+   otherwise one for reading len bytes of data (which isn't copied) */
+int
+membuf_open(data, len)
+genericptr_t data;
+long len;
+{
+    struct memfile *mf;
+    int idx;
+
+    for (idx = 0; idx < MAXMEMFD; ++idx)
+        if (!memfiles[idx].inuse)
+            break;
+    if (idx == MAXMEMFD)
+        return -1;
+    mf = &memfiles[idx];
+    mf->inuse = TRUE;
+    mf->pos = 0L;
+    if (data) {
+        mf->borrowed = TRUE;
+        mf->buf = (char *) data;
+        mf->len = mf->size = len;
+    } else {
+        mf->borrowed = FALSE;
+        mf->buf = (char *) 0;
+        mf->len = mf->size = 0L;
+    }
+    return MEMFD_BASE - idx;
+}
+
+/* close an in-memory file, handing its contents over to the caller */
+genericptr_t
+membuf_detach(fd, lenp)
+int fd;
+long *lenp;
+{
+    struct memfile *mf = get_membuf(fd);
+    genericptr_t data = (genericptr_t) 0;
+
+    if (mf) {
+        data = (genericptr_t) mf->buf;
+        if (lenp)
+            *lenp = mf->len;
+        mf->buf = (char *) 0;
+        mf->inuse = FALSE;
+    }
+    return data;
+}
+
+void
+membuf_rewind(fd)
+int fd;
+{
+    struct memfile *mf = get_membuf(fd);
+
+    if (mf)
+        mf->pos = 0L;
+}
+
+long
+membuf_length(fd)
+int fd;
+{
+    struct memfile *mf = get_membuf(fd);
+
+    return mf ? mf->len : 0L;
+}
+
+static void
+membuf_write(mf, loc, num)
+struct memfile *mf;
+genericptr_t loc;
+unsigned num;
+{
+    long newsize;
+    char *newbuf;
+
+    if (mf->borrowed)
+        panic("writing to a read-only memory file");
+    if (mf->pos + (long) num > mf->size) {
+        newsize = mf->size ? mf->size : MEMFD_CHUNK;
+        while (mf->pos + (long) num > newsize)
+            newsize *= 2L;
+        newbuf = (char *) alloc((unsigned) newsize);
+        if (mf->buf) {
+            (void) memcpy((genericptr_t) newbuf, (genericptr_t) mf->buf,
+                          (size_t) mf->len);
+            free((genericptr_t) mf->buf);
+        }
+        mf->buf = newbuf;
+        mf->size = newsize;
+    }
+    (void) memcpy((genericptr_t) (mf->buf + mf->pos), loc, (size_t) num);
+    mf->pos += (long) num;
+    if (mf->pos > mf->len)
+        mf->len = mf->pos;
+}
+
+static int
+membuf_read(mf, buf, len)
+struct memfile *mf;
+genericptr_t buf;
+unsigned len;
+{
+    long avail = mf->len - mf->pos;
+
+    if ((long) len > avail)
+        len = (unsigned) avail;
+    if (len)
+        (void) memcpy(buf, (genericptr_t) (mf->buf + mf->pos), (size_t) len);
+    mf->pos += (long) len;
+    return (int) len;
+}
+
 static int
 getidx(fd, flg)
 int fd, flg;
@@ -117,6 +286,314 @@ int fd, flg;
     return retval;
 }
 
+#ifdef LZCOMP
+/*
+ * Built-in streaming compression (LZCOMP).
+ *
+ * Whatever is written with bwrite() between bufon() and bufoff() is
+ * gathered into blocks, each compressed with a small LZ77 coder (a
+ * relative of LZF) and written out as a "segment":
+ *      lz_magic                        before the first block;
+ *      uncompressed and stored length  2 bytes each, little-endian;
+ *      the stored bytes                as is when the lengths match;
+ *      0, 0                            after the last block.
+ * Data written with plain write(), or with bwrite() before bufon(),
+ * isn't touched, so the headers which are read back with read() stay
+ * readable that way.  mread() expands any segment it comes to and
+ * passes everything else through, so files written before this (and
+ * ones put together by recover) load too.  lz_magic read as an int is
+ * larger than any process id, which is what an uncompressed level
+ * starts with.
+ */
+#define LZ_BLOCK 32768            /* uncompressed bytes per block */
+#define LZ_HASHBITS 13
+#define LZ_MAXOFF 8192            /* how far back a match can be */
+#define LZ_MAXLIT 32              /* literal bytes per control byte */
+#define LZ_MAXMATCH (2 + 7 + 255) /* longest match */
+#define LZ_HASH(p) \
+    ((((unsigned long) (p)[0] << 16 | (unsigned long) (p)[1] << 8 \
+       | (unsigned long) (p)[2]) * 2654435761UL >> 19)            \
+     & ((1UL << LZ_HASHBITS) - 1))
+
+enum lz_rstates {
+    LZR_UNKNOWN = 0, /* nothing read yet */
+    LZR_RAW,         /* file doesn't start with a segment; no expansion */
+    LZR_BETWEEN,     /* past the end of a segment */
+    LZR_INSEG        /* reading a segment's blocks */
+};
+
+static const unsigned char lz_magic[4] = { 0x00, 'N', 'H', 'z' };
+
+static struct lzstream {
+    boolean writing; /* compressing, since bufon() */
+    boolean started; /* lz_magic written for the current segment */
+    enum lz_rstates rstate;
+    unsigned char *buf;  /* uncompressed block being filled or used up */
+    unsigned char *cbuf; /* compressed block */
+    unsigned len, pos;   /* used portion of buf, and position within it */
+    unsigned char peek[sizeof lz_magic]; /* checked for start of segment */
+    unsigned npeek;
+} lzs[MAXFD];
+
+/* compress ilen bytes of in[] into out[]; returns the compressed length,
+   or 0 if that wouldn't be less than omax */
+static unsigned
+lz_compress(in, ilen, out, omax)
+const unsigned char *in;
+unsigned ilen;
+unsigned char *out;
+unsigned omax;
+{
+    static unsigned short htab[1 << LZ_HASHBITS]; /* position + 1 */
+    unsigned ip = 0, op = 0, lit = 0, ref = 0, len, maxlen, off, n;
+    unsigned long h;
+
+    (void) memset((genericptr_t) htab, 0, sizeof htab);
+    while (ip < ilen) {
+        len = 0;
+        if (ip + 2 < ilen) {
+            h = LZ_HASH(&in[ip]);
+            ref = htab[h];
+            htab[h] = (unsigned short) (ip + 1);
+            if (ref-- && ip - ref <= LZ_MAXOFF && in[ref] == in[ip]
+                && in[ref + 1] == in[ip + 1] && in[ref + 2] == in[ip + 2]) {
+                maxlen = min(ilen - ip, LZ_MAXMATCH);
+                for (len = 3; len < maxlen; len++)
+                    if (in[ref + len] != in[ip + len])
+                        break;
+            }
+        }
+        if (!len) {
+            if (++ip < ilen)
+                continue;
+            /* otherwise flush the final literals */
+        }
+        /* literals from lit up to ip, LZ_MAXLIT at a time */
+        while (lit < ip) {
+            n = min(ip - lit, LZ_MAXLIT);
+            if (op + 1 + n >= omax)
+                return 0;
+            out[op++] = (unsigned char) (n - 1);
+            (void) memcpy((genericptr_t) &out[op], (genericptr_t) &in[lit],
+                          n);
+            op += n, lit += n;
+        }
+        if (len) {
+            if (op + 3 >= omax)
+                return 0;
+            off = ip - ref - 1;
+            n = len - 2;
+            if (n < 7) {
+                out[op++] = (unsigned char) (n << 5 | off >> 8);
+            } else {
+                out[op++] = (unsigned char) (7 << 5 | off >> 8);
+                out[op++] = (unsigned char) (n - 7);
+            }
+            out[op++] = (unsigned char) (off & 0xff);
+            ip += len, lit = ip;
+        }
+    }
+    return op;
+}
+
+/* expand clen bytes of in[] into exactly ulen bytes of out[] */
+static boolean
+lz_expand(in, clen, out, ulen)
+const unsigned char *in;
+unsigned clen;
+unsigned char *out;
+unsigned ulen;
+{
+    unsigned ip = 0, op = 0, c, n, off;
+
+    while (ip < clen) {
+        c = in[ip++];
+        if (c < LZ_MAXLIT) {
+            n = c + 1;
+            if (ip + n > clen || op + n > ulen)
+                return FALSE;
+            (void) memcpy((genericptr_t) &out[op], (genericptr_t) &in[ip],
+                          n);
+            ip += n, op += n;
+        } else {
+            n = c >> 5;
+            if (n == 7) {
+                if (ip >= clen)
+                    return FALSE;
+                n += in[ip++];
+            }
+            if (ip >= clen)
+                return FALSE;
+            off = ((c & 0x1f) << 8 | in[ip++]) + 1;
+            n += 2;
+            if (off > op || op + n > ulen)
+                return FALSE;
+            for (; n; n--, op++) /* may overlap, so byte by byte */
+                out[op] = out[op - off];
+        }
+    }
+    return (boolean) (op == ulen);
+}
+
+/* compress and write out whatever has been gathered for fd */
+static void
+lz_putblock(idx, fd)
+int idx, fd;
+{
+    struct lzstream *lz = &lzs[idx];
+    unsigned char hdr[4];
+    unsigned clen;
+
+    if (!lz->len)
+        return;
+    if (!lz->started) {
+        bw_raw(idx, fd, (genericptr_t) lz_magic, sizeof lz_magic);
+        lz->started = TRUE;
+    }
+    clen = lz_compress(lz->buf, lz->len, lz->cbuf, lz->len);
+    if (!clen)
+        clen = lz->len; /* incompressible; store it */
+    hdr[0] = (unsigned char) (lz->len & 0xff);
+    hdr[1] = (unsigned char) (lz->len >> 8);
+    hdr[2] = (unsigned char) (clen & 0xff);
+    hdr[3] = (unsigned char) (clen >> 8);
+    bw_raw(idx, fd, (genericptr_t) hdr, sizeof hdr);
+    bw_raw(idx, fd, (genericptr_t) ((clen == lz->len) ? lz->buf : lz->cbuf),
+           clen);
+    lz->len = 0;
+}
+
+/* finish off the current segment; called by bufoff() */
+static void
+lz_endsegment(idx, fd)
+int idx, fd;
+{
+    static const unsigned char endmark[4] = { 0, 0, 0, 0 };
+    struct lzstream *lz = &lzs[idx];
+
+    lz_putblock(idx, fd);
+    if (lz->started)
+        bw_raw(idx, fd, (genericptr_t) endmark, sizeof endmark);
+    lz->started = lz->writing = FALSE;
+}
+
+static int
+lz_readfull(fd, buf, len)
+int fd;
+unsigned char *buf;
+unsigned len;
+{
+    int got = 0, rlen;
+
+    while ((unsigned) got < len) {
+        rlen = (int) read(fd, (genericptr_t) (buf + got), len - got);
+        if (rlen <= 0)
+            break;
+        got += rlen;
+    }
+    return got;
+}
+
+/* read and expand the next block of a segment; returns 1 for a block,
+   0 for the end of the segment, -1 if the file is damaged */
+static int
+lz_getblock(lz, fd)
+struct lzstream *lz;
+int fd;
+{
+    unsigned char hdr[4];
+    unsigned ulen, clen;
+
+    if (lz_readfull(fd, hdr, sizeof hdr) != (int) sizeof hdr)
+        return -1;
+    ulen = hdr[0] | (unsigned) hdr[1] << 8;
+    clen = hdr[2] | (unsigned) hdr[3] << 8;
+    if (!ulen && !clen)
+        return 0;
+    if (!ulen || ulen > LZ_BLOCK || clen > ulen)
+        return -1;
+    if (clen == ulen) {
+        if (lz_readfull(fd, lz->buf, clen) != (int) clen)
+            return -1;
+    } else if (lz_readfull(fd, lz->cbuf, clen) != (int) clen
+               || !lz_expand(lz->cbuf, clen, lz->buf, ulen)) {
+        return -1;
+    }
+    lz->len = ulen, lz->pos = 0;
+    return 1;
+}
+
+/* mread() for real files; returns the number of bytes obtained */
+static int
+lz_read(lz, fd, buf, len)
+struct lzstream *lz;
+int fd;
+unsigned char *buf;
+unsigned len;
+{
+    unsigned got = 0, n;
+    int rlen;
+
+    if (!lz->buf) {
+        lz->buf = (unsigned char *) alloc(LZ_BLOCK);
+        lz->cbuf = (unsigned char *) alloc(LZ_BLOCK);
+    }
+    while (got < len) {
+        if (lz->pos < lz->len) {
+            n = min(len - got, lz->len - lz->pos);
+            (void) memcpy((genericptr_t) (buf + got),
+                          (genericptr_t) (lz->buf + lz->pos), n);
+            lz->pos += n, got += n;
+        } else if (lz->rstate == LZR_RAW) {
+            rlen = (int) read(fd, (genericptr_t) (buf + got), len - got);
+            if (rlen <= 0)
+                break;
+            got += (unsigned) rlen;
+        } else if (lz->rstate == LZR_INSEG) {
+            rlen = lz_getblock(lz, fd);
+            if (rlen < 0)
+                break;
+            if (!rlen)
+                lz->rstate = LZR_BETWEEN;
+        } else {
+            /* see whether a segment starts here */
+            lz->npeek += (unsigned) lz_readfull(fd, lz->peek + lz->npeek,
+                                                sizeof lz->peek - lz->npeek);
+            if (lz->npeek == sizeof lz_magic
+                && !memcmp((genericptr_t) lz->peek, (genericptr_t) lz_magic,
+                           sizeof lz_magic)) {
+                lz->rstate = LZR_INSEG;
+                lz->npeek = 0;
+            } else if (lz->rstate == LZR_UNKNOWN) {
+                /* not compressed at all */
+                (void) memcpy((genericptr_t) lz->buf,
+                              (genericptr_t) lz->peek, lz->npeek);
+                lz->len = lz->npeek, lz->pos = 0;
+                lz->npeek = 0;
+                lz->rstate = LZR_RAW;
+            } else if (lz->npeek) {
+                /* an uncompressed byte between segments */
+                buf[got++] = lz->peek[0];
+                (void) memmove((genericptr_t) lz->peek,
+                               (genericptr_t) (lz->peek + 1), --lz->npeek);
+            } else {
+                break; /* end of file */
+            }
+        }
+    }
+    return (int) got;
+}
+
+/* forget any partly read data */
+static void
+lz_reset(lz)
+struct lzstream *lz;
+{
+    lz->rstate = LZR_UNKNOWN;
+    lz->len = lz->pos = lz->npeek = 0;
+}
+#endif /* LZCOMP */
+
 /* Let caller know that bclose() should handle it (TRUE) */
 boolean
 close_check(fd)
@@ -134,7 +611,11 @@ void
 bufon(fd)
 int fd;
 {
-    int idx = getidx(fd, NOFLG);
+    int idx;
+
+    if (is_membuf(fd))
+        return;
+    idx = getidx(fd, NOFLG);
 
     if (idx >= 0) {
         bw_sticky[idx] = fd;
@@ -148,6 +629,14 @@ int fd;
         bw_buffered[idx] = (bw_FILE[idx] != 0);
 #else
         bw_buffered[idx] = 1;
+#endif
+#ifdef LZCOMP
+        if (!lzs[idx].buf) {
+            lzs[idx].buf = (unsigned char *) alloc(LZ_BLOCK);
+            lzs[idx].cbuf = (unsigned char *) alloc(LZ_BLOCK);
+        }
+        lz_reset(&lzs[idx]);
+        lzs[idx].writing = TRUE;
 #endif
     }
 }
@@ -156,9 +645,17 @@ void
 bufoff(fd)
 int fd;
 {
-    int idx = getidx(fd, NOFLG);
+    int idx;
+
+    if (is_membuf(fd))
+        return;
+    idx = getidx(fd, NOFLG);
 
     if (idx >= 0) {
+#ifdef LZCOMP
+        if (lzs[idx].writing)
+            lz_endsegment(idx, fd);
+#endif
         bflush(fd);
         bw_buffered[idx] = 0;     /* just a flag that says "use write(fd)" */
     }
@@ -168,8 +665,17 @@ void
 bclose(fd)
 int fd;
 {
-    int idx = getidx(fd, NOSLOT);
-
+    int idx;
+    struct memfile *mf = get_membuf(fd);
+
+    if (mf) {
+        if (mf->buf && !mf->borrowed)
+            free((genericptr_t) mf->buf);
+        mf->buf = (char *) 0;
+        mf->inuse = FALSE;
+        return;
+    }
+    idx = getidx(fd, NOSLOT);
     bufoff(fd);     /* sets bw_buffered[idx] = 0 */
     if (idx >= 0) {
 #ifdef USE_BUFFERING
@@ -179,6 +685,14 @@ int fd;
         } else
 #endif
             close(fd);
+#ifdef LZCOMP
+        if (lzs[idx].buf) {
+            free((genericptr_t) lzs[idx].buf);
+            free((genericptr_t) lzs[idx].cbuf);
+            lzs[idx].buf = lzs[idx].cbuf = (unsigned char *) 0;
+        }
+        lz_reset(&lzs[idx]);
+#endif
         /* return the idx to the pool */
         bw_sticky[idx] = -1;
     }
@@ -189,9 +703,17 @@ void
 bflush(fd)
 int fd;
 {
-    int idx = getidx(fd, NOFLG);
+    int idx;
+
+    if (is_membuf(fd))
+        return;
+    idx = getidx(fd, NOFLG);
 
     if (idx >= 0) {
+#ifdef LZCOMP
+        if (lzs[idx].writing)
+            lz_putblock(idx, fd);
+#endif
 #ifdef USE_BUFFERING
         if (bw_FILE[idx]) {
            if (fflush(bw_FILE[idx]) == EOF)
@@ -208,38 +730,75 @@ register int fd;
 register genericptr_t loc;
 register unsigned num;
 {
-    boolean failed;
-    int idx = getidx(fd, NOFLG);
+    int idx;
+    struct memfile *mf = get_membuf(fd);
+#ifdef LZCOMP
+    struct lzstream *lz;
+    unsigned n;
+#endif
 
+    if (mf) {
+        membuf_write(mf, loc, num);
+        return;
+    }
+    idx = getidx(fd, NOFLG);
     if (idx >= 0) {
 #ifdef MFLOPPY
         bytes_counted += num;
         if (count_only)
             return;
 #endif
+#ifdef LZCOMP
+        lz = &lzs[idx];
+        if (lz->writing) {
+            while (num) {
+                n = min(num, LZ_BLOCK - lz->len);
+                (void) memcpy((genericptr_t) (lz->buf + lz->len), loc, n);
+                lz->len += n, num -= n;
+                loc = (genericptr_t) ((char *) loc + n);
+                if (lz->len == LZ_BLOCK)
+                    lz_putblock(idx, fd);
+            }
+            return;
+        }
+#endif
+        bw_raw(idx, fd, loc, num);
+    } else
+        impossible("fd not in list (%d)?", fd);
+}
+
+/* write to fd, which has tracking slot idx, without compression */
+static void
+bw_raw(idx, fd, loc, num)
+int idx, fd;
+genericptr_t loc;
+unsigned num;
+{
+    boolean failed;
+
 #ifdef USE_BUFFERING
-        if (bw_buffered[idx] && bw_FILE[idx]) {
-            failed = (fwrite(loc, (int) num, 1, bw_FILE[idx]) != 1);
-        } else
+    if (bw_buffered[idx] && bw_FILE[idx]) {
+        failed = (fwrite(loc, (int) num, 1, bw_FILE[idx]) != 1);
+    } else
+#else
+    nhUse(idx);
 #endif /* UNIX */
-        {
-            /* lint wants 3rd arg of write to be an int; lint -p an unsigned */
+    {
+        /* lint wants 3rd arg of write to be an int; lint -p an unsigned */
 #if defined(BSD) || defined(ULTRIX) || defined(WIN32) || defined(_MSC_VER)
-            failed = ((long) write(fd, loc, (int) num) != (long) num);
+        failed = ((long) write(fd, loc, (int) num) != (long) num);
 #else /* e.g. SYSV, __TURBOC__ */
-            failed = ((long) write(fd, loc, num) != (long) num);
+        failed = ((long) write(fd, loc, num) != (long) num);
 #endif
-        }
-        if (failed) {
+    }
+    if (failed) {
 #if defined(UNIX) || defined(VMS) || defined(__EMX__)
-            if (g.program_state.done_hup)
-                nh_terminate(EXIT_FAILURE);
-            else
+        if (g.program_state.done_hup)
+            nh_terminate(EXIT_FAILURE);
+        else
 #endif
-                panic("cannot write %u bytes to file #%d", num, fd);
-        }
-    } else
-        impossible("fd not in list (%d)?", fd);
+            panic("cannot write %u bytes to file #%d", num, fd);
+    }
 }
 
 /*  ===================================================== */
@@ -247,6 +806,14 @@ register unsigned num;
 void
 minit()
 {
+#ifdef LZCOMP
+    int idx;
+
+    /* a file has been rewound, or read from with read(); start over */
+    for (idx = 0; idx < MAXFD; ++idx)
+        if (bw_sticky[idx] >= 0 && !lzs[idx].writing)
+            lz_reset(&lzs[idx]);
+#endif
     return;
 }
 
@@ -257,20 +824,31 @@ register genericptr_t buf;
 register unsigned int len;
 {
     register int rlen;
+    struct memfile *mf = get_membuf(fd);
+#ifdef LZCOMP
+    int idx;
+#endif
 #if defined(BSD) || defined(ULTRIX)
 #define readLenType int
 #else /* e.g. SYSV, __TURBOC__ */
 #define readLenType unsigned
 #endif
 
-    rlen = read(fd, buf, (readLenType) len);
+    if (mf)
+        rlen = membuf_read(mf, buf, len);
+#ifdef LZCOMP
+    else if ((idx = getidx(fd, NOFLG)) >= 0)
+        rlen = lz_read(&lzs[idx], fd, (unsigned char *) buf, len);
+#endif
+    else
+        rlen = read(fd, buf, (readLenType) len);
     if ((readLenType) rlen != (readLenType) len) {
         if (restoreinfo.mread_flags == 1) { /* means "return anyway" */
             restoreinfo.mread_flags = -1;
             return;
         } else {
             pline("Read %d instead of %u bytes.", rlen, len);
-            if (g.restoring) {
+            if (g.restoring && !mf) {
                 (void) nhclose(fd);
                 (void) delete_savefile();
                 error("Error restoring old game.");
@@ -974,8 +974,11 @@ register struct obj *obj, *merge;
            owns them and intends to sell (unless he subsequently buys
            them back) or if no shopping activity ever involves them */
         if (merge && (oid_price_adjustment(obj, obj->o_id)
-                      > oid_price_adjustment(merge, merge->o_id)))
+                      > oid_price_adjustment(merge, merge->o_id))) {
+            unregister_oid(merge);
             merge->o_id = obj->o_id;
+            register_oid(merge);
+        }
     }
     if (obj->owornmask) {
         impossible("obfree: deleting worn obj (%d: %ld)", obj->otyp,
@@ -1951,35 +1954,33 @@ register struct bill_x *bp;
  * Look for o_id on all lists but billobj.  Return obj or NULL if not found.
  * Its OK for restore_timers() to call this function, there should not
  * be any timeouts on the g.billobjs chain.
+ *
+ * Every live object is registered by id when it's created or restored,
+ * so rather than searching the invent, fobj, buried, migrating, and
+ * monster inventory chains we look it up and then check that the
+ * outermost container is on one of those chains.
  */
 struct obj *
 find_oid(id)
 unsigned id;
 {
-    struct obj *obj;
-    struct monst *mon, *mmtmp[3];
-    int i;
+    anything *val = idmap_get(&g.oid_map, id);
+    struct obj *obj, *top;
 
-    /* first check various obj lists directly */
-    if ((obj = o_on(id, g.invent)) != 0)
-        return obj;
-    if ((obj = o_on(id, fobj)) != 0)
-        return obj;
-    if ((obj = o_on(id, g.level.buriedobjlist)) != 0)
-        return obj;
-    if ((obj = o_on(id, g.migrating_objs)) != 0)
+    if (!val || (obj = val->a_obj)->o_id != id)
+        return (struct obj *) 0;
+    for (top = obj; top->where == OBJ_CONTAINED; top = top->ocontainer)
+        continue;
+    switch (top->where) {
+    case OBJ_INVENT:
+    case OBJ_FLOOR:
+    case OBJ_BURIED:
+    case OBJ_MIGRATING:
+    case OBJ_MINVENT: /* fmon, migrating_mons, or mydogs */
         return obj;
-
-    /* not found yet; check inventory for members of various monst lists */
-    mmtmp[0] = fmon;
-    mmtmp[1] = g.migrating_mons;
-    mmtmp[2] = g.mydogs; /* for use during level changes */
-    for (i = 0; i < 3; i++)
-        for (mon = mmtmp[i]; mon; mon = mon->nmon)
-            if ((obj = o_on(id, mon->minvent)) != 0)
-                return obj;
-
-    /* not found at all */
+    default: /* OBJ_FREE, OBJ_ONBILL, OBJ_LUAFREE, ... */
+        break;
+    }
     return (struct obj *) 0;
 }
 
@@ -2795,6 +2796,7 @@ register struct monst *shkp;
             *otmp = *obj;
             otmp->oextra = (struct oextra *) 0;
             bp->bo_id = otmp->o_id = g.context.ident++;
+            register_oid(otmp);
             otmp->where = OBJ_FREE;
             otmp->quan = (bp->bquan -= obj->quan);
             otmp->owt = 0; /* superfluous */
@@ -568,7 +568,7 @@ struct monst *mtmp;
     if (!mtmp->mextra)
         mtmp->mextra = newmextra();
     if (!ESHK(mtmp))
-        ESHK(mtmp) = (struct eshk *) alloc(sizeof(struct eshk));
+        ESHK(mtmp) = (struct eshk *) pool_alloc(&eshk_pool);
     (void) memset((genericptr_t) ESHK(mtmp), 0, sizeof(struct eshk));
     ESHK(mtmp)->bill_p = (struct bill_x *) 0;
 }
@@ -578,7 +578,7 @@ free_eshk(mtmp)
 struct monst *mtmp;
 {
     if (mtmp->mextra && ESHK(mtmp)) {
-        free((genericptr_t) ESHK(mtmp));
+        pool_free(&eshk_pool, (genericptr_t) ESHK(mtmp));
         ESHK(mtmp) = (struct eshk *) 0;
     }
     mtmp->isshk = 0;
@@ -1112,12 +1112,14 @@ extern void FDECL(play_usersound, (const char *, int));
 
 typedef struct audio_mapping_rec {
     struct nhregex *regex;
+    char *pattern;
     char *filename;
     int volume;
     struct audio_mapping_rec *next;
 } audio_mapping;
 
 static audio_mapping *soundmap = 0;
+static rxset_t soundmap_rx; /* soundmap's patterns, tried together */
 
 char *sounddir = ".";
 
@@ -1155,7 +1157,9 @@ const char *mapping;
                 free(new_map);
                 return 0;
             } else {
+                new_map->pattern = dupstr(text);
                 soundmap = new_map;
+                rxset_free(&soundmap_rx); /* rebuilt when next needed */
             }
         } else {
             Sprintf(text, "cannot read %.243s", filespec);
@@ -1176,11 +1180,31 @@ const char *msg;
 {
     audio_mapping *cursor = soundmap;
 
-    while (cursor) {
-        if (regex_match(msg, cursor->regex)) {
-            play_usersound(cursor->filename, cursor->volume);
-        }
-        cursor = cursor->next;
+    if (!cursor)
+        return;
+    if (!soundmap_rx.count)
+        for (; cursor; cursor = cursor->next)
+            rxset_add(&soundmap_rx, cursor->pattern, cursor->regex,
+                      (genericptr_t) cursor);
+    /* every mapping whose pattern matches gets played, in list order */
+    for (cursor = (audio_mapping *) rxset_match(&soundmap_rx, msg); cursor;
+         cursor = (audio_mapping *) rxset_next(&soundmap_rx))
+        play_usersound(cursor->filename, cursor->volume);
+}
+
+void
+release_sound_mappings()
+{
+    audio_mapping *nxtsm;
+
+    rxset_free(&soundmap_rx);
+    while (soundmap) {
+        nxtsm = soundmap->next;
+        regex_free(soundmap->regex);
+        free((genericptr_t) soundmap->pattern);
+        free((genericptr_t) soundmap->filename);
+        free((genericptr_t) soundmap);
+        soundmap = nxtsm;
     }
 }
 
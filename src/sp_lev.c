@@ -3577,6 +3577,34 @@ lua_State *L UNUSED;
 }
 
 /* selection */
+
+/*
+ * A selection is a bitmap of the level, kept a column at a time:  bit y
+ * of map[x] is set when <x,y> is selected.  A whole column fits in one
+ * unsigned long, so the set operations and growing work a column per
+ * step, and going through the selected spots column by column visits
+ * them in the same x-then-y order as the cell-at-a-time loops did, so
+ * random choices made along the way come out the same.
+ */
+#if ROWNO > 32
+#error "selections need an unsigned long to hold a column of ROWNO bits"
+#endif
+#define SEL_COLMASK(sel) \
+    (((sel)->hei >= 32) ? 0xffffffffUL : ((1UL << (sel)->hei) - 1UL))
+
+static int FDECL(sel_bitcount, (unsigned long));
+
+static int
+sel_bitcount(bits)
+unsigned long bits;
+{
+    int n;
+
+    for (n = 0; bits; bits &= bits - 1UL)
+        n++;
+    return n;
+}
+
 struct selectionvar *
 selection_new()
 {
@@ -3585,9 +3613,8 @@ selection_new()
 
     tmps->wid = COLNO;
     tmps->hei = ROWNO;
-    tmps->map = (char *)alloc((COLNO * ROWNO) + 1);
-    (void) memset(tmps->map, 1, (COLNO * ROWNO));
-    tmps->map[(COLNO * ROWNO)] = '\0';
+    tmps->map = (unsigned long *) alloc(COLNO * sizeof (unsigned long));
+    (void) memset((genericptr_t) tmps->map, 0, COLNO * sizeof (unsigned long));
 
     return tmps;
 }
@@ -3612,7 +3639,9 @@ struct selectionvar *sel;
 
     tmps->wid = sel->wid;
     tmps->hei = sel->hei;
-    tmps->map = dupstr(sel->map);
+    tmps->map = (unsigned long *) alloc(sel->wid * sizeof (unsigned long));
+    (void) memcpy((genericptr_t) tmps->map, (genericptr_t) sel->map,
+                  sel->wid * sizeof (unsigned long));
 
     return tmps;
 }
@@ -3627,7 +3656,7 @@ struct selectionvar *sel;
     if (x < 0 || y < 0 || x >= sel->wid || y >= sel->hei)
         return 0;
 
-    return (sel->map[sel->wid * y + x] - 1);
+    return ((sel->map[x] >> y) & 1UL) ? 1 : 0;
 }
 
 void
@@ -3641,51 +3670,66 @@ xchar c;
     if (x < 0 || y < 0 || x >= sel->wid || y >= sel->hei)
         return;
 
-    sel->map[sel->wid * y + x] = (char) (c + 1);
+    if (c)
+        sel->map[x] |= (1UL << y);
+    else
+        sel->map[x] &= ~(1UL << y);
 }
 
 struct selectionvar *
 selection_not(s)
 struct selectionvar *s;
 {
-    int x, y;
-
+    unsigned long mask = SEL_COLMASK(s);
+    int x;
 
     for (x = 0; x < s->wid; x++)
-        for (y = 0; y < s->hei; y++)
-            selection_setpoint(x, y, s, selection_getpoint(x, y, s) ? 0 : 1);
+        s->map[x] = ~s->map[x] & mask;
 
     return s;
 }
 
+/* combine s2 into s1:  oper is '|' (union), '&' (intersection),
+   or '^' (symmetric difference) */
+void
+selection_combine(s1, s2, oper)
+struct selectionvar *s1, *s2;
+char oper;
+{
+    unsigned long col2;
+    int x;
+
+    for (x = 0; x < s1->wid; x++) {
+        col2 = (s2 && s2->map && x < s2->wid) ? s2->map[x] : 0UL;
+        switch (oper) {
+        default:
+        case '|':
+            s1->map[x] |= col2;
+            break;
+        case '&':
+            s1->map[x] &= col2;
+            break;
+        case '^':
+            s1->map[x] ^= col2;
+            break;
+        }
+    }
+}
+
 struct selectionvar *
 selection_logical_oper(s1, s2, oper)
 struct selectionvar *s1, *s2;
 char oper;
 {
     struct selectionvar *ov;
-    int x, y;
 
     ov = selection_new();
     if (!ov)
         return NULL;
 
-    for (x = 0; x < ov->wid; x++)
-        for (y = 0; y < ov->hei; y++) {
-            switch (oper) {
-            default:
-            case '|':
-                if (selection_getpoint(x, y, s1)
-                    || selection_getpoint(x, y, s2))
-                    selection_setpoint(x, y, ov, 1);
-                break;
-            case '&':
-                if (selection_getpoint(x, y, s1)
-                    && selection_getpoint(x, y, s2))
-                    selection_setpoint(x, y, ov, 1);
-                break;
-            }
-        }
+    if (s1 && s1->map)
+        selection_combine(ov, s1, '|');
+    selection_combine(ov, s2, oper);
 
     return ov;
 }
@@ -3697,14 +3741,15 @@ xchar typ;
 int lit;
 {
     int x, y;
+    unsigned long bits;
     struct selectionvar *ret = selection_new();
 
     if (!ov || !ret)
         return NULL;
 
-    for (x = 0; x < ret->wid; x++)
-        for (y = 0; y < ret->hei; y++)
-            if (selection_getpoint(x, y, ov) && (levl[x][y].typ == typ)) {
+    for (x = 0; x < ret->wid && x < ov->wid; x++)
+        for (y = 0, bits = ov->map[x]; bits; y++, bits >>= 1)
+            if ((bits & 1UL) && (levl[x][y].typ == typ)) {
                 switch (lit) {
                 default:
                 case -2:
@@ -3729,13 +3774,27 @@ struct selectionvar *ov;
 int percent;
 {
     int x, y;
+    unsigned long bits;
 
     if (!ov)
         return;
     for (x = 0; x < ov->wid; x++)
-        for (y = 0; y < ov->hei; y++)
-            if (selection_getpoint(x, y, ov) && (rn2(100) >= percent))
-                selection_setpoint(x, y, ov, 0);
+        for (y = 0, bits = ov->map[x]; bits; y++, bits >>= 1)
+            if ((bits & 1UL) && (rn2(100) >= percent))
+                ov->map[x] &= ~(1UL << y);
+}
+
+/* how many spots are selected */
+int
+selection_count(ov)
+struct selectionvar *ov;
+{
+    int x, n = 0;
+
+    if (ov && ov->map)
+        for (x = 0; x < ov->wid; x++)
+            n += sel_bitcount(ov->map[x]);
+    return n;
 }
 
 int
@@ -3744,29 +3803,23 @@ struct selectionvar *ov;
 schar *x, *y;
 boolean removeit;
 {
-    int idx = 0;
-    int c;
+    int idx = selection_count(ov);
+    int c, n;
     int dx, dy;
-
-    for (dx = 0; dx < ov->wid; dx++)
-        for (dy = 0; dy < ov->hei; dy++)
-            if (selection_getpoint(dx, dy, ov))
-                idx++;
+    unsigned long bits;
 
     if (idx) {
+        /* find the c'th selected spot, counting down x then y */
         c = rn2(idx);
-        for (dx = 0; dx < ov->wid; dx++)
-            for (dy = 0; dy < ov->hei; dy++)
-                if (selection_getpoint(dx, dy, ov)) {
-                    if (!c) {
-                        *x = dx;
-                        *y = dy;
-                        if (removeit)
-                            selection_setpoint(dx, dy, ov, 0);
-                        return 1;
-                    }
-                    c--;
-                }
+        for (dx = 0; (n = sel_bitcount(ov->map[dx])) <= c; dx++)
+            c -= n;
+        for (dy = 0, bits = ov->map[dx]; !(bits & 1UL) || c--; dy++)
+            bits >>= 1;
+        *x = dx;
+        *y = dy;
+        if (removeit)
+            ov->map[dx] &= ~(1UL << dy);
+        return 1;
     }
     *x = *y = -1;
     return 0;
@@ -3777,41 +3830,44 @@ selection_do_grow(ov, dir)
 struct selectionvar *ov;
 int dir;
 {
-    int x, y;
-    struct selectionvar *tmp = selection_new();
+    unsigned long grown[COLNO], left, here, right, mask;
+    int x;
 
-    if (!ov || !tmp)
+    if (!ov || !ov->map)
         return;
 
-    for (x = 1; x < ov->wid; x++)
-        for (y = 0; y < ov->hei; y++) {
-            /* note:  dir is a mask of multiple directions, but the only
-               way to specify diagonals is by including the two adjacent
-               orthogonal directions, which effectively specifies three-
-               way growth [WEST|NORTH => WEST plus WEST|NORTH plus NORTH] */
-            if (((dir & W_WEST) && selection_getpoint(x + 1, y, ov))
-                || (((dir & (W_WEST | W_NORTH)) == (W_WEST | W_NORTH))
-                    && selection_getpoint(x + 1, y + 1, ov))
-                || ((dir & W_NORTH) && selection_getpoint(x, y + 1, ov))
-                || (((dir & (W_NORTH | W_EAST)) == (W_NORTH | W_EAST))
-                    && selection_getpoint(x - 1, y + 1, ov))
-                || ((dir & W_EAST) && selection_getpoint(x - 1, y, ov))
-                || (((dir & (W_EAST | W_SOUTH)) == (W_EAST | W_SOUTH))
-                    && selection_getpoint(x - 1, y - 1, ov))
-                || ((dir & W_SOUTH) && selection_getpoint(x, y - 1, ov))
-                ||  (((dir & (W_SOUTH | W_WEST)) == (W_SOUTH | W_WEST))
-                     && selection_getpoint(x + 1, y - 1, ov))) {
-                selection_setpoint(x, y, tmp, 1);
-            }
-        }
-
-    for (x = 1; x < ov->wid; x++)
-        for (y = 0; y < ov->hei; y++)
-            if (selection_getpoint(x, y, tmp))
-                selection_setpoint(x, y, ov, 1);
-
-    selection_free(tmp);
-    free(tmp);
+    /* note:  dir is a mask of multiple directions, but the only
+       way to specify diagonals is by including the two adjacent
+       orthogonal directions, which effectively specifies three-
+       way growth [WEST|NORTH => WEST plus WEST|NORTH plus NORTH];
+       growing west means selecting a spot whose east neighbor is
+       selected, north one whose south neighbor is, and so on */
+    mask = SEL_COLMASK(ov);
+    for (x = 1; x < ov->wid && x < COLNO; x++) {
+        left = ov->map[x - 1];
+        here = ov->map[x];
+        right = (x + 1 < ov->wid) ? ov->map[x + 1] : 0UL;
+        grown[x] = 0UL;
+        if (dir & W_WEST)
+            grown[x] |= right;
+        if ((dir & (W_WEST | W_NORTH)) == (W_WEST | W_NORTH))
+            grown[x] |= right >> 1;
+        if (dir & W_NORTH)
+            grown[x] |= here >> 1;
+        if ((dir & (W_NORTH | W_EAST)) == (W_NORTH | W_EAST))
+            grown[x] |= left >> 1;
+        if (dir & W_EAST)
+            grown[x] |= left;
+        if ((dir & (W_EAST | W_SOUTH)) == (W_EAST | W_SOUTH))
+            grown[x] |= left << 1;
+        if (dir & W_SOUTH)
+            grown[x] |= here << 1;
+        if ((dir & (W_SOUTH | W_WEST)) == (W_SOUTH | W_WEST))
+            grown[x] |= right << 1;
+    }
+    /* column 0 is never grown into */
+    for (x = 1; x < ov->wid && x < COLNO; x++)
+        ov->map[x] |= grown[x] & mask;
 }
 
 static int FDECL((*selection_flood_check_func), (int, int));
@@ -3848,23 +3904,6 @@ int x, y;
             || levl[x][y].typ == SCORR);
 }
 
-/* check whethere <x,y> is already in xs[],ys[] */
-static boolean
-sel_flood_havepoint(x, y, xs, ys, n)
-int x, y;
-xchar xs[], ys[];
-int n;
-{
-    xchar xx = (xchar) x, yy = (xchar) y;
-
-    while (n > 0) {
-        --n;
-        if (xs[n] == xx && ys[n] == yy)
-            return TRUE;
-    }
-    return FALSE;
-}
-
 void
 selection_floodfill(ov, x, y, diagonals)
 struct selectionvar *ov;
@@ -3873,12 +3912,14 @@ boolean diagonals;
 {
     struct selectionvar *tmp = selection_new();
 #define SEL_FLOOD_STACK (COLNO * ROWNO)
+/* tmp holds the spots that have been stacked, so none is stacked twice */
 #define SEL_FLOOD(nx, ny) \
     do {                                      \
         if (idx < SEL_FLOOD_STACK) {          \
             dx[idx] = (nx);                   \
             dy[idx] = (ny);                   \
             idx++;                            \
+            selection_setpoint((nx), (ny), tmp, 1); \
         } else                                \
             panic(floodfill_stack_overrun);   \
     } while (0)
@@ -3886,8 +3927,7 @@ boolean diagonals;
     do {                                                        \
         if (isok((mx), (my))                                    \
             && (*selection_flood_check_func)((mx), (my))        \
-            && !selection_getpoint((mx), (my), (sel))           \
-            && !sel_flood_havepoint((mx), (my), dx, dy, idx))   \
+            && !selection_getpoint((mx), (my), (sel)))          \
             SEL_FLOOD((mx), (my));                              \
     } while (0)
     static const char floodfill_stack_overrun[] = "floodfill stack overrun";
@@ -3904,10 +3944,8 @@ boolean diagonals;
         idx--;
         x = dx[idx];
         y = dy[idx];
-        if (isok(x, y)) {
+        if (isok(x, y))
             selection_setpoint(x, y, ov, 1);
-            selection_setpoint(x, y, tmp, 1);
-        }
         SEL_FLOOD_CHKDIR((x + 1), y, tmp);
         SEL_FLOOD_CHKDIR((x - 1), y, tmp);
         SEL_FLOOD_CHKDIR(x, (y + 1), tmp);
@@ -4193,14 +4231,14 @@ select_iter_func func;
 genericptr_t arg;
 {
     int x, y;
+    unsigned long bits;
 
     if (!ov)
         return;
 
-    /* yes, this is very naive, but it's not _that_ expensive. */
     for (x = 0; x < ov->wid; x++)
-        for (y = 0; y < ov->hei; y++)
-            if (selection_getpoint(x, y, ov))
+        for (y = 0, bits = ov->map[x]; bits; y++, bits >>= 1)
+            if (bits & 1UL)
                 (*func)(x, y, arg);
 }
 
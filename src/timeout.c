@@ -1635,7 +1635,7 @@ do_storms()
  *      Start a timer of kind 'kind' that will expire at time
  *      g.monstermoves+'timeout'.  Call the function at 'func_index'
  *      in the timeout table using argument 'arg'.  Return TRUE if
- *      a timer was started.  This places the timer on a list ordered
+ *      a timer was started.  This places the timer in a queue ordered
  *      "sooner" to "later".  If an object, increment the object's
  *      timer count.
  *
@@ -1682,10 +1682,21 @@ do_storms()
  */
 
 static const char *FDECL(kind_name, (SHORT_P));
-static void FDECL(print_queue, (winid, timer_element *));
+static void FDECL(print_queue, (winid));
+static unsigned FDECL(timer_hashval, (SHORT_P, ANY_P *));
+static void FDECL(timer_hash_link, (timer_element *));
+static void FDECL(timer_hash_unlink, (timer_element *));
+static boolean FDECL(timer_before, (timer_element *, timer_element *));
+static void FDECL(timer_siftup, (int));
+static void FDECL(timer_siftdown, (int));
+static int FDECL(CFDECLSPEC timer_cmp, (const genericptr,
+                                        const genericptr));
+static timer_element **NDECL(sorted_timers);
+static timer_element *FDECL(find_timer, (SHORT_P, SHORT_P, ANY_P *));
+static int FDECL(obj_timers, (struct obj *, timer_element **));
 static void FDECL(insert_timer, (timer_element *));
-static timer_element *FDECL(remove_timer,
-                                (timer_element **, SHORT_P, ANY_P *));
+static void FDECL(unlink_timer, (timer_element *));
+static timer_element *FDECL(remove_timer, (SHORT_P, ANY_P *));
 static void FDECL(write_timer, (NHFILE *, timer_element *));
 static boolean FDECL(mon_is_local, (struct monst *));
 static boolean FDECL(timer_is_local, (timer_element *));
@@ -1740,18 +1751,20 @@ short kind;
 }
 
 static void
-print_queue(win, base)
+print_queue(win)
 winid win;
-timer_element *base;
 {
-    timer_element *curr;
+    timer_element *curr, **list;
     char buf[BUFSZ];
+    int i;
 
-    if (!base) {
+    if (!g.timer_count) {
         putstr(win, 0, " <empty>");
     } else {
         putstr(win, 0, "timeout  id   kind   call");
-        for (curr = base; curr; curr = curr->next) {
+        list = sorted_timers();
+        for (i = 0; i < g.timer_count; i++) {
+            curr = list[i];
 #ifdef VERBOSE_TIMER
             Sprintf(buf, " %4ld   %4ld  %-6s %s(%s)", curr->timeout,
                     curr->tid, kind_name(curr->kind),
@@ -1764,6 +1777,7 @@ timer_element *base;
 #endif
             putstr(win, 0, buf);
         }
+        free((genericptr_t) list);
     }
 }
 
@@ -1785,7 +1799,7 @@ wiz_timeout_queue()
     putstr(win, 0, "");
     putstr(win, 0, "Active timeout queue:");
     putstr(win, 0, "");
-    print_queue(win, g.timer_base);
+    print_queue(win);
 
     /* Timed properies:
      * check every one; the majority can't obtain temporary timeouts in
@@ -1837,9 +1851,17 @@ void
 timer_sanity_check()
 {
     timer_element *curr;
+    int i;
 
     /* this should be much more complete */
-    for (curr = g.timer_base; curr; curr = curr->next)
+    for (i = 0; i < g.timer_count; i++) {
+        curr = g.timer_heap[i];
+        if (curr->heapidx != i
+            || (i > 0 && timer_before(curr, g.timer_heap[(i - 1) / 2])))
+            impossible("timer sanity: timer %ld out of place (%d, %d)",
+                       curr->tid, curr->heapidx, i);
+        if (find_timer(curr->kind, curr->func_index, &curr->arg) != curr)
+            impossible("timer sanity: timer %ld not hashed", curr->tid);
         if (curr->kind == TIMER_OBJECT) {
             struct obj *obj = curr->arg.a_obj;
 
@@ -1848,6 +1870,7 @@ timer_sanity_check()
                       fmt_ptr((genericptr_t) obj), curr->tid);
             }
         }
+    }
 }
 
 /*
@@ -1861,12 +1884,12 @@ run_timers()
 
     /*
      * Always use the first element.  Elements may be added or deleted at
-     * any time.  The list is ordered, we are done when the first element
+     * any time.  The queue is ordered, we are done when the first element
      * is in the future.
      */
-    while (g.timer_base && g.timer_base->timeout <= g.monstermoves) {
-        curr = g.timer_base;
-        g.timer_base = curr->next;
+    while (g.timer_count && g.timer_heap[0]->timeout <= g.monstermoves) {
+        curr = g.timer_heap[0];
+        unlink_timer(curr);
 
         if (curr->kind == TIMER_OBJECT)
             (curr->arg.a_obj)->timed--;
@@ -1885,19 +1908,14 @@ short kind;
 short func_index;
 anything *arg;
 {
-    timer_element *gnu, *dup;
+    timer_element *gnu;
 
     if (kind < 0 || kind >= NUM_TIMER_KINDS
         || func_index < 0 || func_index >= NUM_TIME_FUNCS)
         panic("start_timer (%s: %d)", kind_name(kind), (int) func_index);
 
     /* fail if <arg> already has a <func_index> timer running */
-    for (dup = g.timer_base; dup; dup = dup->next)
-        if (dup->kind == kind
-            && dup->func_index == func_index
-            && dup->arg.a_void == arg->a_void)
-            break;
-    if (dup) {
+    if (find_timer(kind, func_index, arg)) {
         char idbuf[QBUFSZ];
 
 #ifdef VERBOSE_TIMER
@@ -1938,7 +1956,7 @@ anything *arg;
     timer_element *doomed;
     long timeout;
 
-    doomed = remove_timer(&g.timer_base, func_index, arg);
+    doomed = remove_timer(func_index, arg);
 
     if (doomed) {
         timeout = doomed->timeout;
@@ -1960,13 +1978,9 @@ peek_timer(type, arg)
 short type;
 anything *arg;
 {
-    timer_element *curr;
+    timer_element *curr = find_timer(-1, type, arg);
 
-    for (curr = g.timer_base; curr; curr = curr->next) {
-        if (curr->func_index == type && curr->arg.a_void == arg->a_void)
-            return curr->timeout;
-    }
-    return 0L;
+    return curr ? curr->timeout : 0L;
 }
 
 /*
@@ -1976,15 +1990,16 @@ void
 obj_move_timers(src, dest)
 struct obj *src, *dest;
 {
-    int count;
-    timer_element *curr;
-
-    for (count = 0, curr = g.timer_base; curr; curr = curr->next)
-        if (curr->kind == TIMER_OBJECT && curr->arg.a_obj == src) {
-            curr->arg.a_obj = dest;
-            dest->timed++;
-            count++;
-        }
+    int i, count;
+    timer_element *tlist[NUM_TIME_FUNCS];
+
+    count = obj_timers(src, tlist);
+    for (i = 0; i < count; i++) {
+        timer_hash_unlink(tlist[i]);
+        tlist[i]->arg.a_obj = dest;
+        timer_hash_link(tlist[i]);
+        dest->timed++;
+    }
     if (count != src->timed)
         panic("obj_move_timers");
     src->timed = 0;
@@ -1997,15 +2012,13 @@ void
 obj_split_timers(src, dest)
 struct obj *src, *dest;
 {
-    timer_element *curr, *next_timer = 0;
+    int i, count;
+    timer_element *tlist[NUM_TIME_FUNCS];
 
-    for (curr = g.timer_base; curr; curr = next_timer) {
-        next_timer = curr->next; /* things may be inserted */
-        if (curr->kind == TIMER_OBJECT && curr->arg.a_obj == src) {
-            (void) start_timer(curr->timeout - g.monstermoves, TIMER_OBJECT,
-                               curr->func_index, obj_to_any(dest));
-        }
-    }
+    count = obj_timers(src, tlist);
+    for (i = 0; i < count; i++)
+        (void) start_timer(tlist[i]->timeout - g.monstermoves, TIMER_OBJECT,
+                           tlist[i]->func_index, obj_to_any(dest));
 }
 
 /*
@@ -2016,22 +2029,17 @@ void
 obj_stop_timers(obj)
 struct obj *obj;
 {
-    timer_element *curr, *prev, *next_timer = 0;
-
-    for (prev = 0, curr = g.timer_base; curr; curr = next_timer) {
-        next_timer = curr->next;
-        if (curr->kind == TIMER_OBJECT && curr->arg.a_obj == obj) {
-            if (prev)
-                prev->next = curr->next;
-            else
-                g.timer_base = curr->next;
-            if (timeout_funcs[curr->func_index].cleanup)
-                (*timeout_funcs[curr->func_index].cleanup)(&curr->arg,
-                                                           curr->timeout);
-            free((genericptr_t) curr);
-        } else {
-            prev = curr;
-        }
+    int i, count;
+    timer_element *curr, *tlist[NUM_TIME_FUNCS];
+
+    count = obj_timers(obj, tlist);
+    for (i = 0; i < count; i++) {
+        curr = tlist[i];
+        unlink_timer(curr);
+        if (timeout_funcs[curr->func_index].cleanup)
+            (*timeout_funcs[curr->func_index].cleanup)(&curr->arg,
+                                                       curr->timeout);
+        free((genericptr_t) curr);
     }
     obj->timed = 0;
 }
@@ -2058,24 +2066,17 @@ spot_stop_timers(x, y, func_index)
 xchar x, y;
 short func_index;
 {
-    timer_element *curr, *prev, *next_timer = 0;
-    long where = (((long) x << 16) | ((long) y));
-
-    for (prev = 0, curr = g.timer_base; curr; curr = next_timer) {
-        next_timer = curr->next;
-        if (curr->kind == TIMER_LEVEL && curr->func_index == func_index
-            && curr->arg.a_long == where) {
-            if (prev)
-                prev->next = curr->next;
-            else
-                g.timer_base = curr->next;
-            if (timeout_funcs[curr->func_index].cleanup)
-                (*timeout_funcs[curr->func_index].cleanup)(&curr->arg,
-                                                           curr->timeout);
-            free((genericptr_t) curr);
-        } else {
-            prev = curr;
-        }
+    timer_element *curr;
+    anything any;
+
+    any = cg.zeroany;
+    any.a_long = (((long) x << 16) | ((long) y));
+    while ((curr = find_timer(TIMER_LEVEL, func_index, &any)) != 0) {
+        unlink_timer(curr);
+        if (timeout_funcs[curr->func_index].cleanup)
+            (*timeout_funcs[curr->func_index].cleanup)(&curr->arg,
+                                                       curr->timeout);
+        free((genericptr_t) curr);
     }
 }
 
@@ -2089,14 +2090,12 @@ xchar x, y;
 short func_index;
 {
     timer_element *curr;
-    long where = (((long) x << 16) | ((long) y));
+    anything any;
 
-    for (curr = g.timer_base; curr; curr = curr->next) {
-        if (curr->kind == TIMER_LEVEL && curr->func_index == func_index
-            && curr->arg.a_long == where)
-            return curr->timeout;
-    }
-    return 0L;
+    any = cg.zeroany;
+    any.a_long = (((long) x << 16) | ((long) y));
+    curr = find_timer(TIMER_LEVEL, func_index, &any);
+    return curr ? curr->timeout : 0L;
 }
 
 long
@@ -2108,43 +2107,233 @@ short func_index;
     return (expires > 0L) ? expires - g.monstermoves : 0L;
 }
 
-/* Insert timer into the global queue */
+/*
+ * The queue is a binary heap ordered by timeout, g.timer_heap[0] being
+ * the next timer to go off, and each timer is also on a hash chain keyed
+ * by its function index and argument so that it can be found without a
+ * search.  Timers due on the same turn go off most recently queued first,
+ * as they did when the queue was a sorted list; 'seq' records the order.
+ */
+#define TIMER_HASHSIZE 256
+
+static unsigned
+timer_hashval(func_index, arg)
+short func_index;
+anything *arg;
+{
+    unsigned long h = arg->a_ulong;
+
+    h ^= (h >> 7) ^ (h >> 17);
+    return (unsigned) ((h + (unsigned long) func_index * 31UL)
+                       % TIMER_HASHSIZE);
+}
+
 static void
-insert_timer(gnu)
-timer_element *gnu;
+timer_hash_link(te)
+timer_element *te;
 {
-    timer_element *curr, *prev;
+    unsigned h = timer_hashval(te->func_index, &te->arg);
+
+    te->next = g.timer_hash[h];
+    g.timer_hash[h] = te;
+}
 
-    for (prev = 0, curr = g.timer_base; curr; prev = curr, curr = curr->next)
-        if (curr->timeout >= gnu->timeout)
+static void
+timer_hash_unlink(te)
+timer_element *te;
+{
+    timer_element **tp;
+
+    for (tp = &g.timer_hash[timer_hashval(te->func_index, &te->arg)]; *tp;
+         tp = &(*tp)->next)
+        if (*tp == te) {
+            *tp = te->next;
             break;
+        }
+    te->next = 0;
+}
 
-    gnu->next = curr;
-    if (prev)
-        prev->next = gnu;
-    else
-        g.timer_base = gnu;
+/* does timer 'a' go off before timer 'b'? */
+static boolean
+timer_before(a, b)
+timer_element *a, *b;
+{
+    return (boolean) (a->timeout < b->timeout
+                      || (a->timeout == b->timeout && a->seq > b->seq));
 }
 
+static void
+timer_siftup(idx)
+int idx;
+{
+    timer_element **heap = g.timer_heap, *te = heap[idx];
+    int parent;
+
+    while (idx > 0) {
+        parent = (idx - 1) / 2;
+        if (!timer_before(te, heap[parent]))
+            break;
+        heap[idx] = heap[parent];
+        heap[idx]->heapidx = idx;
+        idx = parent;
+    }
+    heap[idx] = te;
+    te->heapidx = idx;
+}
+
+static void
+timer_siftdown(idx)
+int idx;
+{
+    timer_element **heap = g.timer_heap, *te = heap[idx];
+    int child;
+
+    while ((child = 2 * idx + 1) < g.timer_count) {
+        if (child + 1 < g.timer_count
+            && timer_before(heap[child + 1], heap[child]))
+            child++;
+        if (!timer_before(heap[child], te))
+            break;
+        heap[idx] = heap[child];
+        heap[idx]->heapidx = idx;
+        idx = child;
+    }
+    heap[idx] = te;
+    te->heapidx = idx;
+}
+
+/* qsort comparison routine for sorted_timers() */
+static int CFDECLSPEC
+timer_cmp(vptr1, vptr2)
+const genericptr vptr1;
+const genericptr vptr2;
+{
+    timer_element *te1 = *(timer_element **) vptr1,
+                  *te2 = *(timer_element **) vptr2;
+
+    return timer_before(te1, te2) ? -1 : timer_before(te2, te1) ? 1 : 0;
+}
+
+/* the queue in the order it will run; caller frees the array */
+static timer_element **
+sorted_timers()
+{
+    timer_element **list;
+
+    list = (timer_element **) alloc((unsigned) max(g.timer_count, 1)
+                                    * sizeof (timer_element *));
+    if (g.timer_count) {
+        (void) memcpy((genericptr_t) list, (genericptr_t) g.timer_heap,
+                      (size_t) g.timer_count * sizeof (timer_element *));
+        qsort((genericptr_t) list, (size_t) g.timer_count,
+              sizeof (timer_element *), timer_cmp);
+    }
+    return list;
+}
+
+/* find the first timer in the queue for (func_index, arg) of the given
+   kind, or of any kind if 'kind' is -1 */
 static timer_element *
-remove_timer(base, func_index, arg)
-timer_element **base;
+find_timer(kind, func_index, arg)
+short kind;
 short func_index;
 anything *arg;
 {
-    timer_element *prev, *curr;
+    timer_element *curr, *found = 0;
+
+    if (!g.timer_hash)
+        return (timer_element *) 0;
+    for (curr = g.timer_hash[timer_hashval(func_index, arg)]; curr;
+         curr = curr->next)
+        if (curr->func_index == func_index
+            && curr->arg.a_void == arg->a_void
+            && (kind == -1 || curr->kind == kind)
+            && (!found || timer_before(curr, found)))
+            found = curr;
+    return found;
+}
 
-    for (prev = 0, curr = *base; curr; prev = curr, curr = curr->next)
-        if (curr->func_index == func_index && curr->arg.a_void == arg->a_void)
-            break;
+/* collect the timers attached to obj, in queue order; an object has at
+   most one timer for each function */
+static int
+obj_timers(obj, tlist)
+struct obj *obj;
+timer_element **tlist; /* NUM_TIME_FUNCS entries */
+{
+    timer_element *curr;
+    short f;
+    int i, count = 0;
+
+    for (f = 0; f < NUM_TIME_FUNCS; f++) {
+        curr = find_timer(TIMER_OBJECT, f, obj_to_any(obj));
+        if (!curr)
+            continue;
+        for (i = count++; i > 0 && timer_before(curr, tlist[i - 1]); i--)
+            tlist[i] = tlist[i - 1];
+        tlist[i] = curr;
+    }
+    return count;
+}
 
-    if (curr) {
-        if (prev)
-            prev->next = curr->next;
+/* Insert timer into the global queue */
+static void
+insert_timer(gnu)
+timer_element *gnu;
+{
+    timer_element **newheap;
+    int newmax;
+
+    if (!g.timer_hash) {
+        g.timer_hash = (timer_element **) alloc(TIMER_HASHSIZE
+                                                * sizeof (timer_element *));
+        (void) memset((genericptr_t) g.timer_hash, 0,
+                      TIMER_HASHSIZE * sizeof (timer_element *));
+    }
+    if (g.timer_count == g.timer_heapmax) {
+        newmax = g.timer_heapmax ? 2 * g.timer_heapmax : 64;
+        newheap = (timer_element **) alloc((unsigned) newmax
+                                           * sizeof (timer_element *));
+        if (g.timer_heap) {
+            (void) memcpy((genericptr_t) newheap, (genericptr_t) g.timer_heap,
+                          (size_t) g.timer_count * sizeof (timer_element *));
+            free((genericptr_t) g.timer_heap);
+        }
+        g.timer_heap = newheap;
+        g.timer_heapmax = newmax;
+    }
+    gnu->seq = ++g.timer_seq;
+    timer_hash_link(gnu);
+    g.timer_heap[g.timer_count] = gnu;
+    timer_siftup(g.timer_count++);
+}
+
+/* take timer out of the global queue, without freeing it */
+static void
+unlink_timer(te)
+timer_element *te;
+{
+    int idx = te->heapidx;
+
+    timer_hash_unlink(te);
+    if (idx < --g.timer_count) {
+        g.timer_heap[idx] = g.timer_heap[g.timer_count];
+        if (idx > 0 && timer_before(g.timer_heap[idx],
+                                    g.timer_heap[(idx - 1) / 2]))
+            timer_siftup(idx);
         else
-            *base = curr->next;
+            timer_siftdown(idx);
     }
+}
+
+static timer_element *
+remove_timer(func_index, arg)
+short func_index;
+anything *arg;
+{
+    timer_element *curr = find_timer(-1, func_index, arg);
 
+    if (curr)
+        unlink_timer(curr);
     return curr;
 }
 
@@ -2280,10 +2469,13 @@ NHFILE *nhfp;
 int range;
 boolean write_it;
 {
-    int count = 0;
-    timer_element *curr;
+    int i, count = 0;
+    timer_element *curr, **list;
 
-    for (curr = g.timer_base; curr; curr = curr->next) {
+    /* write them in queue order, which restore_timers() preserves */
+    list = write_it ? sorted_timers() : g.timer_heap;
+    for (i = 0; i < g.timer_count; i++) {
+        curr = list[i];
         if (range == RANGE_GLOBAL) {
             /* global timers */
 
@@ -2300,6 +2492,8 @@ boolean write_it;
             }
         }
     }
+    if (write_it)
+        free((genericptr_t) list);
 
     return count;
 }
@@ -2323,8 +2517,8 @@ save_timers(nhfp, range)
 NHFILE *nhfp;
 int range;
 {
-    timer_element *curr, *prev, *next_timer = 0;
-    int count;
+    timer_element *curr;
+    int i, count;
 
     if (perform_bwrite(nhfp)) {
         if (range == RANGE_GLOBAL) {
@@ -2338,20 +2532,25 @@ int range;
     }
 
     if (release_data(nhfp)) {
-        for (prev = 0, curr = g.timer_base; curr; curr = next_timer) {
-            next_timer = curr->next; /* in case curr is removed */
-
+        for (i = count = 0; i < g.timer_count; i++) {
+            curr = g.timer_heap[i];
             if (!(!!(range == RANGE_LEVEL) ^ !!timer_is_local(curr))) {
-                if (prev)
-                    prev->next = curr->next;
-                else
-                    g.timer_base = curr->next;
+                timer_hash_unlink(curr);
                 free((genericptr_t) curr);
-                /* prev stays the same */
             } else {
-                prev = curr;
+                g.timer_heap[count] = curr;
+                curr->heapidx = count++;
             }
         }
+        g.timer_count = count;
+        /* what's left keeps its order but has to be re-heaped */
+        for (i = count / 2 - 1; i >= 0; i--)
+            timer_siftdown(i);
+        if (!count && g.timer_heap) {
+            free((genericptr_t) g.timer_heap), g.timer_heap = 0;
+            free((genericptr_t) g.timer_hash), g.timer_hash = 0;
+            g.timer_heapmax = 0;
+        }
     }
 }
 
@@ -2395,14 +2594,9 @@ const char *hdrfmt;
 char *hdrbuf;
 long *count, *size;
 {
-    timer_element *te;
-
     Sprintf(hdrbuf, hdrfmt, (long) sizeof (timer_element));
-    *count = *size = 0L;
-    for (te = g.timer_base; te; te = te->next) {
-        ++*count;
-        *size += (long) sizeof *te;
-    }
+    *count = (long) g.timer_count;
+    *size = *count * (long) sizeof (timer_element);
 }
 
 /* reset all timers that are marked for reseting */
@@ -2412,8 +2606,10 @@ boolean ghostly;
 {
     timer_element *curr;
     unsigned nid;
+    int i;
 
-    for (curr = g.timer_base; curr; curr = curr->next) {
+    for (i = 0; i < g.timer_count; i++) {
+        curr = g.timer_heap[i];
         if (curr->needs_fixup) {
             if (curr->kind == TIMER_OBJECT) {
                 if (ghostly) {
@@ -2421,10 +2617,13 @@ boolean ghostly;
                         panic("relink_timers 1");
                 } else
                     nid = curr->arg.a_uint;
+                /* its hash chain depends on arg */
+                timer_hash_unlink(curr);
                 curr->arg.a_obj = find_oid(nid);
                 if (!curr->arg.a_obj)
                     panic("cant find o_id %d", nid);
                 curr->needs_fixup = 0;
+                timer_hash_link(curr);
             } else if (curr->kind == TIMER_MONSTER) {
                 panic("relink_timers: no monster timer implemented");
             } else
@@ -342,6 +342,7 @@ int x, y, typ;
         ttmp->tx = x;
         ttmp->ty = y;
     }
+    g.travel_gen++;
     /* [re-]initialize all fields except ntrap (handled below) and <tx,ty> */
     ttmp->vl = zero_vl;
     ttmp->launch.x = ttmp->launch.y = -1; /* force error if used before set */
@@ -431,6 +432,7 @@ int x, y, typ;
     if (!oldplace) {
         ttmp->ntrap = g.ftrap;
         g.ftrap = ttmp;
+        g.level.traps[x][y] = ttmp;
     } else {
         /* oldplace;
            it shouldn't be possible to override a sokoban pit or hole
@@ -2015,6 +2017,7 @@ struct trap *trap;
 {
     if (!trap->tseen) {
         trap->tseen = 1;
+        g.travel_gen++;
         newsym(trap->tx, trap->ty);
     }
 }
@@ -2025,6 +2028,7 @@ feeltrap(trap)
 struct trap *trap;
 {
     trap->tseen = 1;
+    g.travel_gen++;
     map_trap(trap, 1);
     /* in case it's beneath something, redisplay the something */
     newsym(trap->tx, trap->ty);
@@ -4978,14 +4982,9 @@ struct trap *
 t_at(x, y)
 register int x, y;
 {
-    register struct trap *trap = g.ftrap;
-
-    while (trap) {
-        if (trap->tx == x && trap->ty == y)
-            return trap;
-        trap = trap->ntrap;
-    }
-    return (struct trap *) 0;
+    if (!isok(x, y))
+        return (struct trap *) 0;
+    return g.level.traps[x][y];
 }
 
 void
@@ -4995,6 +4994,7 @@ register struct trap *trap;
     register struct trap *ttmp;
 
     clear_conjoined_pits(trap);
+    g.travel_gen++;
     if (trap == g.ftrap) {
         g.ftrap = g.ftrap->ntrap;
     } else {
@@ -5005,6 +5005,8 @@ register struct trap *trap;
             panic("deltrap: no preceding trap!");
         ttmp->ntrap = trap->ntrap;
     }
+    if (g.level.traps[trap->tx][trap->ty] == trap)
+        g.level.traps[trap->tx][trap->ty] = (struct trap *) 0;
     if (Sokoban && (trap->ttyp == PIT || trap->ttyp == HOLE))
         maybe_finish_sokoban();
     dealloc_trap(trap);
@@ -5528,4 +5530,26 @@ boolean override;
     return defsyms[trap_to_defsym(ttyp)].explanation;
 }
 
+/* traps are allocated from the current level's arena, so one which isn't
+   has been left over from another level */
+void
+trap_sanity_check()
+{
+    struct trap *ttmp;
+    int x, y;
+
+    for (ttmp = g.ftrap; ttmp; ttmp = ttmp->ntrap)
+        if (!arena_owns(&g.level.arena, (genericptr_t) ttmp)) {
+            impossible("trap sanity: stray trap %s in ftrap",
+                       fmt_ptr((genericptr_t) ttmp));
+            return; /* can't follow its ntrap */
+        }
+    for (x = 0; x < COLNO; x++)
+        for (y = 0; y < ROWNO; y++)
+            if ((ttmp = g.level.traps[x][y]) != 0
+                && !arena_owns(&g.level.arena, (genericptr_t) ttmp))
+                impossible("trap sanity: stray trap %s at <%d,%d>",
+                           fmt_ptr((genericptr_t) ttmp), x, y);
+}
+
 /*trap.c*/
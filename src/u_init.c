@@ -645,10 +645,13 @@ u_init()
     u.ualignbase[A_CURRENT] = u.ualignbase[A_ORIGINAL] = u.ualign.type =
         aligns[flags.initalign].value;
 
+    if (fixed_gametime)
+        ubirthday = fixed_gametime;
+    else
 #if defined(BSD) && !defined(POSIX_TYPES)
-    (void) time((long *) &ubirthday);
+        (void) time((long *) &ubirthday);
 #else
-    (void) time(&ubirthday);
+        (void) time(&ubirthday);
 #endif
 
     /*
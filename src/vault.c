@@ -23,7 +23,7 @@ struct monst *mtmp;
     if (!mtmp->mextra)
         mtmp->mextra = newmextra();
     if (!EGD(mtmp)) {
-        EGD(mtmp) = (struct egd *) alloc(sizeof (struct egd));
+        EGD(mtmp) = (struct egd *) pool_alloc(&egd_pool);
         (void) memset((genericptr_t) EGD(mtmp), 0, sizeof (struct egd));
     }
 }
@@ -33,7 +33,7 @@ free_egd(mtmp)
 struct monst *mtmp;
 {
     if (mtmp->mextra && EGD(mtmp)) {
-        free((genericptr_t) EGD(mtmp));
+        pool_free(&egd_pool, (genericptr_t) EGD(mtmp));
         EGD(mtmp) = (struct egd *) 0;
     }
     mtmp->isgd = 0;
@@ -91,6 +91,30 @@ static void FDECL(view_from, (int, int, char **, char *, char *, int,
                                   genericptr_t));
 static void FDECL(get_unused_cs, (char ***, char **, char **));
 static void FDECL(rogue_vision, (char **, char *, char *));
+static void NDECL(vcache_clear);
+static void FDECL(vcache_dirty, (int, int));
+static void FDECL(hero_view, (char **, char *, char *));
+
+/*
+ * Could-see cache.  What the hero could see from a spot depends only on
+ * the spot and on viz_clear[][], so the results of the last few
+ * view_from() runs for the hero are kept as bitmaps plus row limits.
+ * When block_point() or unblock_point() change a location, entries that
+ * could see it or a spot next to it are dropped (the same premise
+ * block_point() uses when deciding whether a full recalc is needed);
+ * vision_reset() drops them all.  Standing still, or moving back to a
+ * recently occupied spot, then costs a copy rather than a view_from().
+ */
+#define VCACHE_SIZE 8
+#define VCACHE_ROWBYTES ((COLNO + 7) / 8)
+
+static struct vcache {
+    xchar x, y;    /* hero's position; x == 0 marks an unused entry */
+    unsigned used; /* for picking the least recently used entry */
+    char rmin[ROWNO], rmax[ROWNO];
+    unsigned char bits[ROWNO][VCACHE_ROWBYTES];
+} vcache[VCACHE_SIZE];
+static unsigned vcache_clock;
 
 /* Macro definitions that I can't find anywhere. */
 #define sign(z) ((z) < 0 ? -1 : ((z) ? 1 : 0))
@@ -231,6 +255,8 @@ vision_reset()
         }
     }
 
+    clear_light_cache(-1, -1); /* cached light source areas are stale */
+    vcache_clear();
     iflags.vision_inited = 1; /* vision is ready */
     g.vision_full_recalc = 1;   /* we want to run vision_recalc() */
 }
@@ -271,6 +297,81 @@ char **rmin, **rmax;
     }
 }
 
+static void
+vcache_clear()
+{
+    int i;
+
+    for (i = 0; i < VCACHE_SIZE; i++)
+        vcache[i].x = 0;
+}
+
+/* <x,y> has become blocked or unblocked; drop cache entries affected */
+static void
+vcache_dirty(x, y)
+int x, y;
+{
+    int i, row, col, lo_col = max(x - 1, 0), hi_col = min(x + 1, COLNO - 1),
+        lo_row = max(y - 1, 0), hi_row = min(y + 1, ROWNO - 1);
+    struct vcache *vc;
+
+    for (i = 0, vc = vcache; i < VCACHE_SIZE; i++, vc++)
+        for (row = lo_row; vc->x && row <= hi_row; row++)
+            for (col = lo_col; col <= hi_col; col++)
+                if (vc->bits[row][col >> 3] & (1 << (col & 7))) {
+                    vc->x = 0; /* stale */
+                    break;
+                }
+}
+
+/*
+ * Fill in the could see array and row limits for the hero's position,
+ * from the cache when possible, otherwise via view_from() and then
+ * remember the result.
+ */
+static void
+hero_view(rows, rmin, rmax)
+char **rows;
+char *rmin, *rmax;
+{
+    int i, row, col;
+    struct vcache *vc, *oldest = vcache;
+
+    for (i = 0, vc = vcache; i < VCACHE_SIZE; i++, vc++) {
+        if (vc->x == u.ux && vc->y == u.uy)
+            break;
+        if (!vc->x || (oldest->x && vc->used < oldest->used))
+            oldest = vc;
+    }
+    if (i < VCACHE_SIZE) {
+        for (row = 0; row < ROWNO; row++) {
+            rmin[row] = vc->rmin[row];
+            rmax[row] = vc->rmax[row];
+            for (col = 0; col < COLNO; col++)
+                if (vc->bits[row][col >> 3] & (1 << (col & 7)))
+                    rows[row][col] = COULD_SEE;
+        }
+        vc->used = ++vcache_clock;
+        return;
+    }
+
+    view_from(u.uy, u.ux, rows, rmin, rmax, 0,
+              (void FDECL((*), (int, int, genericptr_t))) 0,
+              (genericptr_t) 0);
+
+    vc = oldest;
+    (void) memset((genericptr_t) vc->bits, 0, sizeof vc->bits);
+    for (row = 0; row < ROWNO; row++) {
+        vc->rmin[row] = rmin[row];
+        vc->rmax[row] = rmax[row];
+        for (col = 0; col < COLNO; col++)
+            if (rows[row][col])
+                vc->bits[row][col >> 3] |= 1 << (col & 7);
+    }
+    vc->x = u.ux, vc->y = u.uy;
+    vc->used = ++vcache_clock;
+}
+
 /*
  * rogue_vision()
  *
@@ -468,9 +569,10 @@ int row, col;
  *        impacted by vision occur during the same move [make_blinded()]
  *
  * Control flag = 1.  An adjacent vision recalculation.  The hero has moved
- * one square.  Knowing this, it might be possible to optimize the vision
- * recalculation using the current knowledge.  This is presently unimplemented
- * and is treated as a control = 0 call.
+ * one square.  This is treated as a control = 0 call; either way the "could
+ * see" part is taken from the could-see cache (see hero_view()) if the hero
+ * has been at this spot recently and no location visible from it has become
+ * blocked or unblocked since.
  *
  *      + Right after the hero moves. [domove()]
  *
@@ -535,9 +637,7 @@ int control;
          *
          *      + Monsters can see you even when you're in a pit.
          */
-        view_from(u.uy, u.ux, next_array, next_rmin, next_rmax, 0,
-                  (void FDECL((*), (int, int, genericptr_t))) 0,
-                  (genericptr_t) 0);
+        hero_view(next_array, next_rmin, next_rmax);
 
         /*
          * Our own version of the update loop below.  We know we can't see
@@ -600,9 +700,7 @@ int control;
                     next_row[col] = IN_SIGHT | COULD_SEE;
             }
         } else
-            view_from(u.uy, u.ux, next_array, next_rmin, next_rmax, 0,
-                      (void FDECL((*), (int, int, genericptr_t))) 0,
-                      (genericptr_t) 0);
+            hero_view(next_array, next_rmin, next_rmax);
 
         /*
          * Set the IN_SIGHT bit for xray and night vision.
@@ -833,9 +931,11 @@ void
 block_point(x, y)
 int x, y;
 {
+    g.travel_gen++;
+    if (viz_clear[y][x])
+        vcache_dirty(x, y);
     fill_point(y, x);
-
-    /* recalc light sources here? */
+    clear_light_cache(x, y);
 
     /*
      * We have to do a full vision recalculation if we "could see" the
@@ -857,9 +957,11 @@ void
 unblock_point(x, y)
 int x, y;
 {
+    g.travel_gen++;
+    if (!viz_clear[y][x])
+        vcache_dirty(x, y);
     dig_point(y, x);
-
-    /* recalc light sources here? */
+    clear_light_cache(x, y);
 
     if (g.viz_array[y][x])
         g.vision_full_recalc = 1;
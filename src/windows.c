@@ -44,6 +44,12 @@ extern struct window_procs Gnome_procs;
 #ifdef MSWIN_GRAPHICS
 extern struct window_procs mswin_procs;
 #endif
+#ifdef NULL_GRAPHICS
+#include "winnull.h"
+#endif
+#ifdef RECORD_INPUT
+#include "func_tab.h"
+#endif
 #ifdef WINCHAIN
 extern struct window_procs chainin_procs;
 extern void FDECL(chainin_procs_init, (int));
@@ -74,6 +80,28 @@ static int FDECL(dump_select_menu, (winid, int, MENU_ITEM_P **));
 static void FDECL(dump_putstr, (winid, int, const char *));
 #endif /* DUMPLOG */
 
+#ifdef RECORD_INPUT
+static void NDECL(rec_event);
+static void FDECL(rec_key, (int));
+static void FDECL(rec_keys, (const char *));
+static void FDECL(rec_patch, (long, long));
+static void FDECL(rec_options, (long));
+static struct rec_menuitem *FDECL(rec_find, (winid, const ANY_P *));
+static void FDECL(rec_pick, (winid, int, struct rec_menuitem *, long));
+static int NDECL(rec_nhgetch);
+static int FDECL(rec_nh_poskey, (int *, int *, int *));
+static char FDECL(rec_yn_function, (const char *, const char *, CHAR_P));
+static void FDECL(rec_getlin, (const char *, char *));
+static int NDECL(rec_get_ext_cmd);
+static void FDECL(rec_destroy_nhwindow, (winid));
+static void FDECL(rec_start_menu, (winid));
+static void FDECL(rec_add_menu, (winid, int, const ANY_P *, CHAR_P, CHAR_P,
+                                 int, const char *, unsigned int));
+static void FDECL(rec_end_menu, (winid, const char *));
+static int FDECL(rec_select_menu, (winid, int, MENU_ITEM_P **));
+static char FDECL(rec_message_menu, (CHAR_P, int, const char *));
+#endif /* RECORD_INPUT */
+
 #ifdef HANGUPHANDLING
 volatile
 #endif
@@ -128,6 +156,9 @@ static struct win_choices {
 #ifdef MSWIN_GRAPHICS
     { &mswin_procs, 0 CHAINR(0) },
 #endif
+#ifdef NULL_GRAPHICS
+    { &null_procs, 0 CHAINR(0) },
+#endif
 #ifdef WINCHAIN
     { &chainin_procs, chainin_procs_init, chainin_procs_chain },
     { (struct window_procs *) &chainout_procs, chainout_procs_init,
@@ -197,6 +228,19 @@ genl_can_suspend_yes(VOID_ARGS)
     return TRUE;
 }
 
+/* for interfaces without a print_glyph_run() of their own:  one
+   print_glyph() for each spot in the span */
+void
+genl_print_glyph_run(window, x, y, count, glyphs, bkglyphs)
+winid window;
+xchar x, y;
+int count;
+const int *glyphs, *bkglyphs;
+{
+    for (; count > 0; --count, ++x)
+        print_glyph(window, x, y, *glyphs++, *bkglyphs++);
+}
+
 static
 void
 def_raw_print(s)
@@ -586,6 +630,7 @@ static struct window_procs hup_procs = {
     hup_void_ndecl,                                   /* status_finish */
     genl_status_enablefield, hup_status_update,
     genl_can_suspend_no,
+    genl_print_glyph_run,
 };
 
 static void FDECL((*previnterface_exit_nhwindows), (const char *)) = 0;
@@ -1388,6 +1433,537 @@ boolean onoff_flag;
     }
 }
 
+#ifdef RECORD_INPUT
+/*
+ * Input recording, so that real games can be replayed as benchmarks.
+ * If ${NH_RECORD} names a file when a new game begins, the game's seed,
+ * its (frozen) calendar, the options and the player's input are written
+ * there; sys/libnh/nhreplay.c plays the game again through the null
+ * window port.  What gets recorded is the answer that the interface gave
+ * the core--the key from nhgetch(), the line from getlin(), the items
+ * picked from a menu--expressed as the keystrokes which get the same
+ * answer from the null port.  Keys an interface uses for itself, such as
+ * dismissing --More-- or scrolling a menu, aren't part of that.
+ *
+ * The file is text apart from the keystrokes:
+ *      NHREC 1
+ *      seed <fixed_rngseed>
+ *      clock <fixed_gametime>
+ *      options <length>
+ *      <that many bytes of config file>
+ *      keys <count>
+ *      <that many keystrokes>
+ *      end <keystrokes before the last prompt> <state_hash() there>
+ *          <moves there> <lossy>
+ * 'lossy' counts answers which the null port can't be made to give (a
+ * mouse click, say); a replay of such a game isn't expected to match.
+ */
+
+#define REC_VERSION 1
+#define REC_MAXWIN 32
+
+struct rec_menuitem {
+    anything identifier;
+    char selector, gselector; /* as the null port will have them */
+    boolean selected;         /* preselected */
+};
+
+static struct recorder {
+    FILE *fp;
+    char fname[BUFSZ];
+    struct window_procs real; /* the interface being recorded */
+    int depth;                /* >0: inside one of its input routines */
+    long keyspos;             /* where the keystroke count goes */
+    long nkeys;
+    long lastevent;           /* nkeys when the latest prompt began */
+    unsigned long hash;       /* state_hash() at that prompt */
+    long moves;
+    long lossy;
+    struct rec_menu {
+        int nitems, maxitems;
+        struct rec_menuitem *items;
+    } menus[REC_MAXWIN];
+} rec;
+
+extern char configfile[]; /* files.c */
+extern unsigned long NDECL(sys_random_seed);
+
+/* called from early_init(); pin down whatever would otherwise differ
+   between two runs of the same game */
+void
+record_init()
+{
+    const char *fname = getenv("NH_RECORD");
+
+    if (!fname || !*fname || strlen(fname) >= sizeof rec.fname)
+        return;
+    Strcpy(rec.fname, fname);
+    if (!fixed_rngseed && !(fixed_rngseed = sys_random_seed()))
+        fixed_rngseed = 1L;
+    has_strong_rngseed = FALSE; /* no reseeding along the way */
+    if (!fixed_gametime)
+        fixed_gametime = getnow();
+}
+
+/* called from newgame() once the hero's role, race, &c are settled */
+void
+record_begin()
+{
+    if (!*rec.fname || rec.fp)
+        return;
+    if ((rec.fp = fopen(rec.fname, "wb")) == 0) {
+        raw_printf("Can't record input to \"%s\".", rec.fname);
+        return;
+    }
+    (void) fprintf(rec.fp, "NHREC %d\nseed %lu\nclock %ld\n", REC_VERSION,
+                   fixed_rngseed, (long) fixed_gametime);
+    rec_options(ftell(rec.fp));
+    rec.keyspos = ftell(rec.fp) + 5L;
+    (void) fprintf(rec.fp, "keys %12ld\n", 0L);
+    /* the game being recorded won't find bones which a replay wouldn't */
+    flags.bones = FALSE;
+
+    rec.real = windowprocs;
+    windowprocs.win_nhgetch = rec_nhgetch;
+    windowprocs.win_nh_poskey = rec_nh_poskey;
+    windowprocs.win_yn_function = rec_yn_function;
+    windowprocs.win_getlin = rec_getlin;
+    windowprocs.win_get_ext_cmd = rec_get_ext_cmd;
+    windowprocs.win_destroy_nhwindow = rec_destroy_nhwindow;
+    windowprocs.win_start_menu = rec_start_menu;
+    windowprocs.win_add_menu = rec_add_menu;
+    windowprocs.win_end_menu = rec_end_menu;
+    windowprocs.win_select_menu = rec_select_menu;
+    windowprocs.win_message_menu = rec_message_menu;
+}
+
+/* called from nh_terminate() */
+void
+record_finish()
+{
+    int i;
+
+    if (!rec.fp)
+        return;
+    rec_patch(rec.keyspos, rec.nkeys);
+    (void) fprintf(rec.fp, "\nend %ld %08lx %ld %ld\n", rec.lastevent,
+                   rec.hash, rec.moves, rec.lossy);
+    (void) fclose(rec.fp);
+    rec.fp = (FILE *) 0;
+    for (i = 0; i < REC_MAXWIN; ++i)
+        if (rec.menus[i].items) {
+            free((genericptr_t) rec.menus[i].items);
+            rec.menus[i].items = (struct rec_menuitem *) 0;
+            rec.menus[i].nitems = rec.menus[i].maxitems = 0;
+        }
+}
+
+/* the config file which was used, followed by NETHACKOPTIONS, the play
+   mode, and the outcome of player selection so that a replay needn't ask */
+static void
+rec_options(lenpos)
+long lenpos;
+{
+    const char *opts = getenv("NETHACKOPTIONS");
+    FILE *cf;
+    long start;
+    int c;
+
+    (void) fprintf(rec.fp, "options %12ld\n", 0L);
+    start = ftell(rec.fp);
+    if (*configfile && (cf = fopen(configfile, "r")) != 0) {
+        while ((c = getc(cf)) != EOF)
+            (void) putc(c, rec.fp);
+        (void) fclose(cf);
+        (void) putc('\n', rec.fp);
+    }
+    if (!opts)
+        opts = getenv("HACKOPTIONS");
+    if (opts && *opts && !index("/\\@", *opts))
+        (void) fprintf(rec.fp, "OPTIONS=%s\n", opts);
+    (void) fprintf(rec.fp, "OPTIONS=!bones,playmode:%s\n",
+                   wizard ? "debug" : discover ? "explore" : "normal");
+    (void) fprintf(rec.fp, "OPTIONS=role:%s,race:%s,gender:%s,align:%s\n",
+                   roles[flags.initrole].filecode,
+                   races[flags.initrace].filecode,
+                   genders[flags.initgend].filecode,
+                   aligns[flags.initalign].filecode);
+    rec_patch(lenpos + 8L, ftell(rec.fp) - start);
+}
+
+/* overwrite a placeholder count */
+static void
+rec_patch(pos, val)
+long pos, val;
+{
+    long here = ftell(rec.fp);
+
+    if (fseek(rec.fp, pos, SEEK_SET) == 0)
+        (void) fprintf(rec.fp, "%12ld", val);
+    (void) fseek(rec.fp, here, SEEK_SET);
+}
+
+/* the game is about to wait for input; a replay will stop at the last
+   of these and compare notes */
+static void
+rec_event()
+{
+    rec.lastevent = rec.nkeys;
+    rec.hash = state_hash();
+    rec.moves = g.moves;
+}
+
+static void
+rec_key(c)
+int c;
+{
+    if (!rec.fp)
+        return;
+    if (c < 0 || c > 255) {
+        rec.lossy++;
+        return;
+    }
+    (void) putc(c, rec.fp);
+    rec.nkeys++;
+}
+
+static void
+rec_keys(s)
+const char *s;
+{
+    while (*s)
+        rec_key((uchar) *s++);
+}
+
+/* the null port's copy of an item in menu 'win' */
+static struct rec_menuitem *
+rec_find(win, identifier)
+winid win;
+const anything *identifier;
+{
+    struct rec_menu *m = &rec.menus[win];
+    int i;
+
+    for (i = 0; i < m->nitems; ++i)
+        if (m->items[i].identifier.a_void
+            && !memcmp((genericptr_t) &m->items[i].identifier,
+                       (genericptr_t) identifier, sizeof (anything)))
+            return &m->items[i];
+    return (struct rec_menuitem *) 0;
+}
+
+/* keystrokes which select 'it', with 'count' if that's positive */
+static void
+rec_pick(win, how, it, count)
+winid win;
+int how;
+struct rec_menuitem *it;
+long count;
+{
+    struct rec_menu *m = &rec.menus[win];
+    char buf[BUFSZ];
+    int i, matches = 0;
+
+    if (!it || !it->selector) {
+        rec.lossy++;
+        if (how == PICK_ONE)
+            rec_key('\033');
+        return;
+    }
+    for (i = 0; i < m->nitems; ++i)
+        if (m->items[i].identifier.a_void
+            && (m->items[i].selector == it->selector
+                || (how == PICK_ANY && m->items[i].gselector == it->selector)))
+            matches++;
+    if (matches > 1)
+        rec.lossy++;
+    if (count > 0L) {
+        Sprintf(buf, "%ld", count);
+        rec_keys(buf);
+    }
+    rec_key(it->selector);
+}
+
+static int
+rec_nhgetch()
+{
+    boolean outer = (rec.fp && !rec.depth);
+    int c;
+
+    if (outer)
+        rec_event();
+    rec.depth++;
+    c = (*rec.real.win_nhgetch)();
+    rec.depth--;
+    if (outer)
+        rec_key(c);
+    return c;
+}
+
+static int
+rec_nh_poskey(x, y, mod)
+int *x, *y, *mod;
+{
+    boolean outer = (rec.fp && !rec.depth);
+    int c;
+
+    if (outer)
+        rec_event();
+    rec.depth++;
+    c = (*rec.real.win_nh_poskey)(x, y, mod);
+    rec.depth--;
+    if (outer) {
+        if (!c)
+            rec.lossy++; /* mouse click */
+        else
+            rec_key(c);
+    }
+    return c;
+}
+
+static char
+rec_yn_function(query, resp, def)
+const char *query, *resp;
+char def;
+{
+    boolean outer = (rec.fp && !rec.depth);
+    char q;
+
+    if (outer)
+        rec_event();
+    rec.depth++;
+    q = (*rec.real.win_yn_function)(query, resp, def);
+    rec.depth--;
+    if (!outer)
+        return q;
+
+    /* the null port lowercases, turns quitchars into 'def', and turns
+       ESC into 'q' or 'n' if those are allowed */
+    if (!resp || (q && index(resp, q) && q == lowc(q)
+                  && !index(quitchars, q))) {
+        rec_key(q);
+        if (q == '#' && resp)
+            rec.lossy++; /* count typed after it isn't supported */
+    } else if (q == def) {
+        rec_key(' ');
+    } else if (q == (index(resp, 'q') ? 'q' : index(resp, 'n') ? 'n' : def)) {
+        rec_key('\033');
+    } else {
+        rec.lossy++;
+        rec_key('\033');
+    }
+    return q;
+}
+
+static void
+rec_getlin(query, bufp)
+const char *query;
+char *bufp;
+{
+    boolean outer = (rec.fp && !rec.depth);
+
+    if (outer)
+        rec_event();
+    rec.depth++;
+    (*rec.real.win_getlin)(query, bufp);
+    rec.depth--;
+    if (outer) {
+        if (*bufp == '\033') {
+            rec_key('\033');
+        } else {
+            rec_keys(bufp);
+            rec_key('\n');
+        }
+    }
+}
+
+static int
+rec_get_ext_cmd()
+{
+    boolean outer = (rec.fp && !rec.depth);
+    int idx;
+
+    if (outer)
+        rec_event();
+    rec.depth++;
+    idx = (*rec.real.win_get_ext_cmd)();
+    rec.depth--;
+    if (outer) {
+        if (idx >= 0) {
+            rec_keys(extcmdlist[idx].ef_txt);
+            rec_key('\n');
+        } else {
+            rec_key('\033');
+        }
+    }
+    return idx;
+}
+
+static void
+rec_destroy_nhwindow(win)
+winid win;
+{
+    (*rec.real.win_destroy_nhwindow)(win);
+    if (win >= 0 && win < REC_MAXWIN)
+        rec.menus[win].nitems = 0;
+}
+
+static void
+rec_start_menu(win)
+winid win;
+{
+    (*rec.real.win_start_menu)(win);
+    if (win >= 0 && win < REC_MAXWIN)
+        rec.menus[win].nitems = 0;
+}
+
+static void
+rec_add_menu(win, glyph, identifier, ch, gch, attr, str, itemflags)
+winid win;
+int glyph;
+const anything *identifier;
+char ch, gch;
+int attr;
+const char *str;
+unsigned int itemflags;
+{
+    struct rec_menu *m;
+    struct rec_menuitem *it;
+
+    (*rec.real.win_add_menu)(win, glyph, identifier, ch, gch, attr, str,
+                             itemflags);
+    if (win < 0 || win >= REC_MAXWIN)
+        return;
+    m = &rec.menus[win];
+    if (m->nitems == m->maxitems) {
+        struct rec_menuitem *olditems = m->items;
+
+        m->maxitems = m->maxitems ? 2 * m->maxitems : 32;
+        m->items = (struct rec_menuitem *) alloc((unsigned) m->maxitems
+                                                 * sizeof *m->items);
+        if (olditems) {
+            (void) memcpy((genericptr_t) m->items, (genericptr_t) olditems,
+                          m->nitems * sizeof *m->items);
+            free((genericptr_t) olditems);
+        }
+    }
+    it = &m->items[m->nitems++];
+    it->identifier = *identifier;
+    it->selector = ch;
+    it->gselector = gch;
+    it->selected = (itemflags & MENU_ITEMFLAGS_SELECTED) != 0;
+}
+
+/* hand out accelerators the same way null_end_menu() does */
+static void
+rec_end_menu(win, prompt)
+winid win;
+const char *prompt;
+{
+    struct rec_menu *m;
+    char nextch = 'a';
+    int i;
+
+    (*rec.real.win_end_menu)(win, prompt);
+    if (win < 0 || win >= REC_MAXWIN)
+        return;
+    m = &rec.menus[win];
+    for (i = 0; i < m->nitems; ++i) {
+        if (!m->items[i].identifier.a_void || m->items[i].selector
+            || !nextch)
+            continue;
+        m->items[i].selector = nextch;
+        nextch = (nextch == 'z') ? 'A' : (nextch == 'Z') ? '\0' : nextch + 1;
+    }
+}
+
+static int
+rec_select_menu(win, how, menu_list)
+winid win;
+int how;
+menu_item **menu_list;
+{
+    boolean outer = (rec.fp && !rec.depth && how != PICK_NONE);
+    struct rec_menu *m;
+    struct rec_menuitem *it;
+    long count = -1L;
+    int i, j, n;
+
+    if (outer)
+        rec_event();
+    rec.depth++;
+    n = (*rec.real.win_select_menu)(win, how, menu_list);
+    rec.depth--;
+    if (!outer)
+        return n;
+    if (n < 0 || win < 0 || win >= REC_MAXWIN) {
+        if (n >= 0)
+            rec.lossy++;
+        rec_key('\033');
+        return n;
+    }
+    m = &rec.menus[win];
+
+    if (how == PICK_ONE) {
+        if (!n) {
+            /* ending the menu would pick a preselected item */
+            for (i = 0; i < m->nitems; ++i)
+                if (m->items[i].selected && m->items[i].identifier.a_void)
+                    rec.lossy++;
+            rec_key('\n');
+            return n;
+        }
+        /* a preselected item comes back along with the one chosen */
+        for (it = 0, i = 0; i < n; ++i) {
+            it = rec_find(win, &(*menu_list)[i].item);
+            count = (*menu_list)[i].count;
+            if (!it || !it->selected)
+                break;
+        }
+        rec_pick(win, how, it, count);
+        return n;
+    }
+
+    for (j = 0; j < n; ++j)
+        if (!rec_find(win, &(*menu_list)[j].item))
+            rec.lossy++;
+    for (i = 0; i < m->nitems; ++i) {
+        it = &m->items[i];
+        if (!it->identifier.a_void)
+            continue;
+        for (j = 0; j < n; ++j)
+            if (!memcmp((genericptr_t) &(*menu_list)[j].item,
+                        (genericptr_t) &it->identifier, sizeof (anything)))
+                break;
+        if (j < n && (*menu_list)[j].count > 0L)
+            rec_pick(win, how, it, (*menu_list)[j].count);
+        else if ((j < n) != it->selected)
+            rec_pick(win, how, it, -1L); /* toggle */
+    }
+    rec_key('\n');
+    return n;
+}
+
+/* a one-item "menu" shown as a message; tty lets the item be picked at
+   its --More--, but the null port leaves the core to ask for it next */
+static char
+rec_message_menu(let, how, mesg)
+char let;
+int how;
+const char *mesg;
+{
+    boolean outer = (rec.fp && !rec.depth);
+    char c;
+
+    rec.depth++;
+    c = (*rec.real.win_message_menu)(let, how, mesg);
+    rec.depth--;
+    if (outer && how == PICK_ONE && c)
+        rec_key(c);
+    return c;
+}
+#endif /* RECORD_INPUT */
+
 #ifdef TTY_GRAPHICS
 #ifdef TEXTCOLOR
 #ifdef TOS
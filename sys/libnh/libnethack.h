@@ -0,0 +1,96 @@
+/* NetHack 3.7	libnethack.h	$NHDT-Date$  $NHDT-Branch$:$NHDT-Revision$ */
+/* Copyright (c) NetHack Development Team 2020.                   */
+/* NetHack may be freely redistributed.  See license for details. */
+
+/*
+ * Interface for programs which run NetHack as a library rather than as
+ * an interactive program; built from sys/libnh/libnhmain.c along with
+ * the "null" window port.  Self-contained so that it can be included
+ * without any of the game's own headers.
+ *
+ *      if (nh_init(seed, "name:Agent,role:val") == 0)
+ *          while (nh_step("l", 1)) {
+ *              nh_observe(&obs);
+ *              ...
+ *          }
+ *      nh_close();
+ *
+ * Only one game can be in progress at a time, but a program which wants
+ * to try several moves from one position can use nh_snapshot() and then
+ * nh_restore() before each attempt.
+ */
+
+#ifndef LIBNETHACK_H
+#define LIBNETHACK_H
+
+#define NH_ROWS 21          /* ROWNO */
+#define NH_COLS 80          /* COLNO */
+#define NH_STATUS_FIELDS 23 /* MAXBLSTATS; indexed by BL_TITLE .. BL_CONDITION */
+#define NH_TEXTLEN 256      /* BUFSZ */
+#define NH_MAXMSGS 100      /* messages kept between observations */
+#define NH_PROMPTLEN 4096   /* text of a pending question or menu */
+
+struct nh_observation {
+    int glyphs[NH_ROWS][NH_COLS]; /* what the map shows; column 0 unused */
+    char chars[NH_ROWS][NH_COLS]; /* those glyphs as text symbols */
+    long status[NH_STATUS_FIELDS]; /* numeric value of each status field */
+    char status_text[NH_STATUS_FIELDS][NH_TEXTLEN]; /* formatted value */
+    int nmessages;                /* messages issued by the last nh_step() */
+    char messages[NH_MAXMSGS][NH_TEXTLEN];
+    char prompt[NH_PROMPTLEN];    /* empty unless answering a question */
+    int ux, uy;                   /* hero's location */
+    long moves;                   /* game turn */
+    int in_progress;              /* 0 once the game has ended */
+    int exit_status;              /* valid when !in_progress */
+};
+
+/* Start a new game, with the random number generator seeded by 'seed'
+   (0 for an unpredictable seed) and the run-time options from 'options'
+   (same syntax as the NETHACKOPTIONS environment variable; may be null).
+   Returns 0 when the game is waiting for its first command, -1 if it
+   couldn't be started or has already ended. */
+extern int nh_init(unsigned long seed, const char *options);
+
+/* Feed 'nkeys' keystrokes to the game and let it run until it wants
+   more.  Returns 1 while the game is still in progress, 0 after it
+   has ended. */
+extern int nh_step(const char *keys, int nkeys);
+
+/* Describe the current state of the game. */
+extern void nh_observe(struct nh_observation *obs);
+
+/* Copy the complete state of the game into a newly allocated buffer
+   and set *len to its size; release it with nh_snapshot_free().  Only
+   possible while the game is waiting for a command, with no keystrokes
+   left over from nh_step().  Returns null if it can't be done. */
+extern void *nh_snapshot(long *len);
+extern void nh_snapshot_free(void *buf);
+
+/* Replace the game in progress with one saved by nh_snapshot(), which
+   then carries on exactly as it would have from that point, random
+   numbers included.  The same conditions apply as for nh_snapshot(),
+   and the snapshot must have been taken by this process.  It can be
+   restored any number of times.  Returns 0 on success, -1 if it was
+   refused or the game ended while it was being restored. */
+extern int nh_restore(const void *buf, long len);
+
+/* Abandon the game in progress, if any, and release its resources.
+   It's treated as a hangup, so the game is saved unless NOSAVEONHANGUP
+   was configured. */
+extern void nh_close(void);
+
+/* Like nh_close(), but the game in progress is thrown away unsaved. */
+extern void nh_discard(void);
+
+/* Make the game's calendar (phase of the moon, Friday the 13th, night
+   time, the hero's birthday) stay at 'when', in time() units, instead
+   of following the clock; 0 lets it follow the clock again.  Takes
+   effect for games started after it's called. */
+extern void nh_fixtime(long when);
+
+/* A summary of the game's state--the hero, inventory, current level, and
+   position in the random number sequence--for telling whether two runs
+   of a game stayed in step.  0 if no game is in progress. */
+extern unsigned long nh_statehash(void);
+
+#endif /* LIBNETHACK_H */
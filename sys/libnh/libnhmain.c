@@ -0,0 +1,290 @@
+/* NetHack 3.7	libnhmain.c	$NHDT-Date$  $NHDT-Branch$:$NHDT-Revision$ */
+/* Copyright (c) NetHack Development Team 2020.                   */
+/* NetHack may be freely redistributed.  See license for details. */
+
+/*
+ * Library front end:  run the game in-process for a program which feeds
+ * it keystrokes and inspects the result (see libnethack.h).
+ *
+ * The game expects to own the main loop, so it runs as a coroutine on
+ * a stack of its own.  The Unix main(), compiled as nhmain() when LIBNH
+ * is defined, is started by nh_init(); whenever the null window port
+ * runs out of keystrokes it switches back to the caller, and nh_step()
+ * switches into the game again after queueing more.  When the game
+ * exits, nethack_exit() switches back for the last time.
+ *
+ * Snapshots are taken and restored on the game's stack too, so that a
+ * panic along the way ends the game the same as it would anywhere else:
+ * nh_snapshot() and nh_restore() leave a request and switch into the
+ * game, which is waiting for a keystroke in libnh_wait().
+ */
+
+#include "hack.h"
+#include "winnull.h"
+#include "libnethack.h"
+
+#include <ucontext.h>
+
+#ifndef LIBNH_STACKSIZE
+#define LIBNH_STACKSIZE (8L * 1024L * 1024L)
+#endif
+
+/* cause a compile error if the public limits fall out of step */
+typedef char libnh_rowno_check[(NH_ROWS == ROWNO) ? 1 : -1];
+typedef char libnh_colno_check[(NH_COLS == COLNO) ? 1 : -1];
+typedef char libnh_blstats_check[(NH_STATUS_FIELDS == MAXBLSTATS) ? 1 : -1];
+typedef char libnh_textlen_check[(NH_TEXTLEN == BUFSZ) ? 1 : -1];
+
+extern int FDECL(nhmain, (int, char **));
+void FDECL(nethack_exit, (int)) NORETURN;
+
+static void NDECL(libnh_game);
+static int NDECL(libnh_wait);
+static void NDECL(libnh_release);
+static boolean NDECL(libnh_ready);
+
+enum libnh_requests { LIBNH_NOREQUEST = 0, LIBNH_SNAPSHOT, LIBNH_RESTORE };
+
+enum libnh_states { LIBNH_IDLE = 0, LIBNH_RUNNING, LIBNH_ENDED };
+
+static struct libnh {
+    ucontext_t host, game;
+    genericptr_t stack;
+    enum libnh_states state;
+    boolean closing;
+    int exit_status;
+    long msgmark; /* null_msgcount() when the latest nh_step() began */
+    enum libnh_requests request;
+    genericptr_t snapdata; /* snapshot being taken or restored */
+    long snaplen;
+    boolean snapok;
+} libnh;
+
+static char *libnh_argv[] = { (char *) "nethack", (char *) 0 };
+
+/* body of the game's coroutine */
+static void
+libnh_game()
+{
+    (void) nhmain(1, libnh_argv);
+    nethack_exit(EXIT_SUCCESS);
+}
+
+/* null port has no keystrokes left; let the caller supply more */
+static int
+libnh_wait()
+{
+    while (!libnh.closing) {
+        (void) swapcontext(&libnh.game, &libnh.host);
+        if (libnh.request == LIBNH_SNAPSHOT) {
+            libnh.snapdata = snapshot_game(&libnh.snaplen);
+        } else if (libnh.request == LIBNH_RESTORE) {
+            libnh.snapok = restore_snapshot(libnh.snapdata, libnh.snaplen);
+        } else {
+            break;
+        }
+        libnh.request = LIBNH_NOREQUEST;
+    }
+    return !libnh.closing;
+}
+
+/* the game is waiting in libnh_wait() for its next command */
+static boolean
+libnh_ready()
+{
+    return (libnh.state == LIBNH_RUNNING && iflags.in_parse
+            && !null_pendingkeys());
+}
+
+/* replaces exit() for the core; called on the game's stack */
+void
+nethack_exit(status)
+int status;
+{
+    libnh.exit_status = status;
+    libnh.state = LIBNH_ENDED;
+    (void) swapcontext(&libnh.game, &libnh.host);
+    /* a finished game is never resumed */
+    abort();
+}
+
+static void
+libnh_release()
+{
+    if (libnh.stack)
+        free(libnh.stack), libnh.stack = (genericptr_t) 0;
+    libnh.state = LIBNH_IDLE;
+}
+
+int
+nh_init(seed, options)
+unsigned long seed;
+const char *options;
+{
+    if (libnh.state == LIBNH_RUNNING)
+        return -1;
+    libnh_release();
+
+    fixed_rngseed = seed;
+    has_strong_rngseed = FALSE;
+    if (options)
+        (void) setenv("NETHACKOPTIONS", options, 1);
+    null_input_wait = libnh_wait;
+
+    libnh.stack = malloc(LIBNH_STACKSIZE);
+    if (!libnh.stack || getcontext(&libnh.game) != 0) {
+        libnh_release();
+        return -1;
+    }
+    libnh.game.uc_stack.ss_sp = libnh.stack;
+    libnh.game.uc_stack.ss_size = LIBNH_STACKSIZE;
+    libnh.game.uc_link = &libnh.host;
+    makecontext(&libnh.game, libnh_game, 0);
+
+    libnh.closing = FALSE;
+    libnh.exit_status = 0;
+    libnh.msgmark = 0L;
+    libnh.state = LIBNH_RUNNING;
+    (void) swapcontext(&libnh.host, &libnh.game);
+    return (libnh.state == LIBNH_RUNNING) ? 0 : -1;
+}
+
+int
+nh_step(keys, nkeys)
+const char *keys;
+int nkeys;
+{
+    if (libnh.state != LIBNH_RUNNING)
+        return 0;
+    libnh.msgmark = null_msgcount();
+    if (keys && nkeys > 0)
+        null_pushkeys(keys, nkeys);
+    (void) swapcontext(&libnh.host, &libnh.game);
+    return (libnh.state == LIBNH_RUNNING);
+}
+
+void
+nh_observe(obs)
+struct nh_observation *obs;
+{
+    struct istat_s *bl;
+    const char *msg;
+    long m;
+    int x, y, i, ch, color;
+    unsigned special;
+
+    (void) memset((genericptr_t) obs, 0, sizeof *obs);
+    for (y = 0; y < ROWNO; y++)
+        for (x = 0; x < COLNO; x++) {
+            obs->glyphs[y][x] = g.gbuf[y][x].glyph;
+            (void) mapglyph(g.gbuf[y][x].glyph, &ch, &color, &special,
+                            x, y, 0);
+            obs->chars[y][x] = (char) ch;
+        }
+
+    for (i = 0; i < MAXBLSTATS; i++) {
+        bl = &g.blstats[g.now_or_before_idx][i];
+        switch (bl->anytype) {
+        case ANY_INT:
+            obs->status[i] = (long) bl->a.a_int;
+            break;
+        case ANY_LONG:
+            obs->status[i] = bl->a.a_long;
+            break;
+        case ANY_ULONG:
+        case ANY_MASK32:
+            obs->status[i] = (long) bl->a.a_ulong;
+            break;
+        default:
+            break;
+        }
+        if (bl->val)
+            (void) strncpy(obs->status_text[i], bl->val, NH_TEXTLEN - 1);
+    }
+
+    for (m = libnh.msgmark; m < null_msgcount(); m++)
+        if ((msg = null_getmsg(m)) != 0 && obs->nmessages < NH_MAXMSGS)
+            (void) strncpy(obs->messages[obs->nmessages++], msg,
+                           NH_TEXTLEN - 1);
+    (void) strncpy(obs->prompt, null_prompt(), NH_PROMPTLEN - 1);
+
+    obs->ux = u.ux, obs->uy = u.uy;
+    obs->moves = g.moves;
+    obs->in_progress = (libnh.state == LIBNH_RUNNING);
+    obs->exit_status = libnh.exit_status;
+}
+
+void *
+nh_snapshot(len)
+long *len;
+{
+    *len = 0L;
+    if (!libnh_ready())
+        return (void *) 0;
+    libnh.snapdata = (genericptr_t) 0;
+    libnh.request = LIBNH_SNAPSHOT;
+    (void) swapcontext(&libnh.host, &libnh.game);
+    if (libnh.state != LIBNH_RUNNING)
+        return (void *) 0;
+    *len = libnh.snaplen;
+    return (void *) libnh.snapdata;
+}
+
+void
+nh_snapshot_free(buf)
+void *buf;
+{
+    if (buf)
+        free((genericptr_t) buf);
+}
+
+int
+nh_restore(buf, len)
+const void *buf;
+long len;
+{
+    if (!buf || !libnh_ready())
+        return -1;
+    libnh.snapdata = (genericptr_t) buf;
+    libnh.snaplen = len;
+    libnh.snapok = FALSE;
+    libnh.request = LIBNH_RESTORE;
+    (void) swapcontext(&libnh.host, &libnh.game);
+    libnh.snapdata = (genericptr_t) 0;
+    /* messages issued while restoring aren't the caller's concern */
+    libnh.msgmark = null_msgcount();
+    return (libnh.state == LIBNH_RUNNING && libnh.snapok) ? 0 : -1;
+}
+
+void
+nh_close()
+{
+    if (libnh.state == LIBNH_RUNNING) {
+        libnh.closing = TRUE;
+        (void) swapcontext(&libnh.host, &libnh.game);
+    }
+    libnh_release();
+}
+
+void
+nh_discard()
+{
+    if (libnh.state == LIBNH_RUNNING)
+        g.program_state.something_worth_saving = 0;
+    nh_close();
+}
+
+void
+nh_fixtime(when)
+long when;
+{
+    fixed_gametime = (time_t) when;
+}
+
+unsigned long
+nh_statehash()
+{
+    return (libnh.state == LIBNH_RUNNING) ? state_hash() : 0L;
+}
+
+/*libnhmain.c*/
@@ -0,0 +1,235 @@
+/* NetHack 3.7	nhreplay.c	$NHDT-Date$  $NHDT-Branch$:$NHDT-Revision$ */
+/* Copyright (c) NetHack Development Team 2020.                   */
+/* NetHack may be freely redistributed.  See license for details. */
+
+/*
+ * Play back a game recorded by a RECORD_INPUT build (see the description
+ * of input recording in src/windows.c) as fast as the library can go,
+ * and report how fast that was:
+ *
+ *      nhreplay [-n name] [-q] recording
+ *
+ * The game gets the seed, calendar, and options that it was recorded
+ * with, but the hero is named "nhreplay" (or 'name') so that the real
+ * player's save and lock files are left alone, and the game is thrown
+ * away unsaved once the recording runs out.  The null window port
+ * doesn't pause for delay_output() or draw anything, so the time taken
+ * is nearly all the game's own.  At the end of the recording, the
+ * game's state is compared with what was recorded there.
+ *
+ * Exit status is 0 if the replay ended up where the original game did,
+ * 1 if it didn't, and 2 if the recording couldn't be replayed at all.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "libnethack.h"
+
+#define RP_VERSION 1
+#define RP_CHUNK 4096 /* no more than the null port's keystroke queue */
+
+struct recording {
+    unsigned long seed;
+    long clock;
+    char *options;
+    long optlen;
+    char *keys;
+    long nkeys;
+    long lastevent; /* keystrokes before the final prompt */
+    unsigned long hash; /* state there */
+    long moves;
+    long lossy;
+};
+
+static int read_recording(const char *, struct recording *);
+static char *read_block(FILE *, const char *, long *);
+static int write_options(const struct recording *, const char *, char *);
+static double elapsed(const struct timespec *);
+static void usage(void);
+
+static struct nh_observation obs;
+
+int
+main(int argc, char **argv)
+{
+    struct recording rec;
+    struct timespec start;
+    char optfile[64], optarg_buf[80];
+    const char *name = "nhreplay";
+    unsigned long hash;
+    long fed, n;
+    double secs;
+    int quiet = 0, status, c;
+
+    while ((c = getopt(argc, argv, "n:q")) != -1) {
+        switch (c) {
+        case 'n':
+            name = optarg;
+            break;
+        case 'q':
+            quiet = 1;
+            break;
+        default:
+            usage();
+            return 2;
+        }
+    }
+    if (optind != argc - 1) {
+        usage();
+        return 2;
+    }
+    if (!read_recording(argv[optind], &rec))
+        return 2;
+    if (!write_options(&rec, name, optfile))
+        return 2;
+    /* a RECORD_INPUT library mustn't record the replay over itself */
+    (void) unsetenv("NH_RECORD");
+
+    (void) snprintf(optarg_buf, sizeof optarg_buf, "@%s", optfile);
+    nh_fixtime(rec.clock);
+    if (nh_init(rec.seed, optarg_buf) != 0) {
+        fprintf(stderr, "nhreplay: the game didn't start.\n");
+        (void) unlink(optfile);
+        return 2;
+    }
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &start);
+    for (fed = 0L; fed < rec.lastevent; fed += n) {
+        n = rec.lastevent - fed;
+        if (n > RP_CHUNK)
+            n = RP_CHUNK;
+        if (!nh_step(rec.keys + fed, (int) n))
+            break;
+    }
+    secs = elapsed(&start);
+
+    nh_observe(&obs);
+    hash = nh_statehash();
+    status = (fed >= rec.lastevent && obs.in_progress && hash == rec.hash
+              && obs.moves == rec.moves) ? 0 : 1;
+    nh_discard();
+    (void) unlink(optfile);
+
+    if (!quiet) {
+        printf("%s: %ld keystrokes, %ld turns in %.3f s",
+               argv[optind], fed, obs.moves, secs);
+        if (secs > 0.0)
+            printf(": %.1f turns/s, %.1f keystrokes/s",
+                   (double) obs.moves / secs, (double) fed / secs);
+        printf("\n");
+    }
+    if (status) {
+        if (fed < rec.lastevent || !obs.in_progress)
+            printf("%s: game ended after %ld of %ld keystrokes.\n",
+                   argv[optind], fed, rec.lastevent);
+        else
+            printf("%s: state differs: %08lx on turn %ld, recorded %08lx"
+                   " on turn %ld.\n", argv[optind], hash, obs.moves,
+                   rec.hash, rec.moves);
+        if (rec.lossy)
+            printf("%s: %ld answers couldn't be recorded exactly.\n",
+                   argv[optind], rec.lossy);
+    } else if (!quiet) {
+        printf("%s: state matches (%08lx).\n", argv[optind], hash);
+    }
+    free(rec.options);
+    free(rec.keys);
+    return status;
+}
+
+static int
+read_recording(const char *fname, struct recording *rec)
+{
+    FILE *fp;
+    int version = 0;
+
+    memset(rec, 0, sizeof *rec);
+    if ((fp = fopen(fname, "rb")) == 0) {
+        perror(fname);
+        return 0;
+    }
+    if (fscanf(fp, "NHREC %d", &version) != 1 || version != RP_VERSION
+        || fscanf(fp, " seed %lu", &rec->seed) != 1
+        || fscanf(fp, " clock %ld", &rec->clock) != 1
+        || (rec->options = read_block(fp, " options %ld", &rec->optlen)) == 0
+        || (rec->keys = read_block(fp, " keys %ld", &rec->nkeys)) == 0
+        || fscanf(fp, " end %ld %lx %ld %ld", &rec->lastevent, &rec->hash,
+                  &rec->moves, &rec->lossy) != 4
+        || rec->lastevent < 0L || rec->lastevent > rec->nkeys) {
+        fprintf(stderr, "%s: not a complete recording.\n", fname);
+        (void) fclose(fp);
+        free(rec->options);
+        free(rec->keys);
+        return 0;
+    }
+    (void) fclose(fp);
+    return 1;
+}
+
+/* a count, a newline, and that many bytes */
+static char *
+read_block(FILE *fp, const char *fmt, long *lenp)
+{
+    char *buf;
+
+    if (fscanf(fp, fmt, lenp) != 1 || *lenp < 0L || getc(fp) != '\n'
+        || (buf = malloc((size_t) *lenp + 1)) == 0)
+        return (char *) 0;
+    if (fread(buf, 1, (size_t) *lenp, fp) != (size_t) *lenp) {
+        free(buf);
+        return (char *) 0;
+    }
+    buf[*lenp] = '\0';
+    return buf;
+}
+
+/* the recorded options, with the replay's own name for the hero last
+   so that it takes precedence; 'fname' gets the temporary file's name */
+static int
+write_options(const struct recording *rec, const char *name, char *fname)
+{
+    FILE *fp;
+    int fd;
+
+    (void) strcpy(fname, "/tmp/nhreplayXXXXXX");
+    if ((fd = mkstemp(fname)) < 0 || (fp = fdopen(fd, "w")) == 0) {
+        perror("nhreplay: options file");
+        if (fd >= 0) {
+            (void) close(fd);
+            (void) unlink(fname);
+        }
+        return 0;
+    }
+    (void) fwrite(rec->options, 1, (size_t) rec->optlen, fp);
+    fprintf(fp, "\nOPTIONS=name:%s\n", name);
+    if (fclose(fp) != 0) {
+        perror(fname);
+        (void) unlink(fname);
+        return 0;
+    }
+    return 1;
+}
+
+static double
+elapsed(const struct timespec *start)
+{
+    struct timespec now;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) (now.tv_sec - start->tv_sec)
+           + (double) (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void
+usage(void)
+{
+    fprintf(stderr, "usage: nhreplay [-n name] [-q] recording\n");
+}
+
+/*nhreplay.c*/
@@ -45,6 +45,11 @@ static void NDECL(wd_message);
 static boolean wiz_error_flag = FALSE;
 static struct passwd *NDECL(get_unix_pw);
 
+#ifdef LIBNH
+/* started by nh_init() in sys/libnh/libnhmain.c */
+#define main nhmain
+#endif
+
 int
 main(argc, argv)
 int argc;
@@ -252,9 +257,11 @@ char *argv[];
         /* use character name rather than lock letter for file names */
         g.locknum = 0;
     } else {
+#ifndef NO_SIGNAL
         /* suppress interrupts while processing lock file */
         (void) signal(SIGQUIT, SIG_IGN);
         (void) signal(SIGINT, SIG_IGN);
+#endif
     }
 
     dlb_init(); /* must be before newgame() */
@@ -63,6 +63,110 @@ function test_level_init()
    des.level_init({ style = "solidfill", fg = ".", lit = 1 });
 end
 
+-- the mines-style cave generator only ever leaves fg and bg terrain
+-- (plus walls when walled); a build with EXTRA_SANITY_CHECKS also has
+-- it compare each smoothing pass against a spot-by-spot version
+function test_mines_cave()
+   local styles = {
+      { fg = ".", bg = " " },
+      { fg = ".", bg = " ", smoothed = true },
+      { fg = ".", bg = "}", joined = true },
+      { fg = ".", bg = "L", smoothed = true, joined = true, lit = 0 },
+      { fg = ".", bg = " ", smoothed = true, joined = true, walled = true },
+   };
+
+   for i = 1, 10 do
+      for _, style in ipairs(styles) do
+         local init = { style = "mines" };
+         for k, v in pairs(style) do
+            init[k] = v;
+         end
+         des.reset_level();
+         des.level_init(init);
+         for x = 1, nhc.COLNO - 1 do
+            for y = 0, nhc.ROWNO - 1 do
+               local ch = nh.getmap(x, y).mapchr;
+               if ch ~= style.fg and ch ~= style.bg
+                  and not (style.walled and (ch == "-" or ch == "|")) then
+                  error("Mines cave has \"" .. ch .. "\" at (" .. x .. "," .. y .. ")");
+               end
+            end
+         end
+      end
+   end
+end
+
+-- an irregular region gets exactly the floor spots reachable from where
+-- it starts, counting diagonals, and the walls next to those
+function test_flood_fill()
+   local mx, my = 10, 3;
+   des.reset_level();
+   des.level_init({ style = "solidfill", fg = " " });
+   des.map({ x = mx, y = my, map = [[
+------------ ---
+|..|.....|.| |.|
+|.|..|.|.|.| |.|
+|...|..|..-| ---
+--.-|.|....|    
+|...|..|-|.|    
+------------    ]] });
+   des.region({ region = { 5,1, 5,1 }, lit = 0, irregular = true,
+                prefilled = true, joined = false });
+
+   local w, h = 16, 7;
+   local rmno = nh.getmap(mx + 5, my + 1).roomno;
+   if rmno < 3 then
+      error("Flood fill start has room number " .. rmno);
+   end
+
+   -- the same fill, a spot at a time
+   local inroom = { };
+   local todo = { { 5, 1 } };
+   inroom[5 + 1 * w] = true;
+   while #todo > 0 do
+      local x, y = todo[#todo][1], todo[#todo][2];
+      todo[#todo] = nil;
+      for dx = -1, 1 do
+         for dy = -1, 1 do
+            local nx, ny = x + dx, y + dy;
+            if nx >= 0 and nx < w and ny >= 0 and ny < h
+               and not inroom[nx + ny * w]
+               and nh.getmap(mx + nx, my + ny).mapchr == "." then
+               inroom[nx + ny * w] = true;
+               todo[#todo + 1] = { nx, ny };
+            end
+         end
+      end
+   end
+
+   for x = 0, w - 1 do
+      for y = 0, h - 1 do
+         local loc = nh.getmap(mx + x, my + y);
+         if loc.mapchr == "." then
+            if (loc.roomno == rmno) ~= (inroom[x + y * w] == true) then
+               error("Flood fill got (" .. x .. "," .. y .. ") wrong");
+            end
+         elseif loc.mapchr == "-" or loc.mapchr == "|" then
+            local nextto = false;
+            for dx = -1, 1 do
+               for dy = -1, 1 do
+                  if x + dx >= 0 and x + dx < w
+                     and inroom[x + dx + (y + dy) * w] then
+                     nextto = true;
+                  end
+               end
+            end
+            if loc.edge ~= nextto or (loc.roomno ~= 0) ~= nextto then
+               error("Flood fill got wall at (" .. x .. "," .. y .. ") wrong");
+            end
+         end
+      end
+   end
+
+   des.reset_level();
+   des.level_init();
+end
+
 function test_message()
    des.message("Test message");
    des.message("Message 2");
@@ -379,6 +483,8 @@ end
 
 function run_tests()
    test_level_init();
+   test_mines_cave();
+   test_flood_fill();
    test_message();
    test_monster();
    test_object();
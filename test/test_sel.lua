@@ -81,5 +81,60 @@ function test_selection()
    local sel3 = sel2:clone();
 end -- selection_tests()
 
+local function sel_check(sel, x, y, want, what)
+   local got = sel:get(x, y);
+   if got ~= want then
+      error(what .. " at (" .. x .. "," .. y .. ") is " .. got
+            .. " instead of " .. want);
+   end
+end
+
+-- results of set operations and growing
+function test_selection_ops()
+   local a = selection.new();
+   local b = selection.new();
+
+   a:set(5, 5);
+   a:set(6, 5);
+   b:set(6, 5);
+   b:set(7, 5);
+
+   local u = a:clone() | b;
+   local i = a:clone() & b;
+   local x = a:clone() ~ b;
+   sel_check(u, 5, 5, 1, "union");
+   sel_check(u, 7, 5, 1, "union");
+   sel_check(u, 8, 5, 0, "union");
+   sel_check(i, 5, 5, 0, "intersection");
+   sel_check(i, 6, 5, 1, "intersection");
+   sel_check(x, 5, 5, 1, "xor");
+   sel_check(x, 6, 5, 0, "xor");
+   sel_check(x, 7, 5, 1, "xor");
+
+   local n = selection.new():negate();
+   sel_check(n, 1, 1, 1, "negate");
+   n:set(1, 1, 0);
+   sel_check(n, 1, 1, 0, "negate then clear");
+   sel_check(n, 1, 2, 1, "negate then clear");
+
+   local g = selection.new();
+   g:set(10, 10);
+   g:grow();
+   for gx = 9, 11 do
+      for gy = 9, 11 do
+         sel_check(g, gx, gy, 1, "grow");
+      end
+   end
+   sel_check(g, 12, 10, 0, "grow");
+   sel_check(g, 10, 8, 0, "grow");
+
+   local h = selection.new();
+   h:set(10, 10);
+   h:grow("north");
+   sel_check(h, 10, 9, 1, "grow north");
+   sel_check(h, 10, 11, 0, "grow north");
+   sel_check(h, 9, 10, 0, "grow north");
+end
 
 test_selection();
+test_selection_ops();
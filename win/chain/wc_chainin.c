@@ -509,6 +509,17 @@ chainin_can_suspend()
     return rv;
 }
 
+void
+chainin_print_glyph_run(window, x, y, count, glyphs, bkglyphs)
+winid window;
+xchar x, y;
+int count;
+const int *glyphs, *bkglyphs;
+{
+    (*cibase->nprocs->win_print_glyph_run)(cibase->ndata, window, x, y,
+                                           count, glyphs, bkglyphs);
+}
+
 struct window_procs chainin_procs = {
     "-chainin", 0, /* wincap */
     0,             /* wincap2 */
@@ -553,4 +564,5 @@ struct window_procs chainin_procs = {
     chainin_status_init, chainin_status_finish, chainin_status_enablefield,
     chainin_status_update,
     chainin_can_suspend,
+    chainin_print_glyph_run,
 };
@@ -643,6 +643,20 @@ void *vp;
     return rv;
 }
 
+void
+chainout_print_glyph_run(vp, window, x, y, count, glyphs, bkglyphs)
+void *vp;
+winid window;
+xchar x, y;
+int count;
+const int *glyphs, *bkglyphs;
+{
+    struct chainout_data *tdp = vp;
+
+    (*tdp->nprocs->win_print_glyph_run)(window, x, y, count, glyphs,
+                                        bkglyphs);
+}
+
 struct chain_procs chainout_procs = {
     "-chainout", 0, /* wincap */
     0,              /* wincap2 */
@@ -688,4 +702,5 @@ struct chain_procs chainout_procs = {
     chainout_status_init, chainout_status_finish, chainout_status_enablefield,
     chainout_status_update,
     chainout_can_suspend,
+    chainout_print_glyph_run,
 };
@@ -1123,6 +1123,25 @@ void *vp;
     return rv;
 }
 
+void
+trace_print_glyph_run(vp, window, x, y, count, glyphs, bkglyphs)
+void *vp;
+winid window;
+xchar x, y;
+int count;
+const int *glyphs, *bkglyphs;
+{
+    struct trace_data *tdp = vp;
+
+    fprintf(wc_tracelogf, "%sprint_glyph_run(%d, %d, %d, %d)\n", INDENT,
+            window, x, y, count);
+
+    PRE;
+    (*tdp->nprocs->win_print_glyph_run)(tdp->ndata, window, x, y, count,
+                                        glyphs, bkglyphs);
+    POST;
+}
+
 struct chain_procs trace_procs = {
     "+trace", 0, /* wincap */
     0,           /* wincap2 */
@@ -1165,4 +1184,5 @@ struct chain_procs trace_procs = {
     trace_status_init, trace_status_finish, trace_status_enablefield,
     trace_status_update,
     trace_can_suspend,
+    trace_print_glyph_run,
 };
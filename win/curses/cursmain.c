@@ -48,7 +48,7 @@ struct window_procs curses_procs = {
 #if defined(STATUS_HILITES)
      | WC2_HILITE_STATUS
 #endif
-     | WC2_FLUSH_STATUS | WC2_TERM_SIZE
+     | WC2_FLUSH_STATUS | WC2_BATCH_STATUS | WC2_GLYPH_RUN | WC2_TERM_SIZE
      | WC2_STATUSLINES | WC2_WINDOWBORDERS | WC2_PETATTR | WC2_GUICOLOR
      | WC2_SUPPRESS_HIST),
     {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},   /* color availability */
@@ -112,6 +112,7 @@ struct window_procs curses_procs = {
     genl_status_enablefield,
     curses_status_update,
     genl_can_suspend_yes,
+    curses_print_glyph_run,
 };
 
 /*
@@ -701,6 +702,20 @@ curses_print_glyph(winid wid, XCHAR_P x, XCHAR_P y, int glyph,
     curses_putch(wid, x, y, ch, color, attr);
 }
 
+/*
+print_glyph_run(window, x, y, count, glyphs, bkglyphs)
+                -- Print count glyphs along row y of the map, starting at x.
+                   Same as calling print_glyph() for each of them, without
+                   going back through the window procedures every time.
+*/
+void
+curses_print_glyph_run(winid wid, XCHAR_P x, XCHAR_P y, int count,
+                       const int *glyphs, const int *bkglyphs)
+{
+    for (; count > 0; --count, ++x)
+        curses_print_glyph(wid, x, y, *glyphs++, *bkglyphs++);
+}
+
 /*
 raw_print(str)  -- Print directly to a screen, or otherwise guarantee that
                    the user sees str.  raw_print() appends a newline to str.
@@ -95,6 +95,9 @@ curses_status_finish()
  *         a field index, but is a special trigger to tell the
  *         windowport that it should redisplay all its status fields,
  *         even if no changes have been presented to it.
+ *      -- fldindex could also be BL_BATCH (-4), with ptr pointing to
+ *         an array of 'chg' struct status_batch entries, each of which
+ *         is handled as if passed separately, followed by BL_FLUSH.
  *      -- ptr is usually a "char *", unless fldindex is BL_CONDITION.
  *         If fldindex is BL_CONDITION, then ptr is a long value with
  *         any or none of the following bits set (from botl.h):
@@ -138,14 +141,21 @@ static int changed_fields = 0;
 
 void
 curses_status_update(fldidx, ptr, chg, percent, color_and_attr, colormasks)
-int fldidx, chg UNUSED,
+int fldidx, chg,
     percent, color_and_attr;
 genericptr_t ptr;
 unsigned long *colormasks;
 {
     long *condptr = (long *) ptr;
     char *text = (char *) ptr;
+    struct status_batch *sb;
 
+    if (fldidx == BL_BATCH) {
+        for (sb = (struct status_batch *) ptr; chg > 0; --chg, ++sb)
+            curses_status_update(sb->fld, sb->ptr, sb->chg, sb->percent,
+                                 sb->color, colormasks);
+        fldidx = BL_FLUSH;
+    }
     if (fldidx != BL_FLUSH) {
         if (fldidx < 0 || fldidx >= MAXBLSTATS) {
             g.context.botlx = g.context.botl = FALSE; /* avoid another bot() */
@@ -0,0 +1,785 @@
+/* NetHack 3.7	winnull.c	$NHDT-Date$  $NHDT-Branch$:$NHDT-Revision$ */
+/* Copyright (c) NetHack Development Team 2020.                   */
+/* NetHack may be freely redistributed.  See license for details. */
+
+/*
+ * "null" window port:  no terminal, no display, no waiting.
+ *
+ * Keystrokes come from a queue filled by whatever program is driving
+ * the game (see sys/libnh/libnhmain.c).  When the queue runs dry the
+ * port calls null_input_wait() so that the driver can supply more, and
+ * hangs up if there isn't a driver or it has nothing more to give.
+ * Messages are kept in a ring for the driver to collect; the text of
+ * the prompt currently waiting for input is available too.  The map and
+ * the status fields aren't rendered at all since the driver can read
+ * them straight from the core (g.gbuf[][] and g.blstats[][]).
+ */
+
+#include "hack.h"
+
+#ifdef NULL_GRAPHICS
+#include "func_tab.h"
+#include "winnull.h"
+
+#define NULL_MAXWIN 20     /* same limit as tty */
+#define NULL_KEYQSZ 4096   /* queued keystrokes */
+#define NULL_MSGHIST 100   /* messages retained for the driver */
+#define NULL_PROMPTSZ 4096 /* text of a pending prompt or menu */
+
+struct null_menuitem {
+    anything identifier;
+    char *str;
+    long count;
+    unsigned itemflags;
+    boolean selected;
+    char selector, gselector;
+};
+
+struct null_win {
+    boolean inuse;
+    int type;
+    struct null_menuitem *items;
+    int nitems, maxitems;
+    char *prompt;
+};
+
+static void FDECL(null_init_nhwindows, (int *, char **));
+static void NDECL(null_player_selection);
+static void NDECL(null_askname);
+static void NDECL(null_void_ndecl);
+static void FDECL(null_void_fdecl_int, (int));
+static void FDECL(null_void_fdecl_winid, (winid));
+static void FDECL(null_void_fdecl_constchar_p, (const char *));
+static void FDECL(null_exit_nhwindows, (const char *));
+static winid FDECL(null_create_nhwindow, (int));
+static void FDECL(null_display_nhwindow, (winid, BOOLEAN_P));
+static void FDECL(null_destroy_nhwindow, (winid));
+static void FDECL(null_curs, (winid, int, int));
+static void FDECL(null_putstr, (winid, int, const char *));
+static void FDECL(null_display_file, (const char *, BOOLEAN_P));
+static void FDECL(null_start_menu, (winid));
+static void FDECL(null_add_menu, (winid, int, const ANY_P *, CHAR_P, CHAR_P,
+                                  int, const char *, unsigned int));
+static void FDECL(null_end_menu, (winid, const char *));
+static int FDECL(null_select_menu, (winid, int, MENU_ITEM_P **));
+#ifdef CLIPPING
+static void FDECL(null_cliparound, (int, int));
+#endif
+#ifdef POSITIONBAR
+static void FDECL(null_update_positionbar, (char *));
+#endif
+static void FDECL(null_print_glyph, (winid, XCHAR_P, XCHAR_P, int, int));
+static void FDECL(null_raw_print, (const char *));
+static int NDECL(null_nhgetch);
+static int FDECL(null_nh_poskey, (int *, int *, int *));
+static int NDECL(null_int_ndecl);
+static char FDECL(null_yn_function, (const char *, const char *, CHAR_P));
+static void FDECL(null_getlin, (const char *, char *));
+static int NDECL(null_get_ext_cmd);
+#ifdef CHANGE_COLOR
+static void FDECL(null_change_color, (int, long, int));
+#ifdef MAC
+static short FDECL(null_set_font_name, (winid, char *));
+#endif
+static char *NDECL(null_get_color_string);
+#endif
+static void FDECL(null_outrip, (winid, int, time_t));
+static void FDECL(null_status_update, (int, genericptr_t, int, int, int,
+                                       unsigned long *));
+static void FDECL(null_addmsg, (const char *));
+static void FDECL(null_setprompt, (const char *));
+static void FDECL(null_addprompt, (const char *));
+static void FDECL(null_free_items, (struct null_win *));
+
+struct window_procs null_procs = {
+    "null", 0L, WC2_FLUSH_STATUS,
+    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    null_init_nhwindows, null_player_selection, null_askname,
+    null_void_ndecl,                                  /* get_nh_event */
+    null_exit_nhwindows, null_void_fdecl_constchar_p, /* suspend_nhwindows */
+    null_void_ndecl,                                  /* resume_nhwindows */
+    null_create_nhwindow, null_void_fdecl_winid,      /* clear_nhwindow */
+    null_display_nhwindow, null_destroy_nhwindow, null_curs, null_putstr,
+    genl_putmixed, null_display_file, null_start_menu, null_add_menu,
+    null_end_menu, null_select_menu, genl_message_menu,
+    null_void_ndecl,                                  /* update_inventory */
+    null_void_ndecl,                                  /* mark_synch */
+    null_void_ndecl,                                  /* wait_synch */
+#ifdef CLIPPING
+    null_cliparound,
+#endif
+#ifdef POSITIONBAR
+    null_update_positionbar,
+#endif
+    null_print_glyph, null_raw_print,
+    null_raw_print,                                   /* raw_print_bold */
+    null_nhgetch, null_nh_poskey,
+    null_void_ndecl,                                  /* nhbell */
+    null_int_ndecl,                                   /* doprev_message */
+    null_yn_function, null_getlin, null_get_ext_cmd,
+    null_void_fdecl_int,                              /* number_pad */
+    null_void_ndecl,                                  /* delay_output */
+#ifdef CHANGE_COLOR
+    null_change_color,
+#ifdef MAC
+    null_void_fdecl_int,                              /* change_background */
+    null_set_font_name,
+#endif
+    null_get_color_string,
+#endif
+    null_void_ndecl,                                  /* start_screen */
+    null_void_ndecl,                                  /* end_screen */
+    null_outrip, genl_preference_update, genl_getmsghistory,
+    genl_putmsghistory,
+    null_void_ndecl,                                  /* status_init */
+    null_void_ndecl,                                  /* status_finish */
+    genl_status_enablefield, null_status_update,
+    genl_can_suspend_no,
+    genl_print_glyph_run,
+};
+
+int NDECL((*null_input_wait)) = 0;
+
+static struct null_win null_wins[NULL_MAXWIN];
+
+static char keyq[NULL_KEYQSZ];
+static int keyq_head = 0, keyq_len = 0;
+
+static char msgs[NULL_MSGHIST][BUFSZ];
+static long msgcount = 0L;
+
+static char promptbuf[NULL_PROMPTSZ];
+
+/* queue keystrokes for the game; whatever doesn't fit is dropped */
+void
+null_pushkeys(keys, n)
+const char *keys;
+int n;
+{
+    while (n-- > 0 && keyq_len < NULL_KEYQSZ) {
+        keyq[(keyq_head + keyq_len) % NULL_KEYQSZ] = *keys++;
+        keyq_len++;
+    }
+}
+
+int
+null_pendingkeys()
+{
+    return keyq_len;
+}
+
+/* number of messages issued so far; only the last NULL_MSGHIST of them
+   can still be fetched with null_getmsg() */
+long
+null_msgcount()
+{
+    return msgcount;
+}
+
+const char *
+null_getmsg(idx)
+long idx;
+{
+    if (idx < 0L || idx >= msgcount || idx < msgcount - NULL_MSGHIST)
+        return (const char *) 0;
+    return msgs[idx % NULL_MSGHIST];
+}
+
+/* text of the question, line prompt, or menu waiting for an answer;
+   empty when the game wants an ordinary command */
+const char *
+null_prompt()
+{
+    return promptbuf;
+}
+
+static void
+null_addmsg(str)
+const char *str;
+{
+    (void) strncpy(msgs[msgcount % NULL_MSGHIST], str, BUFSZ - 1);
+    msgs[msgcount % NULL_MSGHIST][BUFSZ - 1] = '\0';
+    msgcount++;
+}
+
+static void
+null_setprompt(str)
+const char *str;
+{
+    promptbuf[0] = '\0';
+    if (str)
+        null_addprompt(str);
+}
+
+static void
+null_addprompt(str)
+const char *str;
+{
+    size_t len = strlen(promptbuf);
+
+    if (len && len < sizeof promptbuf - 1)
+        promptbuf[len++] = '\n';
+    (void) strncpy(&promptbuf[len], str, sizeof promptbuf - 1 - len);
+    promptbuf[sizeof promptbuf - 1] = '\0';
+}
+
+static void
+null_init_nhwindows(argcp, argv)
+int *argcp UNUSED;
+char **argv UNUSED;
+{
+    keyq_head = keyq_len = 0;
+    msgcount = 0L;
+    promptbuf[0] = '\0';
+    iflags.window_inited = TRUE;
+}
+
+/* pick anything left unspecified at random, the same way that choosing
+   "random" for everything at the tty prompt would */
+static void
+null_player_selection()
+{
+    rigid_role_checks();
+    if (flags.initrole < 0)
+        flags.initrole = pick_role(flags.initrace, flags.initgend,
+                                   flags.initalign, PICK_RANDOM);
+    if (flags.initrole < 0)
+        flags.initrole = randrole(FALSE);
+    if (flags.initrace < 0 || !validrace(flags.initrole, flags.initrace))
+        flags.initrace = pick_race(flags.initrole, flags.initgend,
+                                   flags.initalign, PICK_RANDOM);
+    if (flags.initrace < 0)
+        flags.initrace = randrace(flags.initrole);
+    if (flags.initgend < 0
+        || !validgend(flags.initrole, flags.initrace, flags.initgend))
+        flags.initgend = pick_gend(flags.initrole, flags.initrace,
+                                   flags.initalign, PICK_RANDOM);
+    if (flags.initgend < 0)
+        flags.initgend = randgend(flags.initrole, flags.initrace);
+    if (flags.initalign < 0
+        || !validalign(flags.initrole, flags.initrace, flags.initalign))
+        flags.initalign = pick_align(flags.initrole, flags.initrace,
+                                     flags.initgend, PICK_RANDOM);
+    if (flags.initalign < 0)
+        flags.initalign = randalign(flags.initrole, flags.initrace);
+}
+
+/* there's nobody to ask; a name can be supplied via the name option */
+static void
+null_askname()
+{
+    if (!*g.plname)
+        (void) strncpy(g.plname, "Agent", sizeof g.plname - 1);
+}
+
+static void
+null_void_ndecl()
+{
+    return;
+}
+
+static void
+null_void_fdecl_int(arg)
+int arg UNUSED;
+{
+    return;
+}
+
+static void
+null_void_fdecl_winid(window)
+winid window UNUSED;
+{
+    return;
+}
+
+static void
+null_void_fdecl_constchar_p(string)
+const char *string UNUSED;
+{
+    return;
+}
+
+static int
+null_int_ndecl()
+{
+    return 0;
+}
+
+static void
+null_exit_nhwindows(str)
+const char *str;
+{
+    winid w;
+
+    for (w = 0; w < NULL_MAXWIN; w++)
+        if (null_wins[w].inuse)
+            null_destroy_nhwindow(w);
+    if (str && *str)
+        null_addmsg(str);
+    iflags.window_inited = FALSE;
+}
+
+static winid
+null_create_nhwindow(type)
+int type;
+{
+    winid w;
+
+    for (w = 0; w < NULL_MAXWIN; w++)
+        if (!null_wins[w].inuse)
+            break;
+    if (w == NULL_MAXWIN)
+        panic("No window slots!");
+    null_wins[w].inuse = TRUE;
+    null_wins[w].type = type;
+    null_wins[w].items = (struct null_menuitem *) 0;
+    null_wins[w].nitems = null_wins[w].maxitems = 0;
+    null_wins[w].prompt = (char *) 0;
+    return w;
+}
+
+static void
+null_display_nhwindow(window, blocking)
+winid window UNUSED;
+boolean blocking UNUSED;
+{
+    return;
+}
+
+static void
+null_free_items(nw)
+struct null_win *nw;
+{
+    int i;
+
+    for (i = 0; i < nw->nitems; i++)
+        free((genericptr_t) nw->items[i].str);
+    if (nw->items)
+        free((genericptr_t) nw->items);
+    nw->items = (struct null_menuitem *) 0;
+    nw->nitems = nw->maxitems = 0;
+    if (nw->prompt)
+        free((genericptr_t) nw->prompt), nw->prompt = (char *) 0;
+}
+
+static void
+null_destroy_nhwindow(window)
+winid window;
+{
+    if (window < 0 || window >= NULL_MAXWIN || !null_wins[window].inuse)
+        return;
+    null_free_items(&null_wins[window]);
+    null_wins[window].inuse = FALSE;
+}
+
+static void
+null_curs(window, x, y)
+winid window UNUSED;
+int x UNUSED, y UNUSED;
+{
+    return;
+}
+
+/* only the message window's output is kept */
+static void
+null_putstr(window, attr, str)
+winid window;
+int attr UNUSED;
+const char *str;
+{
+    if (window >= 0 && window < NULL_MAXWIN && null_wins[window].inuse
+        && null_wins[window].type == NHW_MESSAGE)
+        null_addmsg(str);
+}
+
+static void
+null_display_file(fname, complain)
+const char *fname UNUSED;
+boolean complain UNUSED;
+{
+    return;
+}
+
+static void
+null_start_menu(window)
+winid window;
+{
+    if (window < 0 || window >= NULL_MAXWIN || !null_wins[window].inuse)
+        return;
+    null_free_items(&null_wins[window]);
+}
+
+/*ARGSUSED*/
+static void
+null_add_menu(window, glyph, identifier, ch, gch, attr, str, itemflags)
+winid window;
+int glyph UNUSED;
+const anything *identifier;
+char ch, gch;
+int attr UNUSED;
+const char *str;
+unsigned int itemflags;
+{
+    struct null_win *nw;
+    struct null_menuitem *it;
+
+    if (window < 0 || window >= NULL_MAXWIN || !null_wins[window].inuse)
+        return;
+    nw = &null_wins[window];
+    if (nw->nitems == nw->maxitems) {
+        struct null_menuitem *olditems = nw->items;
+
+        nw->maxitems = nw->maxitems ? 2 * nw->maxitems : 32;
+        nw->items = (struct null_menuitem *) alloc((unsigned) nw->maxitems
+                                                   * sizeof *nw->items);
+        if (olditems) {
+            (void) memcpy((genericptr_t) nw->items, (genericptr_t) olditems,
+                          nw->nitems * sizeof *nw->items);
+            free((genericptr_t) olditems);
+        }
+    }
+    it = &nw->items[nw->nitems++];
+    it->identifier = *identifier;
+    it->str = strcpy((char *) alloc(strlen(str) + 1), str);
+    it->count = -1L;
+    it->itemflags = itemflags;
+    it->selected = (itemflags & MENU_ITEMFLAGS_SELECTED) != 0;
+    it->selector = ch;
+    it->gselector = gch;
+}
+
+/* give selectable items which lack an accelerator one of their own */
+static void
+null_end_menu(window, prompt)
+winid window;
+const char *prompt;
+{
+    struct null_win *nw;
+    struct null_menuitem *it;
+    char nextch = 'a';
+    int i;
+
+    if (window < 0 || window >= NULL_MAXWIN || !null_wins[window].inuse)
+        return;
+    nw = &null_wins[window];
+    if (prompt)
+        nw->prompt = strcpy((char *) alloc(strlen(prompt) + 1), prompt);
+    for (i = 0, it = nw->items; i < nw->nitems; i++, it++) {
+        if (!it->identifier.a_void || it->selector || !nextch)
+            continue;
+        it->selector = nextch;
+        nextch = (nextch == 'z') ? 'A' : (nextch == 'Z') ? '\0' : nextch + 1;
+    }
+}
+
+static int
+null_select_menu(window, how, menu_list)
+winid window;
+int how;
+menu_item **menu_list;
+{
+    struct null_win *nw;
+    struct null_menuitem *it;
+    char buf[BUFSZ];
+    long count = -1L;
+    boolean matched;
+    int c, i, n;
+
+    *menu_list = (menu_item *) 0;
+    if (window < 0 || window >= NULL_MAXWIN || !null_wins[window].inuse)
+        return -1;
+    nw = &null_wins[window];
+    if (how == PICK_NONE)
+        return 0;
+
+    null_setprompt(nw->prompt);
+    for (i = 0, it = nw->items; i < nw->nitems; i++, it++) {
+        if (it->identifier.a_void && it->selector)
+            Sprintf(buf, "%c %c %.*s", it->selector,
+                    it->selected ? '+' : '-', BUFSZ - 5, it->str);
+        else
+            Sprintf(buf, "%.*s", BUFSZ - 1, it->str);
+        null_addprompt(buf);
+    }
+
+    for (;;) {
+        c = null_nhgetch();
+        if (c == '\033') {
+            null_setprompt((char *) 0);
+            return -1;
+        }
+        if (c == '\n' || c == '\r' || c == ' ')
+            break;
+        matched = FALSE;
+        for (i = 0, it = nw->items; i < nw->nitems; i++, it++) {
+            if (!it->identifier.a_void)
+                continue;
+            if (it->selector == c
+                || (it->gselector == c && how == PICK_ANY)) {
+                if (how == PICK_ONE) {
+                    for (n = 0; n < nw->nitems; n++)
+                        nw->items[n].selected = FALSE;
+                    it->selected = TRUE;
+                } else {
+                    it->selected = (count > 0L) ? TRUE : !it->selected;
+                }
+                it->count = it->selected ? count : -1L;
+                matched = TRUE;
+                if (how == PICK_ONE)
+                    break;
+            }
+        }
+        if (matched) {
+            count = -1L;
+            if (how == PICK_ONE)
+                break;
+            continue;
+        }
+        if (digit(c)) {
+            count = (count < 0L ? 0L : 10L * count) + (long) (c - '0');
+            continue;
+        }
+        if (how != PICK_ANY)
+            continue;
+        switch (map_menu_cmd(c)) {
+        case MENU_SELECT_ALL:
+        case MENU_UNSELECT_ALL:
+        case MENU_INVERT_ALL:
+            for (i = 0, it = nw->items; i < nw->nitems; i++, it++) {
+                if (!it->identifier.a_void)
+                    continue;
+                it->selected = (map_menu_cmd(c) == MENU_SELECT_ALL) ? TRUE
+                               : (map_menu_cmd(c) == MENU_UNSELECT_ALL)
+                                   ? FALSE
+                                   : !it->selected;
+                it->count = -1L;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    null_setprompt((char *) 0);
+
+    for (n = 0, i = 0; i < nw->nitems; i++)
+        if (nw->items[i].selected && nw->items[i].identifier.a_void)
+            n++;
+    if (n > 0) {
+        menu_item *mi = (menu_item *) alloc((unsigned) n * sizeof *mi);
+
+        *menu_list = mi;
+        for (i = 0, it = nw->items; i < nw->nitems; i++, it++) {
+            if (!it->selected || !it->identifier.a_void)
+                continue;
+            mi->item = it->identifier;
+            mi->count = it->count;
+            mi->itemflags = it->itemflags;
+            mi++;
+        }
+    }
+    return n;
+}
+
+#ifdef CLIPPING
+static void
+null_cliparound(x, y)
+int x UNUSED, y UNUSED;
+{
+    return;
+}
+#endif
+
+#ifdef POSITIONBAR
+static void
+null_update_positionbar(posbar)
+char *posbar UNUSED;
+{
+    return;
+}
+#endif
+
+static void
+null_print_glyph(window, x, y, glyph, bkglyph)
+winid window UNUSED;
+xchar x UNUSED, y UNUSED;
+int glyph UNUSED, bkglyph UNUSED;
+{
+    return;
+}
+
+static void
+null_raw_print(str)
+const char *str;
+{
+    null_addmsg(str);
+}
+
+/* next queued keystroke; if there are none and the driver can't supply
+   any, hang up--the game is saved unless it was built otherwise */
+static int
+null_nhgetch()
+{
+    int c;
+
+    if (!keyq_len && null_input_wait)
+        (void) (*null_input_wait)();
+    if (!keyq_len) {
+#ifdef HANGUPHANDLING
+        hangup(0);
+#else
+        end_of_input();
+#endif
+        return '\033';
+    }
+    c = (uchar) keyq[keyq_head];
+    keyq_head = (keyq_head + 1) % NULL_KEYQSZ;
+    keyq_len--;
+    return c;
+}
+
+static int
+null_nh_poskey(x, y, mod)
+int *x UNUSED, *y UNUSED, *mod UNUSED;
+{
+    return null_nhgetch();
+}
+
+static char
+null_yn_function(query, resp, def)
+const char *query, *resp;
+char def;
+{
+    char q, buf[BUFSZ];
+
+    if (resp) {
+        char choices[QBUFSZ], *p;
+
+        (void) strncpy(choices, resp, sizeof choices - 1);
+        choices[sizeof choices - 1] = '\0';
+        if ((p = index(choices, '\033')) != 0)
+            *p = '\0'; /* hide anything after ESC */
+        if (def)
+            Sprintf(buf, "%.*s [%s] (%c)", BUFSZ - QBUFSZ - 8, query,
+                    choices, def);
+        else
+            Sprintf(buf, "%.*s [%s]", BUFSZ - QBUFSZ - 4, query, choices);
+    } else {
+        Sprintf(buf, "%.*s", BUFSZ - 1, query);
+    }
+    null_setprompt(buf);
+
+    for (;;) {
+        q = (char) null_nhgetch();
+        if (!resp)
+            break;
+        q = lowc(q);
+        if (q == '\033') {
+            q = index(resp, 'q') ? 'q' : index(resp, 'n') ? 'n' : def;
+            break;
+        }
+        if (index(quitchars, q)) {
+            q = def;
+            break;
+        }
+        if (index(resp, q))
+            break;
+    }
+    null_setprompt((char *) 0);
+    return q;
+}
+
+/* read a line of text; ESC cancels, yielding "\033" like tty */
+static void
+null_getlin(query, bufp)
+const char *query;
+char *bufp;
+{
+    char *p = bufp;
+    int c;
+
+    null_setprompt(query);
+    for (;;) {
+        c = null_nhgetch();
+        if (c == '\033') {
+            Strcpy(bufp, "\033");
+            break;
+        }
+        if (c == '\n' || c == '\r') {
+            *p = '\0';
+            break;
+        }
+        if (c == '\b' || c == '\177') {
+            if (p > bufp)
+                p--;
+        } else if (p < bufp + BUFSZ - 1) {
+            *p++ = (char) c;
+        }
+    }
+    null_setprompt((char *) 0);
+}
+
+static int
+null_get_ext_cmd()
+{
+    char buf[BUFSZ];
+    int i;
+
+    null_getlin("#", buf);
+    (void) mungspaces(buf);
+    if (buf[0] == '\0' || buf[0] == '\033')
+        return -1;
+    for (i = 0; extcmdlist[i].ef_txt; i++)
+        if (!strcmpi(buf, extcmdlist[i].ef_txt))
+            return i;
+    pline("%s: unknown extended command.", buf);
+    return -1;
+}
+
+#ifdef CHANGE_COLOR
+static void
+null_change_color(color, rgb, reverse)
+int color UNUSED, reverse UNUSED;
+long rgb UNUSED;
+{
+    return;
+}
+
+#ifdef MAC
+static short
+null_set_font_name(window, fontname)
+winid window UNUSED;
+char *fontname UNUSED;
+{
+    return 0;
+}
+#endif
+
+static char *
+null_get_color_string()
+{
+    return (char *) "";
+}
+#endif /* CHANGE_COLOR */
+
+static void
+null_outrip(tmpwin, how, when)
+winid tmpwin UNUSED;
+int how UNUSED;
+time_t when UNUSED;
+{
+    return;
+}
+
+/* the core keeps the values in g.blstats[][] whether or not we look */
+static void
+null_status_update(idx, ptr, chg, percent, color, colormasks)
+int idx UNUSED, chg UNUSED, percent UNUSED, color UNUSED;
+genericptr_t ptr UNUSED;
+unsigned long *colormasks UNUSED;
+{
+    return;
+}
+
+#endif /* NULL_GRAPHICS */
+
+/*winnull.c*/
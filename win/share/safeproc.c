@@ -98,6 +98,7 @@ struct window_procs safe_procs = {
     safe_status_finish, safe_status_enablefield,
     safe_status_update,
     safe_can_suspend,
+    safe_print_glyph_run,
 };
 
 struct window_procs *
@@ -385,6 +386,16 @@ safe_can_suspend()
     return FALSE;
 }
 
+void
+safe_print_glyph_run(window, x, y, count, glyphs, bkglyphs)
+winid window;
+xchar x, y;
+int count;
+const int *glyphs, *bkglyphs;
+{
+    return;
+}
+
 void
 safe_nhbell()
 {
@@ -533,10 +533,11 @@ int x, y;
         }
     }
     if ((int) ttyDisplay->curx < x) { /* Go to the right. */
-        if (!nh_ND) {
+        if (tty_screen_advance(x)) {
+            ; /* re-sent what is there already */
+        } else if (!nh_ND) {
             cmov(x, y);
         } else { /* bah */
-             /* should instead print what is there already */
             while ((int) ttyDisplay->curx < x) {
                 xputs(nh_ND);
                 ttyDisplay->curx++;
@@ -559,6 +560,17 @@ register int x, y;
     ttyDisplay->curx = x;
 }
 
+/* length of the longest cursor addressing sequence; moving the cursor
+   fewer columns than this to the right is cheaper done by re-sending
+   what the screen already shows in between */
+int
+cmov_len()
+{
+    if (!nh_CM)
+        return CO;
+    return (int) strlen(tgoto(nh_CM, CO - 1, LI - 1));
+}
+
 /* See note above.  xputc() is a special function for overlays. */
 int
 xputc(c)
@@ -596,6 +608,9 @@ const char *s;
 void
 cl_end()
 {
+    if (ttyDisplay)
+        tty_screen_erase((int) ttyDisplay->curx, (int) ttyDisplay->cury,
+                         FALSE);
     if (CE) {
         xputs(CE);
     } else { /* no-CE fix - free after Harold Rynes */
@@ -620,6 +635,7 @@ clear_screen()
      */
     if (CL) {
         xputs(CL);
+        tty_screen_erase(0, 0, TRUE);
         home();
     }
 }
@@ -785,6 +801,7 @@ tty_delay_output()
 void
 cl_eos() /* free after Robert Viduya */
 {
+    tty_screen_erase((int) ttyDisplay->curx, (int) ttyDisplay->cury, TRUE);
     if (nh_CD) {
         xputs(nh_CD);
     } else {
@@ -332,6 +332,8 @@ char c;
     cw->curx = ttyDisplay->curx;
     if (cw->curx == 0)
         cl_end();
+    if (ttyDisplay->cury > 0) /* a long message has spilled onto the map */
+        tty_screen_forget((int) ttyDisplay->cury, (int) ttyDisplay->cury);
 #ifndef WIN32CON
     (void) putchar(c);
 #endif
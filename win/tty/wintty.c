@@ -89,9 +89,9 @@ struct window_procs tty_procs = {
 #endif
 #if defined(STATUS_HILITES)
      | WC2_HILITE_STATUS | WC2_HITPOINTBAR | WC2_FLUSH_STATUS
-     | WC2_RESET_STATUS
+     | WC2_RESET_STATUS | WC2_BATCH_STATUS
 #endif
-     | WC2_DARKGRAY | WC2_SUPPRESS_HIST | WC2_STATUSLINES),
+     | WC2_DARKGRAY | WC2_SUPPRESS_HIST | WC2_STATUSLINES | WC2_GLYPH_RUN),
 #ifdef TEXTCOLOR
     {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},   /* color availability */
 #else
@@ -133,6 +133,7 @@ struct window_procs tty_procs = {
     genl_status_update,
 #endif
     genl_can_suspend_yes,
+    tty_print_glyph_run,
 };
 
 winid BASE_WINDOW;
@@ -169,6 +170,28 @@ boolean GFlag = FALSE;
 boolean HE_resets_AS; /* see termcap.c */
 #endif
 
+#ifndef NO_TERMS
+/* what the terminal is showing; see tty_screen_alloc() */
+struct tty_cell {
+    char ch;     /* 0: unknown */
+    schar color;
+    uchar attr;  /* TCELL_INVERSE */
+};
+#define TCELL_INVERSE 1
+
+static struct tty_cell *tty_screen = (struct tty_cell *) 0;
+static int tty_screen_rows = 0, tty_screen_cols = 0;
+static int tty_screen_hop = 0; /* from cmov_len() */
+
+#define tty_cell_at(x, y) (&tty_screen[(y) * tty_screen_cols + (x)])
+#ifdef TTY_TILES_ESCCODES
+/* tile clients need every glyph's escape codes */
+#define tty_screen_on() (tty_screen && !iflags.vt_tiledata)
+#else
+#define tty_screen_on() (tty_screen != 0)
+#endif
+#endif /* !NO_TERMS */
+
 #if defined(MICRO) || defined(WIN32CON)
 static const char to_continue[] = "to continue";
 #define getret() getreturn(to_continue)
@@ -196,6 +219,12 @@ static void FDECL(process_text_window, (winid, struct WinDesc *));
 static tty_menu_item *FDECL(reverse, (tty_menu_item *));
 static const char *FDECL(compress_str, (const char *));
 static void FDECL(tty_putsym, (winid, int, int, CHAR_P));
+static void FDECL(tty_putglyph, (winid, XCHAR_P, XCHAR_P, int));
+#ifndef NO_TERMS
+static void NDECL(tty_screen_alloc);
+static void NDECL(tty_screen_free);
+static boolean FDECL(tty_screen_maprow, (int));
+#endif
 static void FDECL(setup_rolemenu, (winid, BOOLEAN_P, int, int, int));
 static void FDECL(setup_racemenu, (winid, BOOLEAN_P, int, int, int));
 static void FDECL(setup_gendmenu, (winid, BOOLEAN_P, int, int, int));
@@ -311,6 +340,9 @@ int sig_unused UNUSED;
     if ((oldLI != LI || oldCO != CO) && ttyDisplay) {
         ttyDisplay->rows = LI;
         ttyDisplay->cols = CO;
+#ifndef NO_TERMS
+        tty_screen_alloc();
+#endif
 
         cw = wins[BASE_WINDOW];
         cw->rows = ttyDisplay->rows;
@@ -359,6 +391,8 @@ new_status_window()
 
         tty_destroy_nhwindow(WIN_STATUS), WIN_STATUS = WIN_ERR;
     }
+    /* the map and status might not occupy the same rows as before */
+    tty_screen_forget(0, (int) ttyDisplay->rows - 1);
     /* frees some status tracking data */
     genl_status_finish();
     /* creates status window and allocates tracking data */
@@ -421,6 +455,9 @@ char **argv UNUSED;
     ttyDisplay->color = NO_COLOR;
 #endif
     ttyDisplay->attrs = 0;
+#ifndef NO_TERMS
+    tty_screen_alloc();
+#endif
 
     /* set up the default windows */
     BASE_WINDOW = tty_create_nhwindow(NHW_BASE);
@@ -1420,6 +1457,7 @@ const char *str;
 #endif
 
 #ifndef NO_TERMS    /*(until this gets added to the window interface)*/
+    tty_screen_free();
     tty_shutdown(); /* cleanup termcap/terminfo/whatever */
 #endif
 #ifdef WIN32
@@ -2374,6 +2412,9 @@ boolean blocking; /* with ttys, all windows are blocking */
             cw->offy = 0;
         if (ttyDisplay->toplin == 1)
             tty_display_nhwindow(WIN_MESSAGE, TRUE);
+        /* it's erased through cl_end() et al, but until then the map
+           rows underneath hold whatever the window drew there */
+        tty_screen_forget(0, (int) ttyDisplay->rows - 1);
 #ifdef H2344_BROKEN
         if (cw->maxrow >= (int) ttyDisplay->rows
             || !iflags.menu_overlay)
@@ -2540,6 +2581,15 @@ register int x, y; /* not xchar: perhaps xchar is unsigned and
     if (y == cy && x == cx)
         return;
 
+#ifndef NO_TERMS
+    /* a short hop to the right past map glyphs which were already on
+       screen is cheaper done by re-sending what's there; other windows
+       write text which the model doesn't follow */
+    if (cw->type == NHW_MAP && y == cy && x > cx && x - cx < tty_screen_hop
+        && tty_screen_advance(x))
+        return;
+#endif
+
     if (cw->type == NHW_MAP)
         end_glyphout();
 
@@ -2592,6 +2642,7 @@ char ch;
     case NHW_MAP:
     case NHW_BASE:
         tty_curs(window, x, y);
+        tty_screen_forget((int) ttyDisplay->cury, (int) ttyDisplay->cury);
         (void) putchar(ch);
         ttyDisplay->curx++;
         cw->curx++;
@@ -2727,6 +2778,7 @@ const char *str;
 #endif /* STATUS_HILITES */
     case NHW_MAP:
         tty_curs(window, cw->curx + 1, cw->cury);
+        tty_screen_forget((int) ttyDisplay->cury, (int) ttyDisplay->cury);
         term_start_attr(attr);
         while (*str && (int) ttyDisplay->curx < (int) ttyDisplay->cols - 1) {
             (void) putchar(*str);
@@ -2739,12 +2791,15 @@ const char *str;
         break;
     case NHW_BASE:
         tty_curs(window, cw->curx + 1, cw->cury);
+        tty_screen_forget((int) ttyDisplay->cury, (int) ttyDisplay->cury);
         term_start_attr(attr);
         while (*str) {
             if ((int) ttyDisplay->curx >= (int) ttyDisplay->cols - 1) {
                 cw->curx = 0;
                 cw->cury++;
                 tty_curs(window, cw->curx + 1, cw->cury);
+                tty_screen_forget((int) ttyDisplay->cury,
+                                  (int) ttyDisplay->cury);
             }
             (void) putchar(*str);
             str++;
@@ -3335,6 +3390,138 @@ int in_ch;
 }
 #endif /* !WIN32 */
 
+#ifndef NO_TERMS
+/*
+ * Model of what the terminal is showing, in screen coordinates.  Map
+ * glyphs are recorded as they're sent, so that sending one which is
+ * already there can be skipped and a short hop of the cursor to the
+ * right can be made by re-sending the cells in between instead of a
+ * cursor motion sequence.  Erasing through cl_end(), cl_eos() and
+ * clear_screen() makes cells in the map's rows blank; any other output
+ * which might land there has to make them unknown via tty_screen_forget().
+ * The message and status rows are written with plain text output that
+ * isn't tracked, so their cells are never known.
+ */
+
+/* (re)allocate the model to match the terminal size; all cells unknown */
+static void
+tty_screen_alloc()
+{
+    tty_screen_free();
+    tty_screen_rows = ttyDisplay->rows;
+    tty_screen_cols = ttyDisplay->cols;
+    if (tty_screen_rows > 0 && tty_screen_cols > 0) {
+        tty_screen = (struct tty_cell *) alloc((unsigned) tty_screen_rows
+                                               * (unsigned) tty_screen_cols
+                                               * sizeof (struct tty_cell));
+        tty_screen_forget(0, tty_screen_rows - 1);
+    }
+    tty_screen_hop = cmov_len();
+}
+
+static void
+tty_screen_free()
+{
+    if (tty_screen)
+        free((genericptr_t) tty_screen), tty_screen = (struct tty_cell *) 0;
+    tty_screen_rows = tty_screen_cols = 0;
+}
+
+/* is screen row 'y' one that the map window is drawn on? */
+static boolean
+tty_screen_maprow(y)
+int y;
+{
+    struct WinDesc *cw;
+
+    if (WIN_MAP == WIN_ERR || (cw = wins[WIN_MAP]) == 0)
+        return FALSE;
+    return (y >= cw->offy && y < cw->offy + cw->rows);
+}
+
+/* the terminal has erased from <x,y> to the end of that row, or to the
+   end of the screen if 'toend' is set */
+void
+tty_screen_erase(x, y, toend)
+int x, y;
+boolean toend;
+{
+    struct tty_cell *cell;
+    int lasty;
+
+    if (!tty_screen || x < 0 || y < 0 || y >= tty_screen_rows)
+        return;
+    if (x > tty_screen_cols)
+        x = tty_screen_cols;
+    lasty = toend ? tty_screen_rows - 1 : y;
+    for (; y <= lasty; ++y, x = 0) {
+        if (!tty_screen_maprow(y)) {
+            tty_screen_forget(y, y);
+            continue;
+        }
+        for (cell = tty_cell_at(x, y); x < tty_screen_cols; ++x, ++cell) {
+            cell->ch = ' ';
+            cell->color = NO_COLOR;
+            cell->attr = 0;
+        }
+    }
+}
+
+/* rows 'first' through 'last' may have been written by something other
+   than tty_putglyph() */
+void
+tty_screen_forget(first, last)
+int first, last;
+{
+    struct tty_cell *cell, *end;
+
+    if (!tty_screen)
+        return;
+    if (first < 0)
+        first = 0;
+    if (last >= tty_screen_rows)
+        last = tty_screen_rows - 1;
+    if (first > last)
+        return;
+    end = tty_cell_at(0, last + 1);
+    for (cell = tty_cell_at(0, first); cell < end; ++cell)
+        cell->ch = '\0';
+}
+
+/* move the cursor right to column 'x' of its current row by re-sending
+   what's there; only possible within the map's rows and if that's all
+   known, plain characters in the current color */
+boolean
+tty_screen_advance(x)
+int x;
+{
+    struct tty_cell *cell;
+    int cx = ttyDisplay->curx, cy = ttyDisplay->cury;
+
+    if (!tty_screen_on() || cy < 0 || cy >= tty_screen_rows || cx < 0
+        || cx >= x || x >= tty_screen_cols || !tty_screen_maprow(cy))
+        return FALSE;
+#ifdef ASCIIGRAPH
+    if (GFlag)
+        return FALSE;
+#endif
+    for (cell = tty_cell_at(cx, cy); cx < x; ++cx, ++cell)
+        if (!cell->ch || (cell->ch & 0x80) != 0 || cell->attr
+            || (ul_hack && cell->ch == '_')
+#ifdef TEXTCOLOR
+            || cell->color != ttyDisplay->color
+#endif
+            )
+            return FALSE;
+
+    for (cx = ttyDisplay->curx, cell = tty_cell_at(cx, cy); cx < x;
+         ++cx, ++cell)
+        (void) putchar(cell->ch);
+    ttyDisplay->curx = x;
+    return TRUE;
+}
+#endif /* !NO_TERMS */
+
 #ifdef CLIPPING
 void
 setclipped()
@@ -3390,11 +3577,6 @@ xchar x, y;
 int glyph;
 int bkglyph UNUSED;
 {
-    int ch;
-    boolean inverse_on = FALSE;
-    int color;
-    unsigned special;
-
     HUPSKIP();
 #ifdef CLIPPING
     if (clipping) {
@@ -3402,14 +3584,86 @@ int bkglyph UNUSED;
             return;
     }
 #endif
-    /* map glyph to character and color */
-    (void) mapglyph(glyph, &ch, &color, &special, x, y, 0);
-
     print_vt_code2(AVTC_SELECT_WINDOW, window);
 
     /* Move the cursor. */
     tty_curs(window, x, y);
 
+    tty_putglyph(window, x, y, glyph);
+}
+
+/* print a span of glyphs from one row of the map; the cursor only has
+   to be moved to its start and past any glyphs already on screen */
+void
+tty_print_glyph_run(window, x, y, count, glyphs, bkglyphs)
+winid window;
+xchar x, y;
+int count;
+const int *glyphs;
+const int *bkglyphs UNUSED;
+{
+    HUPSKIP();
+#ifdef CLIPPING
+    if (clipping) {
+        if (y < clipy || y >= clipymax)
+            return;
+        if (x <= clipx) {
+            count -= clipx + 1 - x;
+            glyphs += clipx + 1 - x;
+            x = clipx + 1;
+        }
+        if (x + count > clipxmax)
+            count = clipxmax - x;
+    }
+#endif
+    if (count <= 0)
+        return;
+    print_vt_code2(AVTC_SELECT_WINDOW, window);
+    for (; count > 0; --count, ++x) {
+        tty_curs(window, x, y); /* no-op unless the last one was skipped */
+        tty_putglyph(window, x, y, *glyphs++);
+    }
+}
+
+/* output one glyph at the cursor, which is already at <x,y>; if the
+   screen is known to show it there already, the cursor is left behind */
+static void
+tty_putglyph(window, x, y, glyph)
+winid window;
+xchar x, y;
+int glyph;
+{
+    int ch;
+    boolean inverse_on = FALSE, inverse;
+    int color;
+    unsigned special;
+#ifndef NO_TERMS
+    struct tty_cell *cell = (struct tty_cell *) 0;
+#endif
+
+    /* map glyph to character and color */
+    (void) mapglyph(glyph, &ch, &color, &special, x, y, 0);
+
+    /* BW_LAVA and BW_ICE won't ever be set when color is on;
+       (tried bold for ice but it didn't look very good; inverse is easier
+       to see although the Valkyrie quest ends up being hard on the eyes) */
+    inverse = (((special & MG_PET) != 0 && iflags.hilite_pet)
+               || ((special & MG_OBJPILE) != 0 && iflags.hilite_pile)
+               || ((special & (MG_DETECT | MG_BW_LAVA | MG_BW_ICE)) != 0
+                   && iflags.use_inverse));
+
+#ifndef NO_TERMS
+    if (tty_screen_on() && ttyDisplay->cury < tty_screen_rows
+        && ttyDisplay->curx < tty_screen_cols) {
+        cell = tty_cell_at(ttyDisplay->curx, ttyDisplay->cury);
+        if (cell->ch == (char) ch && cell->color == color
+            && cell->attr == (inverse ? TCELL_INVERSE : 0)) {
+            wins[window]->curx++; /* the real cursor didn't move */
+            return;
+        }
+    }
+#endif
+
     print_vt_code3(AVTC_GLYPH_START, glyph2tile[glyph], special);
 
 #ifndef NO_TERMS
@@ -3429,14 +3683,8 @@ int bkglyph UNUSED;
     }
 #endif /* TEXTCOLOR */
 
-    /* must be after color check; term_end_color may turn off inverse too;
-       BW_LAVA and BW_ICE won't ever be set when color is on;
-       (tried bold for ice but it didn't look very good; inverse is easier
-       to see although the Valkyrie quest ends up being hard on the eyes) */
-    if (((special & MG_PET) != 0 && iflags.hilite_pet)
-        || ((special & MG_OBJPILE) != 0 && iflags.hilite_pile)
-        || ((special & (MG_DETECT | MG_BW_LAVA | MG_BW_ICE)) != 0
-            && iflags.use_inverse)) {
+    /* must be after color check; term_end_color may turn off inverse too */
+    if (inverse) {
         term_start_attr(ATR_INVERSE);
         inverse_on = TRUE;
     }
@@ -3463,6 +3711,13 @@ int bkglyph UNUSED;
 
     print_vt_code1(AVTC_GLYPH_END);
 
+#ifndef NO_TERMS
+    if (cell) {
+        cell->ch = (char) ch;
+        cell->color = (schar) color;
+        cell->attr = inverse ? TCELL_INVERSE : 0;
+    }
+#endif
     wins[window]->curx++; /* one character over */
     ttyDisplay->curx++;   /* the real cursor moved too */
 }
@@ -3472,8 +3727,11 @@ tty_raw_print(str)
 const char *str;
 {
     HUPSKIP();
-    if (ttyDisplay)
+    if (ttyDisplay) {
         ttyDisplay->rawprint++;
+        /* it might scroll the screen */
+        tty_screen_forget(0, (int) ttyDisplay->rows - 1);
+    }
     print_vt_code2(AVTC_SELECT_WINDOW, NHW_BASE);
 #if defined(MICRO) || defined(WIN32CON)
     msmsg("%s\n", str);
@@ -3488,8 +3746,11 @@ tty_raw_print_bold(str)
 const char *str;
 {
     HUPSKIP();
-    if (ttyDisplay)
+    if (ttyDisplay) {
         ttyDisplay->rawprint++;
+        /* it might scroll the screen */
+        tty_screen_forget(0, (int) ttyDisplay->rows - 1);
+    }
     print_vt_code2(AVTC_SELECT_WINDOW, NHW_BASE);
     term_start_raw_bold();
 #if defined(MICRO) || defined(WIN32CON)
@@ -3813,6 +4074,10 @@ boolean enable;
  *         a field index, but is a special advisory to to tell the
  *         windowport that it should redisplay all its status fields,
  *         even if no changes have been presented to it.
+ *      -- fldindex could also be BL_BATCH (-4), with ptr pointing to
+ *         an array of 'chg' struct status_batch entries, each of which
+ *         is handled as if passed separately, followed by BL_FLUSH or,
+ *         if 'percent' is nonzero, BL_RESET.
  *      -- ptr is usually a "char *", unless fldindex is BL_CONDITION.
  *         If fldindex is BL_CONDITION, then ptr is a long value with
  *         any or none of the following bits set (from botl.h):
@@ -3871,7 +4136,7 @@ boolean enable;
 
 void
 tty_status_update(fldidx, ptr, chg, percent, color, colormasks)
-int fldidx, chg UNUSED, percent, color;
+int fldidx, chg, percent, color;
 genericptr_t ptr;
 unsigned long *colormasks;
 {
@@ -3881,14 +4146,30 @@ unsigned long *colormasks;
     char goldbuf[40], *lastchar, *p;
     const char *fmt;
     boolean reset_state = NO_RESET;
+    struct status_batch *sb;
 
-    if ((fldidx < BL_RESET) || (fldidx >= MAXBLSTATS))
+    if ((fldidx < BL_BATCH) || (fldidx >= MAXBLSTATS))
         return;
 
     if ((fldidx >= 0 && fldidx < MAXBLSTATS) && !status_activefields[fldidx])
         return;
 
     switch (fldidx) {
+    case BL_BATCH:
+        for (sb = (struct status_batch *) ptr; chg > 0; --chg, ++sb)
+            tty_status_update(sb->fld, sb->ptr, sb->chg, sb->percent,
+                              sb->color, colormasks);
+        if (percent)
+            reset_state = FORCE_RESET;
+        if (make_things_fit(reset_state) || truncation_expected) {
+            render_status();
+#if (NH_DEVEL_STATUS != NH_STATUS_RELEASED)
+            status_sanity_check();
+#endif
+        }
+        return;
+    case BL_CHARACTERISTICS:
+        return;
     case BL_RESET:
         reset_state = FORCE_RESET;
         /*FALLTHRU*/